@@ -81,6 +81,14 @@ if( FFTW_ROOT )
     NO_DEFAULT_PATH
   )
 
+  find_library(
+    FFTWF_OMP_LIB
+    NAMES "fftw3f_omp"
+    PATHS ${FFTW_ROOT}
+    PATH_SUFFIXES "lib" "lib64"
+    NO_DEFAULT_PATH
+  )
+
   find_library(
     FFTWL_LIB
     NAMES "fftw3l"
@@ -138,6 +146,12 @@ else()
     PATHS ${PKG_FFTW_LIBRARY_DIRS} ${LIB_INSTALL_DIR}
   )
 
+  find_library(
+    FFTWF_OMP_LIB
+    NAMES "fftw3f_omp"
+    PATHS ${PKG_FFTW_LIBRARY_DIRS} ${LIB_INSTALL_DIR}
+  )
+
   find_library(
     FFTWL_LIB
     NAMES "fftw3l"
@@ -170,4 +184,4 @@ include(FindPackageHandleStandardArgs)
 find_package_handle_standard_args(FFTW DEFAULT_MSG
                                   FFTW_INCLUDES FFTW_LIBRARIES)
 
-mark_as_advanced(FFTW_INCLUDES FFTW_LIBRARIES FFTW_LIB FFTWF_LIB FFTWL_LIB FFTW_OMP_LIB FFTW_THREADS_LIB FFTWF_THREADS_LIB FFTWL_THREADS_LIB)
+mark_as_advanced(FFTW_INCLUDES FFTW_LIBRARIES FFTW_LIB FFTWF_LIB FFTWL_LIB FFTW_OMP_LIB FFTW_THREADS_LIB FFTWF_OMP_LIB FFTWF_THREADS_LIB FFTWL_THREADS_LIB)
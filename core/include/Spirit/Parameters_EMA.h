@@ -37,6 +37,12 @@ PREFIX void Parameters_EMA_Set_Amplitude(State *state, float amplitude, int idx_
 // Set whether to displace the system statically instead of periodically.
 PREFIX void Parameters_EMA_Set_Snapshot(State *state, bool snapshot, int idx_image=-1, int idx_chain=-1) SUFFIX;
 
+// Set whether to use a sparse representation of the Hessian.
+PREFIX void Parameters_EMA_Set_Sparse(State *state, bool sparse, int idx_image=-1, int idx_chain=-1) SUFFIX;
+
+// Set whether to calculate Hessian-vector products on the fly instead of assembling the Hessian.
+PREFIX void Parameters_EMA_Set_Matrix_Free(State *state, bool matrix_free, int idx_image=-1, int idx_chain=-1) SUFFIX;
+
 /*
 Get
 --------------------------------------------------------------------
@@ -57,5 +63,11 @@ PREFIX float Parameters_EMA_Get_Amplitude(State *state, int idx_image=-1, int id
 // Returns whether to displace the system statically instead of periodically.
 PREFIX bool Parameters_EMA_Get_Snapshot(State *state, int idx_image=-1, int idx_chain=-1) SUFFIX;
 
+// Returns whether to use a sparse representation of the Hessian.
+PREFIX bool Parameters_EMA_Get_Sparse(State *state, int idx_image=-1, int idx_chain=-1) SUFFIX;
+
+// Returns whether to calculate Hessian-vector products on the fly instead of assembling the Hessian.
+PREFIX bool Parameters_EMA_Get_Matrix_Free(State *state, int idx_image=-1, int idx_chain=-1) SUFFIX;
+
 #include "DLL_Undefine_Export.h"
 #endif
\ No newline at end of file
@@ -81,6 +81,29 @@ PREFIX void Parameters_MC_Set_Metropolis_Cone(State *state, bool cone, float con
 // Set whether spins should be sampled randomly or in sequence.
 PREFIX void Parameters_MC_Set_Random_Sample(State *state, bool random_sample, int idx_image=-1, int idx_chain=-1) SUFFIX;
 
+/*
+Configure the update moves.
+
+- heat_bath: whether to sample the spins from the Boltzmann distribution in their local field
+  (otherwise: Metropolis sampling as configured by `Parameters_MC_Set_Metropolis_Cone`)
+- n_overrelaxation: number of energy-conserving over-relaxation sweeps after each heat bath or Metropolis sweep
+
+Both moves need short-ranged interactions, otherwise Metropolis sweeps without over-relaxation are used.
+*/
+PREFIX void Parameters_MC_Set_Update_Moves(State *state, bool heat_bath, int n_overrelaxation, int idx_image=-1, int idx_chain=-1) SUFFIX;
+
+// Set the number of iterations between replica exchanges in a parallel tempering calculation.
+PREFIX void Parameters_MC_Set_Replica_Exchange_Interval(State *state, int n_iterations, int idx_image=-1, int idx_chain=-1) SUFFIX;
+
+/*
+Set whether the spins should be updated in parallel.
+
+The lattice is coloured such that no two spins of the same colour interact and the spins of each colour
+are updated concurrently, with one random number stream per thread. Spins are then sampled in sequence.
+This requires short-ranged interactions, i.e. it is not possible with FFT or direct DDI.
+*/
+PREFIX void Parameters_MC_Set_Parallel_Sweep(State *state, bool parallel_sweep, int idx_image=-1, int idx_chain=-1) SUFFIX;
+
 /*
 Get Output
 --------------------------------------------------------------------
@@ -125,5 +148,19 @@ PREFIX void Parameters_MC_Get_Metropolis_Cone(State *state, bool * cone, float *
 // Returns whether spins should be sampled randomly or in sequence.
 PREFIX bool Parameters_MC_Get_Random_Sample(State *state, int idx_image=-1, int idx_chain=-1) SUFFIX;
 
+/*
+Returns the configuration of the update moves.
+
+- whether heat bath sampling is used (otherwise: Metropolis sampling)
+- the number of over-relaxation sweeps after each heat bath or Metropolis sweep
+*/
+PREFIX void Parameters_MC_Get_Update_Moves(State *state, bool * heat_bath, int * n_overrelaxation, int idx_image=-1, int idx_chain=-1) SUFFIX;
+
+// Returns the number of iterations between replica exchanges in a parallel tempering calculation.
+PREFIX int Parameters_MC_Get_Replica_Exchange_Interval(State *state, int idx_image=-1, int idx_chain=-1) SUFFIX;
+
+// Returns whether the spins should be updated in parallel.
+PREFIX bool Parameters_MC_Get_Parallel_Sweep(State *state, int idx_image=-1, int idx_chain=-1) SUFFIX;
+
 #include "DLL_Undefine_Export.h"
 #endif
\ No newline at end of file
@@ -71,6 +71,12 @@ PREFIX void Parameters_MMF_Set_N_Modes(State *state, int n_modes, int idx_image=
 // Set the index of the mode to follow.
 PREFIX void Parameters_MMF_Set_N_Mode_Follow(State *state, int n_mode_follow, int idx_image=-1, int idx_chain=-1) SUFFIX;
 
+// Set whether to use a sparse representation of the Hessian.
+PREFIX void Parameters_MMF_Set_Sparse(State *state, bool sparse, int idx_image=-1, int idx_chain=-1) SUFFIX;
+
+// Set whether to calculate Hessian-vector products on the fly instead of assembling the Hessian.
+PREFIX void Parameters_MMF_Set_Matrix_Free(State *state, bool matrix_free, int idx_image=-1, int idx_chain=-1) SUFFIX;
+
 /*
 Get Output
 --------------------------------------------------------------------
@@ -105,5 +111,11 @@ PREFIX int Parameters_MMF_Get_N_Modes(State *state, int idx_image=-1, int idx_ch
 // Returns the index of the mode which to follow.
 PREFIX int Parameters_MMF_Get_N_Mode_Follow(State *state, int idx_image=-1, int idx_chain=-1) SUFFIX;
 
+// Returns whether to use a sparse representation of the Hessian.
+PREFIX bool Parameters_MMF_Get_Sparse(State *state, int idx_image=-1, int idx_chain=-1) SUFFIX;
+
+// Returns whether to calculate Hessian-vector products on the fly instead of assembling the Hessian.
+PREFIX bool Parameters_MMF_Get_Matrix_Free(State *state, int idx_image=-1, int idx_chain=-1) SUFFIX;
+
 #include "DLL_Undefine_Export.h"
 #endif
\ No newline at end of file
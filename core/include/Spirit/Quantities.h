@@ -19,6 +19,9 @@ PREFIX void Quantity_Get_Magnetization(State * state, float m[3], int idx_image=
 // Topological Charge
 PREFIX float Quantity_Get_Topological_Charge(State * state, int idx_image=-1, int idx_chain=-1);
 
+// Topological Charge density of each spin, returns the total Topological Charge
+PREFIX float Quantity_Get_Topological_Charge_Density(State * state, float * charge_density, int idx_image=-1, int idx_chain=-1);
+
 // Minimum mode following information
 PREFIX void Quantity_Get_Grad_Force_MinimumMode(State * state, float * gradient, float * eval, float * mode, float * forces, int idx_image=-1, int idx_chain=-1);
 
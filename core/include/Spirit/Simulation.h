@@ -25,7 +25,8 @@ regular simulation, except that the iterations have to be triggered manually.
 Definition of solvers
 --------------------------------------------------------------------
 
-Note that the VP and NCG Solvers are only meant for direct minimization and not for dynamics.
+Note that the VP, NCG and LBFGS Solvers are only meant for direct minimization and not for dynamics,
+while the RK23 Solver, which adapts the time step, is only meant for LLG dynamics.
 */
 
 // `VP`: Verlet-like velocity projection
@@ -43,6 +44,15 @@ Note that the VP and NCG Solvers are only meant for direct minimization and not
 // `RK4`: Verlet-like velocity projection
 #define Solver_RungeKutta4 4
 
+// `NCG`: Nonlinear conjugate gradients
+#define Solver_NCG         5
+
+// `LBFGS`: Limited-memory Broyden-Fletcher-Goldfarb-Shanno
+#define Solver_LBFGS       6
+
+// `RK23`: Bogacki-Shampine 3(2) Runge-Kutta with adaptive time step
+#define Solver_RungeKutta23 7
+
 /*
 Start or stop a simulation
 --------------------------------------------------------------------
@@ -52,6 +62,16 @@ Start or stop a simulation
 PREFIX void Simulation_MC_Start(State *state, int n_iterations=-1, int n_iterations_log=-1,
     bool singleshot=false, int idx_image=-1, int idx_chain=-1) SUFFIX;
 
+/*
+Parallel tempering (replica exchange) Monte Carlo on all images of a chain.
+
+Each image is sampled at the temperature set in its own MC parameters and neighbouring
+images periodically exchange their configurations. The remaining parameters are taken
+from the MC parameters of the first image.
+*/
+PREFIX void Simulation_PT_Start(State *state, int n_iterations=-1, int n_iterations_log=-1,
+    bool singleshot=false, int idx_chain=-1) SUFFIX;
+
 // Landau-Lifshitz-Gilbert dynamics and energy minimisation
 PREFIX void Simulation_LLG_Start(State *state, int solver_type, int n_iterations=-1, int n_iterations_log=-1,
     bool singleshot=false, int idx_image=-1, int idx_chain=-1) SUFFIX;
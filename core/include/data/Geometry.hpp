@@ -6,6 +6,8 @@
 #include <engine/Vectormath_Defines.hpp>
 #include <Spirit/Geometry.h>
 
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace Data
@@ -90,6 +92,10 @@ namespace Data
         const std::vector<triangle_t>&    triangulation(int n_cell_step=1);
         // Retrieve tetrahedra, if 3D
         const std::vector<tetrahedron_t>& tetrahedra(int n_cell_step=1);
+        // Retrieve the spin indices of the triangles used for the topological charge, if 2D
+        //      The triangles are oriented counter-clockwise in the xy-plane and triangles which
+        //      would cross an open boundary are left out
+        std::shared_ptr<const std::vector<triangle_t>> spin_triangles(const intfield & boundary_conditions) const;
         // Introduce disorder into the atom types
         // void disorder(scalar mixing);
         static std::vector<Vector3> BravaisVectorsSC();
@@ -156,11 +162,30 @@ namespace Data
         void calculateUnitCellBounds();
         // Calculate and update the type lattice
         void calculateGeometryType();
+        // Calculate the triangulation of the basis cell, if 2D
+        void calculateCellTriangles();
+        // Translate the triangles of the basis cell to all cells, leaving out those crossing an open boundary
+        std::vector<triangle_t> calculateSpinTriangles(const intfield & boundary_conditions) const;
 
         //
         std::vector<triangle_t>    _triangulation;
         std::vector<tetrahedron_t> _tetrahedra;
-        
+        // Triangulation of the basis cell
+        std::vector<triangle_t>    _cell_triangles;
+        // The spin triangles for the boundary conditions they were last built for, which are
+        //      rebuilt under the mutex if other boundary conditions are requested
+        struct Spin_Triangles
+        {
+            Spin_Triangles() = default;
+            Spin_Triangles(const Spin_Triangles & other);
+            Spin_Triangles & operator=(const Spin_Triangles & other);
+
+            mutable std::mutex mutex;
+            intfield boundary_conditions;
+            std::shared_ptr<const std::vector<triangle_t>> triangles;
+        };
+        mutable Spin_Triangles     _spin_triangles;
+
         // Temporaries to tell wether the triangulation or tetrahedra
         // need to be updated when the corresponding function is called
         int last_update_n_cell_step;
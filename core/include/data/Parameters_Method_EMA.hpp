@@ -14,6 +14,10 @@ namespace Data
         scalar frequency = 0.02;
         scalar amplitude = 1;
         bool snapshot = false;
+        // Whether to use a sparse representation of the Hessian
+        bool sparse = false;
+        // Whether to calculate Hessian-vector products on the fly instead of assembling the Hessian
+        bool matrix_free = false;
 
         // ----------------- Output --------------
         // Energy output settings
@@ -7,6 +7,7 @@
 
 #include <vector>
 #include <random>
+#include <cstdint>
 
 namespace Data
 {
@@ -21,6 +22,8 @@ namespace Data
         int rng_seed = 2006;
         // Mersenne twister PRNG
         std::mt19937 prng = std::mt19937(rng_seed);
+        // Number of thermal fields drawn so far, which is the counter of the counter-based PRNG of the thermal field
+        std::uint64_t thermal_field_counter = 0;
 
         // Temperature [K]
         scalar temperature = 0;
@@ -39,6 +42,12 @@ namespace Data
         // Do direct minimization instead of dynamics
         bool direct_minimization = false;
 
+        // Adaptive time step of the RK23 solver, which starts with dt:
+        //      tolerance of the local error of the spin directions in one step and bounds of the time step [ps]
+        scalar dt_tolerance = 1e-7;
+        scalar dt_min = 1e-6;
+        scalar dt_max = 1;
+
         // ----------------- Output --------------
         // Energy output settings
         bool output_energy_step = false;
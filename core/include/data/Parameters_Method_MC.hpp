@@ -20,8 +20,15 @@ namespace Data
         // Mersenne twister PRNG
         std::mt19937 prng = std::mt19937(rng_seed);
 
+        // Whether to use heat bath sampling in the local field instead of Metropolis sampling
+        bool heat_bath = false;
+        // Number of over-relaxation sweeps after each Metropolis or heat bath sweep
+        int n_overrelaxation = 0;
+
         // Whether to sample spins randomly or in sequence in Metropolis algorithm
         bool metropolis_random_sample = true;
+        // Whether to colour the lattice and update non-interacting spins in parallel (spins are then sampled in sequence)
+        bool metropolis_parallel = false;
         // Whether to use the adaptive cone radius (otherwise just uses full sphere sampling)
         bool metropolis_step_cone = true;
         // Whether to adapt the metropolis cone angle throughout a MC run to try to hit a target acceptance ratio
@@ -32,6 +39,9 @@ namespace Data
         // Target acceptance ratio of mc steps for adaptive cone angle
         scalar acceptance_ratio_target = 0.5;
 
+        // Number of iterations between replica exchanges in parallel tempering
+        int replica_exchange_interval = 1;
+
         // ----------------- Output --------------
         // Energy output settings
         bool output_energy_step = false;
@@ -16,6 +16,10 @@ namespace Data
         int n_mode_follow = 0;
         // Number of lowest modes to calculate
         int n_modes = 10;
+        // Whether to use a sparse representation of the Hessian
+        bool sparse = false;
+        // Whether to calculate Hessian-vector products on the fly instead of assembling the Hessian
+        bool matrix_free = false;
 
         // ----------------- Output --------------
         // Energy output settings
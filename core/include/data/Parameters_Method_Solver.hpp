@@ -12,6 +12,11 @@ namespace Data
     {
         // Time step per iteration [ps]
         scalar dt = 1e-3;
+
+        // Number of previous steps used by the L-BFGS solver
+        int lbfgs_memory = 5;
+        // Maximum rotation angle of a spin in one L-BFGS step [rad]
+        scalar lbfgs_max_rotation = 0.2;
     };
 }
 #endif
\ No newline at end of file
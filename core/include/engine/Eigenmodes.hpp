@@ -23,15 +23,37 @@ namespace Engine
 
         // Calculate the full eigenspectrum of a Hessian (needs to be self-adjoint)
         // gradient and hessian should be the 3N-dimensional representations without constraints
+        // If pinning is enabled, the degrees of freedom of spins where mask_unpinned is zero are removed
         bool Hessian_Full_Spectrum(const std::shared_ptr<Data::Parameters_Method> parameters,
-            const vectorfield & spins, const vectorfield & gradient, const MatrixX & hessian,
+            const vectorfield & spins, const vectorfield & gradient, const intfield & mask_unpinned, const MatrixX & hessian,
             MatrixX & tangent_basis, MatrixX & hessian_constrained, VectorX & eigenvalues, MatrixX & eigenvectors);
 
         // Calculate a partial eigenspectrum of a Hessian
         // gradient and hessian should be the 3N-dimensional representations without constraints
+        // initial_modes may contain approximate eigenvectors in 3N representation, e.g. from a previous
+        // calculation, which are refined iteratively instead of starting the calculation from scratch
         bool Hessian_Partial_Spectrum(const std::shared_ptr<Data::Parameters_Method> parameters,
-            const vectorfield & spins, const vectorfield & gradient, const MatrixX & hessian, int n_modes,
-            MatrixX & tangent_basis, MatrixX & hessian_constrained, VectorX & eigenvalues, MatrixX & eigenvectors);
+            const vectorfield & spins, const vectorfield & gradient, const intfield & mask_unpinned, const MatrixX & hessian, int n_modes,
+            MatrixX & tangent_basis, MatrixX & hessian_constrained, VectorX & eigenvalues, MatrixX & eigenvectors,
+            const MatrixX & initial_modes = MatrixX());
+
+        // Calculate a partial eigenspectrum of a sparse Hessian
+        // gradient and hessian should be the 3N-dimensional representations without constraints
+        // No dense 3Nx3N or 2Nx2N matrices are allocated, making this usable for large systems
+        bool Hessian_Partial_Spectrum(const std::shared_ptr<Data::Parameters_Method> parameters,
+            const vectorfield & spins, const vectorfield & gradient, const intfield & mask_unpinned, const SpMatrixX & hessian, int n_modes,
+            SpMatrixX & tangent_basis, SpMatrixX & hessian_constrained, VectorX & eigenvalues, MatrixX & eigenvectors,
+            const MatrixX & initial_modes = MatrixX());
+
+        // Calculate a partial eigenspectrum of the Hessian without assembling any matrix
+        // gradient should be the 3N-dimensional representation without constraints
+        // The products of the constrained Hessian with vectors are calculated on the fly from the
+        // Hamiltonian's Hessian-vector products, so only a few vectorfield-sized buffers are needed
+        bool Hessian_Partial_Spectrum_Matrix_Free(const std::shared_ptr<Data::Parameters_Method> parameters,
+            const vectorfield & spins, const vectorfield & gradient, const intfield & mask_unpinned,
+            std::shared_ptr<Engine::Hamiltonian> hamiltonian, int n_modes,
+            SpMatrixX & tangent_basis, VectorX & eigenvalues, MatrixX & eigenvectors,
+            const MatrixX & initial_modes = MatrixX());
     };// end namespace Eigenmodes
 }// end namespace Engine
 #endif
\ No newline at end of file
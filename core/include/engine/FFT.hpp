@@ -6,6 +6,7 @@
 #include <engine/Vectormath_Defines.hpp>
 #include <iostream>
 #include <complex>
+#include <string>
 
 #ifdef SPIRIT_USE_OPENMP
 #include <omp.h>
@@ -68,6 +69,14 @@ namespace Engine
             #define FFTW_PLAN_MANY_DFT_R2C  fftw_plan_many_dft_r2c
             #define FFTW_PLAN_MANY_DFT_C2R  fftw_plan_many_dft_c2r
             #define FFTW_COMPLEX            fftw_complex
+            #define FFTW_EXECUTE_DFT_R2C    fftw_execute_dft_r2c
+            #define FFTW_EXECUTE_DFT_C2R    fftw_execute_dft_c2r
+            #define FFTW_ALIGNMENT_OF       fftw_alignment_of
+            #define FFTW_INIT_THREADS       fftw_init_threads
+            #define FFTW_PLAN_WITH_NTHREADS fftw_plan_with_nthreads
+            #define FFTW_IMPORT_WISDOM_FROM_FILENAME fftw_import_wisdom_from_filename
+            #define FFTW_EXPORT_WISDOM_TO_FILENAME   fftw_export_wisdom_to_filename
+            #define FFTW_PRECISION          "double"
         #endif
         #ifdef SPIRIT_SCALAR_TYPE_FLOAT
         // #if SPIRIT_SCALAR_TYPE == float
@@ -77,6 +86,14 @@ namespace Engine
             #define FFTW_PLAN_MANY_DFT_R2C  fftwf_plan_many_dft_r2c
             #define FFTW_PLAN_MANY_DFT_C2R  fftwf_plan_many_dft_c2r
             #define FFTW_COMPLEX            fftwf_complex
+            #define FFTW_EXECUTE_DFT_R2C    fftwf_execute_dft_r2c
+            #define FFTW_EXECUTE_DFT_C2R    fftwf_execute_dft_c2r
+            #define FFTW_ALIGNMENT_OF       fftwf_alignment_of
+            #define FFTW_INIT_THREADS       fftwf_init_threads
+            #define FFTW_PLAN_WITH_NTHREADS fftwf_plan_with_nthreads
+            #define FFTW_IMPORT_WISDOM_FROM_FILENAME fftwf_import_wisdom_from_filename
+            #define FFTW_EXPORT_WISDOM_TO_FILENAME   fftwf_export_wisdom_to_filename
+            #define FFTW_PRECISION          "float"
         #endif
 
         inline FFT_cpx_type mult3D(FFT_cpx_type & d1, FFT_cpx_type & d2, FFT_cpx_type & d3, FFT_cpx_type & s1, FFT_cpx_type & s2, FFT_cpx_type & s3)
@@ -131,10 +148,18 @@ namespace Engine
         inline void FFT_Init()
         {
             #if defined SPIRIT_USE_FFTW && defined SPIRIT_USE_OPENMP
-                fftw_init_threads();
-                fftw_plan_with_nthreads(omp_get_max_threads());
+                static bool threads_initialized = false;
+                if( !threads_initialized )
+                    threads_initialized = FFTW_INIT_THREADS() != 0;
+                FFTW_PLAN_WITH_NTHREADS(omp_get_max_threads());
             #endif
         }
+
+        // Set the file in which FFTW wisdom is kept between runs (an empty string disables it).
+        //      The precision is appended to the file name, i.e. the wisdom is stored in "<file>.double"
+        //      or "<file>.float". This has no effect on the other FFT backends.
+        void Set_Wisdom_File(const std::string & file);
+        std::string Get_Wisdom_File();
         
         inline void get_strides(field<int*> & strides, const field<int> & maxVal)
         {
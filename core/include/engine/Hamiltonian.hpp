@@ -39,6 +39,21 @@ namespace Engine
             This function uses finite differences and may thus be quite inefficient.
         */
         virtual void Hessian_FD(const vectorfield & spins, MatrixX & hessian) final;
+
+        /*
+            Calculate the Hessian matrix of a spin configuration in sparse format.
+            This function falls back to the dense Hessian and should be overridden for
+            Hamiltonians with short-ranged interactions, where most of the 3x3 blocks are zero.
+        */
+        virtual void Sparse_Hessian(const vectorfield & spins, SpMatrixX & hessian);
+
+        /*
+            Calculate the product of the Hessian matrix of a spin configuration with a vector,
+            without assembling the Hessian.
+            This function uses central finite differences of the gradient along the vector.
+            This function is the fallback for derived classes where it has not been overridden.
+        */
+        virtual void Hessian_Vector_Product(const vectorfield & spins, const vectorfield & vec, vectorfield & result);
         
         /*
             Calculate the energy gradient of a spin configuration.
@@ -54,6 +69,20 @@ namespace Engine
         */
         virtual void Gradient_FD(const vectorfield & spins, vectorfield & gradient) final;
 
+        /*
+            Calculate the energy gradients of several spin configurations, e.g. the images of a chain.
+            This function calls Gradient for each configuration in turn. It should be overridden where
+            evaluating all configurations in one pass makes better use of the available cores.
+        */
+        virtual void Gradient_Batch(const std::vector<const vectorfield*> & spins, std::vector<vectorfield*> & gradients);
+
+        /*
+            Check if this Hamiltonian gives the same energy and gradient as another one for any spin
+            configuration, so that one of them can evaluate a batch of configurations for both.
+            This function is the fallback for derived classes and only compares the addresses.
+        */
+        virtual bool Equivalent(const Hamiltonian & other);
+
         // Calculate the Energy contributions for the spins of a configuration
         virtual void Energy_Contributions_per_Spin(const vectorfield & spins, std::vector<std::pair<std::string, scalarfield>> & contributions);
 
@@ -65,6 +94,22 @@ namespace Engine
 
         // Calculate the total energy for a single spin
         virtual scalar Energy_Single_Spin(int ispin, const vectorfield & spins);
+
+        /*
+            Calculate the change of the total energy when spin ispin is changed from spin_old to spin_new,
+            while all other spins remain as in the given configuration.
+            The entry of ispin in spins is not used.
+            This function evaluates Energy_Single_Spin on a copy of the configuration and may thus be
+            quite inefficient. You should override it if you want to get proper performance, e.g. in Monte Carlo.
+        */
+        virtual scalar Energy_Single_Spin_Difference(int ispin, const Vector3 & spin_old, const Vector3 & spin_new, const vectorfield & spins);
+
+        /*
+            Collect for each spin the indices of the spins it interacts with, e.g. in order to colour
+            the lattice for a parallel Monte Carlo sweep. The lists are symmetric and do not contain the spin itself.
+            Returns false if the interactions are not short-ranged, in which case the lists are not filled.
+        */
+        virtual bool Interaction_Neighbours(field<intfield> & neighbours);
         
         // Hamiltonian name as string
         virtual const std::string& Name();
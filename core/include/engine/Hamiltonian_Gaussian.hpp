@@ -29,11 +29,16 @@ namespace Engine
 
         // General Hamiltonian functions
         void Hessian(const vectorfield & spins, MatrixX & hessian) override;
+        // The spins do not interact, so the Hessian only consists of the 3x3 blocks on the diagonal
+        void Sparse_Hessian(const vectorfield & spins, SpMatrixX & hessian) override;
+        void Hessian_Vector_Product(const vectorfield & spins, const vectorfield & vec, vectorfield & result) override;
         void Gradient(const vectorfield & spins, vectorfield & gradient) override;
         void Energy_Contributions_per_Spin(const vectorfield & spins, std::vector<std::pair<std::string, scalarfield>> & contributions) override;
 
         // Calculate the total energy for a single spin
         scalar Energy_Single_Spin(int ispin, const vectorfield & spins) override;
+        // Calculate the energy difference for a change of a single spin (the spins do not interact)
+        scalar Energy_Single_Spin_Difference(int ispin, const Vector3 & spin_old, const Vector3 & spin_new, const vectorfield & spins) override;
 
         // Hamiltonian name as string
         const std::string& Name() override;
@@ -43,6 +48,17 @@ namespace Engine
         std::vector<scalar> amplitude;
         std::vector<scalar> width;
         std::vector<Vector3> center;
+
+    private:
+        // Per-gaussian constants of the kernels, updated in Update_Energy_Contributions:
+        //      the components of the centers (stored separately for vectorization) and 1/sigma_i^2
+        std::vector<scalar> center_x, center_y, center_z;
+        std::vector<scalar> inverse_width_squared;
+
+        // Energy, gradient and Hessian block of a single spin
+        scalar  Energy_Spin(const Vector3 & spin);
+        Vector3 Gradient_Spin(const Vector3 & spin);
+        Matrix3 Hessian_Block(const Vector3 & spin);
     };
 }
 #endif
\ No newline at end of file
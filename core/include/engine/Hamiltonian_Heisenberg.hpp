@@ -22,6 +22,57 @@ namespace Engine
         None   = SPIRIT_DDI_METHOD_NONE
     };
 
+    /*
+        Compressed-sparse-row (CSR) table of the pair interactions of each spin.
+        The interaction partners of spin ispin are stored in the range [row_ptr[ispin], row_ptr[ispin+1]).
+        Each entry contains the index of the partner spin, the index of the pair in the list of
+        parameters and the orientation (+1 or -1) in which the pair is seen from ispin.
+        Both orientations of every pair are always stored, so a kernel can run over the spins
+        without having to write into its neighbours.
+        As a table depends only on the pairs, the geometry and the boundary conditions (stored in the
+        signature), it is shared by all Hamiltonians for which these agree, e.g. the images of a chain.
+    */
+    struct Pair_Table
+    {
+        intfield    signature;
+        intfield    row_ptr;
+        intfield    jspin;
+        intfield    ipair;
+        scalarfield orientation;
+    };
+
+    /*
+        Fourier transformed dipole matrices of the FFT convolution.
+        As they depend only on the geometry, the boundary conditions and the number of periodic images
+        (stored in the signature), they are cached and shared by all Hamiltonians for which these agree.
+    */
+    struct DDI_Kernel
+    {
+        std::vector<scalar> signature;
+        field<FFT::FFT_cpx_type> transformed_dipole_matrices;
+        field<Matrix3> dipole_matrices;
+        // At which index to look up the inter-sublattice D-matrices
+        field<int> inter_sublattice_lookup;
+    };
+
+    /*
+        Octree over the spin positions for the Barnes-Hut summation of the dipolar field (DDI_Method::FMM).
+        The spins of a node are the range [begin[inode], end[inode]) of spin_index and the children of a node
+        are stored consecutively, always after their parent. Leaves have first_child = -1.
+        The centre of a node is the mu_s-weighted mean position of its spins and the radius the largest
+        distance of one of its spins from the centre. Vacancies are not part of the tree.
+    */
+    struct DDI_Tree
+    {
+        intfield    spin_index;
+        intfield    begin;
+        intfield    end;
+        intfield    first_child;
+        intfield    n_children;
+        vectorfield centre;
+        scalarfield radius;
+    };
+
     /*
         The Heisenberg Hamiltonian using Pairs contains all information on the interactions between spins.
         The information is presented in pair lists and parameter lists in order to easily e.g. calculate the energy of the system via summation.
@@ -35,7 +86,7 @@ namespace Engine
             intfield anisotropy_indices, scalarfield anisotropy_magnitudes, vectorfield anisotropy_normals,
             pairfield exchange_pairs, scalarfield exchange_magnitudes,
             pairfield dmi_pairs, scalarfield dmi_magnitudes, vectorfield dmi_normals,
-            DDI_Method ddi_method, intfield ddi_n_periodic_images, scalar ddi_radius,
+            DDI_Method ddi_method, intfield ddi_n_periodic_images, scalar ddi_radius, scalar ddi_theta,
             quadrupletfield quadruplets, scalarfield quadruplet_magnitudes,
             std::shared_ptr<Data::Geometry> geometry,
             intfield boundary_conditions
@@ -46,7 +97,7 @@ namespace Engine
             intfield anisotropy_indices, scalarfield anisotropy_magnitudes, vectorfield anisotropy_normals,
             scalarfield exchange_shell_magnitudes,
             scalarfield dmi_shell_magnitudes, int dm_chirality,
-            DDI_Method ddi_method, intfield ddi_n_periodic_images, scalar ddi_radius,
+            DDI_Method ddi_method, intfield ddi_n_periodic_images, scalar ddi_radius, scalar ddi_theta,
             quadrupletfield quadruplets, scalarfield quadruplet_magnitudes,
             std::shared_ptr<Data::Geometry> geometry,
             intfield boundary_conditions
@@ -57,13 +108,29 @@ namespace Engine
         void Update_Energy_Contributions() override;
 
         void Hessian(const vectorfield & spins, MatrixX & hessian) override;
+        void Sparse_Hessian(const vectorfield & spins, SpMatrixX & hessian) override;
+        void Hessian_Vector_Product(const vectorfield & spins, const vectorfield & vec, vectorfield & result) override;
         void Gradient(const vectorfield & spins, vectorfield & gradient) override;
+        // Calculate the gradients of several configurations in one pass.
+        //      The local interactions of all images share one parallel region and the FFT DDI of all images is a single batched transform.
+        void Gradient_Batch(const std::vector<const vectorfield*> & spins, std::vector<vectorfield*> & gradients) override;
+        // Compare the parameters, neighbour tables, DDI kernel and geometry with another Heisenberg Hamiltonian
+        bool Equivalent(const Hamiltonian & other) override;
         void Energy_Contributions_per_Spin(const vectorfield & spins, std::vector<std::pair<std::string, scalarfield>> & contributions) override;
 
         // Calculate the total energy for a single spin to be used in Monte Carlo.
         //      Note: therefore the energy of pairs is weighted x2 and of quadruplets x4.
         scalar Energy_Single_Spin(int ispin, const vectorfield & spins) override;
 
+        // Calculate the change of the total energy for a change of a single spin to be used in Monte Carlo.
+        //      Only the interactions of ispin are evaluated, using the neighbour tables.
+        //      Note: with FFT, tree or direct DDI, the dipolar field at ispin is an exact sum over all spins.
+        scalar Energy_Single_Spin_Difference(int ispin, const Vector3 & spin_old, const Vector3 & spin_new, const vectorfield & spins) override;
+
+        // Collect the interaction partners of each spin from the neighbour tables and quadruplets.
+        //      Note: this fails with FFT, tree or direct DDI, as the dipolar interaction then couples all spins.
+        bool Interaction_Neighbours(field<intfield> & neighbours) override;
+
         // Hamiltonian name as string
         const std::string& Name() override;
         
@@ -97,6 +164,9 @@ namespace Engine
         pairfield   dmi_pairs;
         scalarfield dmi_magnitudes;
         vectorfield dmi_normals;
+        // Neighbour tables, built once per geometry or boundary condition change (possibly shared with other Hamiltonians)
+        std::shared_ptr<const Pair_Table> exchange_table;
+        std::shared_ptr<const Pair_Table> dmi_table;
         // Dipole Dipole interaction
         DDI_Method  ddi_method;
         intfield    ddi_n_periodic_images;
@@ -105,17 +175,36 @@ namespace Engine
         pairfield   ddi_pairs;
         scalarfield ddi_magnitudes;
         vectorfield ddi_normals;
+        // Dipole tensors mult/r^3 * (3 n n^T - 1) of the pairs, without the moments mu_s
+        field<Matrix3> ddi_tensors;
+        std::shared_ptr<const Pair_Table> ddi_table;
+        //      ddi tree (fmm) variables: the field of a node of the tree is approximated by that of a single
+        //      dipole if the node's radius is smaller than ddi_theta times its distance
+        scalar      ddi_theta;
 
         // ------------ Quadruplet Interactions ------------
         quadrupletfield quadruplets;
         scalarfield     quadruplet_magnitudes;
+        // For each basis atom the quadruplets containing it, stored as (4*iquad + position in the quadruplet)
+        field<intfield> quadruplet_basis_index;
 
     private:
         std::shared_ptr<Data::Geometry> geometry;
 
+        // Resolve the partner indices of a list of pairs for all cells and store them in a CSR table
+        void Build_Pair_Table(const pairfield & pairs, bool use_redundant_neighbours, std::shared_ptr<const Pair_Table> & table);
+        // Resolve the indices of the four spins of a quadruplet, given one of its spins and its position in the quadruplet
+        void Quadruplet_Spin_Indices(int ispin, int iquad, int position, int idx[4]);
+        // Pass the non-zero 3x3 blocks (jspin, block) of the Hessian in the rows of spin ispin to add_block,
+        // which is used to assemble both the dense and the sparse Hessian
+        template<typename Callback>
+        void Hessian_Row_Blocks(int ispin, Callback && add_block);
+
         // ------------ Effective Field Functions ------------
         // Calculate the Zeeman effective field of a single Spin
         void Gradient_Zeeman(vectorfield & gradient);
+        // Calculate the Zeeman, anisotropy, exchange and DMI gradient of a single spin
+        Vector3 Gradient_Local_Single_Spin(int ispin, const vectorfield & spins);
         // Calculate the Anisotropy effective field of a single Spin
         void Gradient_Anisotropy(const vectorfield & spins, vectorfield & gradient);
         // Calculate the exchange interaction effective field of a Spin Pair
@@ -127,6 +216,12 @@ namespace Engine
         void Gradient_DDI_Cutoff(const vectorfield& spins, vectorfield & gradient);
         void Gradient_DDI_Direct(const vectorfield& spins, vectorfield & gradient);
         void Gradient_DDI_FFT(const vectorfield& spins, vectorfield & gradient);
+        void Gradient_DDI_Tree(const vectorfield& spins, vectorfield & gradient);
+        // FFT DDI of several images, using plans with one set of transforms per image
+        void Gradient_DDI_FFT(const std::vector<const vectorfield*> & spins, const std::vector<vectorfield*> & gradients,
+            FFT::FFT_Plan & plan_spins, FFT::FFT_Plan & plan_reverse, const FFT::StrideContainer & stride, int stride_img);
+        // Calculates the dipolar field of all other spins at spin ispin and the interaction tensor of ispin with its own periodic images
+        void Field_DDI_Single_Spin(int ispin, const vectorfield & spins, Vector3 & field, Matrix3 & tensor_self);
 
         // Quadruplet
         void Gradient_Quadruplet(const vectorfield & spins, vectorfield & gradient);
@@ -147,6 +242,7 @@ namespace Engine
         void E_DDI_Direct(const vectorfield& spins, scalarfield & Energy);
         void E_DDI_Cutoff(const vectorfield& spins, scalarfield & Energy);
         void E_DDI_FFT(const vectorfield& spins, scalarfield & Energy);
+        void E_DDI_Tree(const vectorfield& spins, scalarfield & Energy);
 
         // Quadruplet
         void E_Quadruplet(const vectorfield & spins, scalarfield & Energy);
@@ -158,21 +254,32 @@ namespace Engine
         // Plans for FT / rFT
         FFT::FFT_Plan fft_plan_spins;
         FFT::FFT_Plan fft_plan_reverse;
+        // Plans for the FT / rFT of several images at once, created by Prepare_DDI_Batch
+        int n_img_batch = 0;
+        FFT::FFT_Plan fft_plan_spins_batch;
+        FFT::FFT_Plan fft_plan_reverse_batch;
+        FFT::StrideContainer spin_stride_batch;
+        int spin_stride_batch_img;
+        void Prepare_DDI_Batch(int n_img);
 
-        field<FFT::FFT_cpx_type> transformed_dipole_matrices;
+        // Transformed dipole matrices (possibly shared with other Hamiltonians)
+        std::shared_ptr<DDI_Kernel> ddi_kernel;
 
         bool save_dipole_matrices = true;
-        field<Matrix3> dipole_matrices;
+
+        // Preparation of the Barnes-Hut summation
+        void Prepare_DDI_Tree();
+        DDI_Tree ddi_tree;
 
         // Number of inter-sublattice contributions
         int n_inter_sublattice;
-        // At which index to look up the inter-sublattice D-matrices
-        field<int> inter_sublattice_lookup;
 
         // Lengths of padded system
         field<int> n_cells_padded;
         // Total number of padded spins per sublattice
         int sublattice_size;
+        // Number of complex frequency points of each transform
+        int n_frequencies;
 
         FFT::StrideContainer spin_stride;
         FFT::StrideContainer dipole_stride;
@@ -181,6 +288,7 @@ namespace Engine
         void FFT_Dipole_Matrices(FFT::FFT_Plan & fft_plan_dipole, int img_a, int img_b, int img_c);
         //Calculate the FT of the padded spins
         void FFT_Spins(const vectorfield & spins);
+        void FFT_Spins(const std::vector<const vectorfield*> & spins, FFT::FFT_Plan & plan, const FFT::StrideContainer & stride, int stride_img);
 
         //Bounds for nested for loops. Only important for the CUDA version
         field<int> it_bounds_pointwise_mult;
@@ -53,6 +53,8 @@ namespace Engine
         //      The basis vectors will be the spherical unit vectors, except at the poles.
         //      The basis will be a 3Nx2N matrix.
         void tangent_basis_spherical(const vectorfield & vf, MatrixX & basis);
+        //      Same as above, but the basis is stored as a sparse matrix.
+        void tangent_basis_spherical(const vectorfield & vf, SpMatrixX & basis);
 
         // Calculate a matrix of orthonormal basis vectors that span the tangent space to
         //      a vectorfield, considered to live on the direct product of N unit spheres.
@@ -90,6 +92,8 @@ namespace Engine
 
         // Calculate Hessian for a vectorfield constrained to unit length, at any extremum (i.e. where vectors || gradient)
         void hessian_bordered(const vectorfield & image, const vectorfield & gradient, const MatrixX & hessian, MatrixX & tangent_basis, MatrixX & hessian_out);
+        //      Same as above for a sparse Hessian, producing a sparse 2Nx2N matrix and sparse 3Nx2N basis
+        void hessian_bordered(const vectorfield & image, const vectorfield & gradient, const SpMatrixX & hessian, SpMatrixX & tangent_basis, SpMatrixX & hessian_out);
         // Calculate tangential derivatives and correction terms according to the projector approach
         void hessian_projected(const vectorfield & image, const vectorfield & gradient, const MatrixX & hessian, MatrixX & tangent_basis, MatrixX & hessian_out);
         // Calculate tangential derivatives and correction terms according to the projector and Weingarten map approach
@@ -165,6 +165,10 @@ namespace Engine
         // Systems the Solver will access
         std::vector<std::shared_ptr<Data::Spin_System>> systems;
 
+        // Calculate the energy gradients of the given configurations of the systems.
+        //      If the Hamiltonians of all systems are equivalent, the gradients are evaluated as one batch.
+        void Calculate_Gradients(const std::vector<std::shared_ptr<vectorfield>> & configurations, std::vector<vectorfield*> & gradients);
+
         // Method Parameters
         std::shared_ptr<Data::Parameters_Method> parameters;
 
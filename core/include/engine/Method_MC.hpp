@@ -8,6 +8,7 @@
 // #include <data/Parameters_Method_MC.hpp>
 
 #include <vector>
+#include <random>
 
 namespace Engine
 {
@@ -19,6 +20,8 @@ namespace Engine
     public:
         // Constructor
         Method_MC(std::shared_ptr<Data::Spin_System> system, int idx_img, int idx_chain);
+        // Constructor drawing the random numbers from an external PRNG instead of the one of the parameters
+        Method_MC(std::shared_ptr<Data::Spin_System> system, int idx_img, int idx_chain, std::mt19937 & prng);
 
         // Method name as string
         std::string Name() override;
@@ -27,8 +30,28 @@ namespace Engine
         // Solver_Iteration represents one iteration of a certain Solver
         void Iteration() override;
 
-        // Metropolis iteration with adaptive cone radius
-        void Metropolis(const vectorfield & spins_old, vectorfield & spins_new);
+        // The single spin update moves
+        enum class Move
+        {
+            Metropolis,
+            Heat_Bath,
+            Overrelaxation
+        };
+
+        // Metropolis iteration with adaptive cone radius, performed in-place
+        void Metropolis(vectorfield & spins);
+        // Apply a move to every spin once (on average, if sampled randomly); returns the number of rejections
+        int Sweep(vectorfield & spins, Move move);
+        // A single trial move of spin ispin; returns whether it was accepted
+        bool Trial(int ispin, vectorfield & spins, Move move, std::mt19937 & prng, std::uniform_real_distribution<scalar> & distribution);
+        // The local field h at spin ispin, i.e. the part of its energy which is linear in the spin: E = -h*s + ...
+        Vector3 Local_Field(int ispin, const vectorfield & spins);
+        // Colour the lattice such that no two spins of the same colour interact
+        void Build_Colouring(const field<intfield> & neighbours);
+        // Whether the heat bath move and how many over-relaxation sweeps are used, which is only
+        //      the case for short-ranged interactions
+        bool Heat_Bath();
+        int N_Overrelaxation();
 
         // Save the current Step's Data: spins and energy
         void Save_Current(std::string starttime, int iteration, bool initial=false, bool final=false) override;
@@ -56,8 +79,19 @@ namespace Engine
         scalar acceptance_ratio_current;
         int nos_nonvacant;
 
-        // Random vector array
-        vectorfield xi;
+        // The PRNG of the serial sweep, which also seeds the streams of the parallel sweep
+        std::mt19937 & prng;
+
+        // Random number distributions
+        std::uniform_real_distribution<scalar> distribution;
+        std::uniform_int_distribution<int> distribution_idx;
+
+        // Whether the Hamiltonian only has short-ranged interactions
+        bool short_ranged;
+
+        // Spin indices of each colour and the per-thread PRNGs of the parallel sweep
+        field<intfield> colours;
+        std::vector<std::mt19937> prngs;
     };
 }
 
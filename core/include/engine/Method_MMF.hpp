@@ -51,6 +51,8 @@ namespace Engine
         vectorfield minimum_mode;
         int mode_follow_previous;
         VectorX mode_2N_previous;
+        // Last calculated eigenmodes (3N), used as initial guess for the next eigenmode calculation
+        MatrixX modes_3N_previous;
 
         // Last iterations spins and reaction coordinate
         scalar Rx_last;
@@ -0,0 +1,87 @@
+#pragma once
+#ifndef METHOD_PT_H
+#define METHOD_PT_H
+
+#include "Spirit_Defines.h"
+#include <engine/Method.hpp>
+#include <data/Spin_System_Chain.hpp>
+#include <data/Parameters_Method_MC.hpp>
+
+#include <vector>
+#include <random>
+
+namespace Engine
+{
+    /*
+        The parallel tempering (replica exchange) Monte Carlo method.
+        Each image of the chain is a replica, which is sampled at the temperature
+        of its own MC parameters. The replicas are iterated concurrently and
+        neighbouring replicas periodically exchange their configurations.
+    */
+    class Method_PT : public Method
+    {
+    public:
+        // Constructor
+        Method_PT(std::shared_ptr<Data::Spin_System_Chain> chain, int idx_chain);
+
+        // Method name as string
+        std::string Name() override;
+
+        // Probability of exchanging the configurations of replicas at temperatures T_i and T_j with energies E_i and E_j
+        static scalar Exchange_Probability(scalar T_i, scalar T_j, scalar E_i, scalar E_j);
+
+    private:
+        // One MC iteration on every replica, followed by an exchange step if due
+        void Iteration() override;
+
+        // Attempt to exchange the configurations of neighbouring replicas
+        void Replica_Exchange();
+
+        // Save the current Step's Data: spins, energies and exchange ratios of the replicas
+        void Save_Current(std::string starttime, int iteration, bool initial=false, bool final=false) override;
+        // A hook into the Method before an Iteration of the Solver
+        void Hook_Pre_Iteration() override;
+        // A hook into the Method after an Iteration of the Solver
+        void Hook_Post_Iteration() override;
+
+        // Sets iteration_allowed to false for the corresponding method
+        void Initialize() override;
+        // Sets iteration_allowed to false for the corresponding method
+        void Finalize() override;
+
+        // Log message blocks
+        void Message_Start() override;
+        void Message_Step() override;
+        void Message_End() override;
+
+        // Lock the chain during iterations
+        void Lock() override;
+        void Unlock() override;
+
+        // Check if iterations are allowed on the chain
+        bool Iterations_Allowed() override;
+
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+        std::shared_ptr<Data::Parameters_Method_MC> parameters_mc;
+
+        // The MC methods iterating the individual replicas
+        std::vector<std::shared_ptr<Method>> replicas;
+
+        // PRNGs of the MC iterations of the replicas
+        std::vector<std::mt19937> replica_prngs;
+
+        // PRNG of the exchange steps
+        std::mt19937 prng;
+        std::uniform_real_distribution<scalar> distribution;
+
+        // Energies of the replicas at the last exchange step
+        scalarfield energies;
+        // Whether the next exchange step pairs the replicas (0,1),(2,3),... or (1,2),(3,4),...
+        int exchange_offset;
+        // Number of attempted and accepted exchanges between replica i and i+1
+        intfield n_exchanges_attempted;
+        intfield n_exchanges_accepted;
+    };
+}
+
+#endif
@@ -5,8 +5,8 @@
 #include "Spirit_Defines.h"
 #include <Spirit/Simulation.h>
 #include <data/Parameters_Method.hpp>
+#include <data/Parameters_Method_Solver.hpp>
 #include <data/Spin_System_Chain.hpp>
-#include <data/Parameters_Method.hpp>
 #include <engine/Method.hpp>
 #include <engine/Vectormath.hpp>
 #include <engine/Manifoldmath.hpp>
@@ -31,8 +31,9 @@ namespace Engine
         Heun = Solver_Heun,
         Depondt = Solver_Depondt,
         RungeKutta4 = Solver_RungeKutta4,
-        NCG = -2,
-        BFGS = -3,
+        RungeKutta23 = Solver_RungeKutta23,
+        NCG = Solver_NCG,
+        BFGS = Solver_LBFGS,
         VP = Solver_VP
     };
 
@@ -119,37 +120,37 @@ namespace Engine
         virtual void Message_End() override;
 
 
-        //////////// DEPONDT ////////////////////////////////////////////////////////////
-        // Temporaries for virtual forces
-        std::vector<vectorfield> rotationaxis;
-        std::vector<scalarfield> forces_virtual_norm;
-        // Preccession angle
-        scalarfield angle;
-
         //////////// NCG ////////////////////////////////////////////////////////////
-        // Check if the Newton-Raphson has converged
-        bool NR_converged();
-
-        int jmax;     // max iterations for Newton-Raphson loop
-        int n;        // number of iteration after which the nCG will restart
-
-        scalar tolerance_nCG, tolerance_NR;   // tolerances for solver and Newton-Raphson
-        scalar epsilon_nCG, epsilon_NR;   // Newton-Raphson and solver tolerance squared
-
-        bool restart_nCG, continue_NR;  // conditions for restarting nCG or continuing Newton-Raphson
-
-        // Step sizes
-        std::vector<scalarfield> alpha, beta;
-
-        // TODO: right type might be std::vector<scalar> and NOT std::vector<scalarfield>
-        // Delta scalarfields
-        std::vector<scalarfield> delta_0, delta_new, delta_old, delta_d;
-
-        // Residual and new configuration states
-        std::vector<vectorfield> residual, direction;
-
-        // buffer variables for checking convergence for solver and Newton-Raphson
-        std::vector<scalarfield> r_dot_d, dda2;
+        int jmax;     // max number of force evaluations in the line search
+        int n;        // number of iterations after which the NCG will restart
+
+        scalar c2_NCG;          // parameter of the strong Wolfe curvature condition of the line search
+        scalar max_angle_NCG;   // max rotation angle of a spin in one line search
+
+        // Step length and directional derivative of the previous line search
+        scalar alpha_NCG, slope_NCG;
+
+        // Residual (projected force), its previous value and the search direction
+        std::vector<vectorfield> residual, residual_previous, direction;
+
+        //////////// BFGS ///////////////////////////////////////////////////////////
+        // Limited memory of every image: the last steps s and changes of the gradient y [noi][memory][nos]
+        std::vector<std::vector<vectorfield>> lbfgs_s, lbfgs_y;
+        // rho = 1/(s*y) and the coefficients of the two-loop recursion [noi][memory]
+        std::vector<std::vector<scalar>> lbfgs_rho, lbfgs_alpha;
+        // Number of stored steps and index of the next one to be stored [noi]
+        std::vector<int> lbfgs_n_stored, lbfgs_index;
+        // Scaling of the initial inverse Hessian [noi]
+        std::vector<scalar> lbfgs_gamma;
+        // Step in the tangent spaces of the spins [noi][nos]
+        std::vector<vectorfield> lbfgs_step;
+
+        //////////// RK23 ///////////////////////////////////////////////////////////
+        // Time step [ps] of the next trial step and of the last accepted step
+        scalar rk23_dt, rk23_dt_accepted;
+        // Rotation vectors of the 3rd order solution [noi][nos] and the local error of one image [nos]
+        std::vector<vectorfield> rk23_rotation;
+        vectorfield rk23_error;
 
         //////////// VP ///////////////////////////////////////////////////////////////
         // "Mass of our particle" which we accelerate
@@ -166,9 +167,6 @@ namespace Engine
         // |force|^2
         std::vector<scalar> force_norm2;
 
-        // Temporary Spins arrays
-        vectorfield temp1, temp2;
-
         // Actual Forces on the configurations
         std::vector<vectorfield> forces;
         std::vector<vectorfield> forces_predictor;
@@ -176,11 +174,10 @@ namespace Engine
         std::vector<vectorfield> forces_virtual;
         std::vector<vectorfield> forces_virtual_predictor;
 
-        // RK 4
+        // RK 4 and RK23
         std::vector<std::shared_ptr<vectorfield>> configurations_k1;
         std::vector<std::shared_ptr<vectorfield>> configurations_k2;
         std::vector<std::shared_ptr<vectorfield>> configurations_k3;
-        std::vector<std::shared_ptr<vectorfield>> configurations_k4;
 
         // Random vector array
         vectorfield xi;
@@ -326,8 +323,10 @@ namespace Engine
     #include <engine/Solver_VP.hpp>
     #include <engine/Solver_Heun.hpp>
     #include <engine/Solver_RK4.hpp>
+    #include <engine/Solver_RK23.hpp>
     #include <engine/Solver_Depondt.hpp>
     #include <engine/Solver_NCG.hpp>
+    #include <engine/Solver_BFGS.hpp>
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include "Spirit_Defines.h"
+#include <engine/Vectormath_Defines.hpp>
+#include <utility/Constants.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace Engine
+{
+    /*
+        Counter-based pseudo random number generator Philox4x32-10
+        (J. K. Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC11).
+        Each call maps a counter and a key to four independent 32 bit random numbers without any
+        internal state, so that e.g. every spin can draw its own random numbers in a parallel loop and
+        the result does not depend on the number of threads.
+    */
+    namespace Philox
+    {
+        typedef std::array<std::uint32_t, 4> Counter;
+        typedef std::array<std::uint32_t, 2> Key;
+
+        inline Counter philox4x32(Counter counter, Key key)
+        {
+            const std::uint32_t M0 = 0xD2511F53, M1 = 0xCD9E8D57;
+            const std::uint32_t W0 = 0x9E3779B9, W1 = 0xBB67AE85;
+            for( int round = 0; round < 10; ++round )
+            {
+                if( round > 0 )
+                {
+                    key[0] += W0;
+                    key[1] += W1;
+                }
+                std::uint64_t product_0 = std::uint64_t(M0) * counter[0];
+                std::uint64_t product_1 = std::uint64_t(M1) * counter[2];
+                counter = Counter{ { std::uint32_t(product_1 >> 32) ^ counter[1] ^ key[0], std::uint32_t(product_1),
+                                     std::uint32_t(product_0 >> 32) ^ counter[3] ^ key[1], std::uint32_t(product_0) } };
+            }
+            return counter;
+        }
+
+        // Uniformly distributed number in the open interval (0,1)
+        inline scalar uniform(std::uint32_t bits)
+        {
+            return ( scalar(bits) + scalar(0.5) ) * scalar(2.3283064365386963e-10);
+        }
+
+        // Four normally distributed numbers (mean 0, width 1), using the Box-Muller transform
+        inline std::array<scalar, 4> normal4(const Counter & counter, const Key & key)
+        {
+            const scalar two_pi = 2 * Utility::Constants::Pi;
+            auto bits = philox4x32(counter, key);
+            scalar r_0 = std::sqrt( -2 * std::log(uniform(bits[0])) );
+            scalar r_1 = std::sqrt( -2 * std::log(uniform(bits[2])) );
+            scalar phi_0 = two_pi * uniform(bits[1]);
+            scalar phi_1 = two_pi * uniform(bits[3]);
+            return std::array<scalar, 4>{ { r_0 * std::cos(phi_0), r_0 * std::sin(phi_0),
+                                            r_1 * std::cos(phi_1), r_1 * std::sin(phi_1) } };
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,158 @@
+template <> inline
+void Method_Solver<Solver::BFGS>::Initialize ()
+{
+    auto& parameters = *std::static_pointer_cast<Data::Parameters_Method_Solver>(this->parameters);
+    int memory = std::max(1, parameters.lbfgs_memory);
+
+    this->forces          = std::vector<vectorfield>( this->noi, vectorfield( this->nos, { 0, 0, 0 } ) );
+    this->forces_virtual  = std::vector<vectorfield>( this->noi, vectorfield( this->nos, { 0, 0, 0 } ) );
+    this->forces_previous = std::vector<vectorfield>( this->noi, vectorfield( this->nos, { 0, 0, 0 } ) );
+    this->lbfgs_step      = std::vector<vectorfield>( this->noi, vectorfield( this->nos, { 0, 0, 0 } ) );
+
+    this->lbfgs_s = std::vector<std::vector<vectorfield>>( this->noi, std::vector<vectorfield>( memory, vectorfield( this->nos, { 0, 0, 0 } ) ) );
+    this->lbfgs_y = std::vector<std::vector<vectorfield>>( this->noi, std::vector<vectorfield>( memory, vectorfield( this->nos, { 0, 0, 0 } ) ) );
+    this->lbfgs_rho   = std::vector<std::vector<scalar>>( this->noi, std::vector<scalar>( memory, 0 ) );
+    this->lbfgs_alpha = std::vector<std::vector<scalar>>( this->noi, std::vector<scalar>( memory, 0 ) );
+
+    this->lbfgs_n_stored = std::vector<int>( this->noi, 0 );
+    this->lbfgs_index    = std::vector<int>( this->noi, 0 );
+    this->lbfgs_gamma    = std::vector<scalar>( this->noi, 0 );
+
+    // F = - grad
+    this->Calculate_Force( this->configurations, this->forces );
+    for (int img=0; img<this->noi; img++)
+        Manifoldmath::project_tangential( this->forces[img], *this->configurations[img] );
+};
+
+
+/*
+    Template instantiation of the Simulation class for use with the L-BFGS Solver.
+        The limited-memory BFGS method approximates the inverse Hessian from the last
+        steps s and changes of the gradient y, using O(memory*N) storage per image.
+        Every image keeps its own memory, as the images of a GNEB chain are only
+        coupled by the spring and projected forces.
+        All vectors live in the tangent spaces of the spins. The spins are moved by
+        rotations along great circles (geodesics) and the last step is transported
+        along with them, while the previous forces are projected into the new tangent
+        spaces. As for GNEB the forces are not the gradient of an energy, there is no
+        line search: instead, the step is scaled such that no spin is rotated by more
+        than lbfgs_max_rotation, and the memory of an image is reset if its step is not
+        a descent direction, s*y is not positive or the force has increased.
+    Paper: J. Nocedal, Updating quasi-Newton matrices with limited storage,
+           Math. Comp. 35, 773 (1980).
+           A. V. Ivanov et al., Fast and robust algorithm for energy minimization of
+           spin systems applied in an analysis of high temperature spin configurations
+           in terms of skyrmion density, Comp. Phys. Comm. 260, 107749 (2021).
+*/
+template <> inline
+void Method_Solver<Solver::BFGS>::Iteration ()
+{
+    auto& parameters = *std::static_pointer_cast<Data::Parameters_Method_Solver>(this->parameters);
+    int memory = this->lbfgs_s[0].size();
+
+    scalar force_max = 0;
+    for (int img=0; img<this->noi; img++)
+        force_max = std::max( force_max, Vectormath::max_abs_component(this->forces[img]) );
+    if( force_max == 0 )
+        return;
+
+    scalar step_max = 0;
+    for (int img=0; img<this->noi; img++)
+    {
+        auto& force = this->forces[img];
+        auto& step  = this->lbfgs_step[img];
+        auto& s     = this->lbfgs_s[img];
+        auto& y     = this->lbfgs_y[img];
+        auto& rho   = this->lbfgs_rho[img];
+        auto& alpha = this->lbfgs_alpha[img];
+
+        // Without stored steps, the first step rotates the spins by at most a tenth of the maximum rotation
+        if( this->lbfgs_gamma[img] <= 0 )
+            this->lbfgs_gamma[img] = 0.1 * parameters.lbfgs_max_rotation / force_max;
+
+        // Two-loop recursion: step = H * F, where H approximates the inverse Hessian
+        Vectormath::set_c_a( 1, force, step );
+        for( int k = 0; k < this->lbfgs_n_stored[img]; ++k )
+        {
+            int idx = ( this->lbfgs_index[img] - 1 - k + memory ) % memory;
+            alpha[idx] = rho[idx] * Vectormath::dot( s[idx], step );
+            Vectormath::add_c_a( -alpha[idx], y[idx], step );
+        }
+        Vectormath::scale( step, this->lbfgs_gamma[img] );
+        for( int k = this->lbfgs_n_stored[img] - 1; k >= 0; --k )
+        {
+            int idx = ( this->lbfgs_index[img] - 1 - k + memory ) % memory;
+            scalar beta = rho[idx] * Vectormath::dot( y[idx], step );
+            Vectormath::add_c_a( alpha[idx] - beta, s[idx], step );
+        }
+        Manifoldmath::project_tangential( step, *this->configurations[img] );
+
+        // Reset the memory if the step is not a descent direction
+        if( Vectormath::dot( force, step ) <= 0 )
+        {
+            this->lbfgs_n_stored[img] = 0;
+            Vectormath::set_c_a( this->lbfgs_gamma[img], force, step );
+        }
+
+        step_max = std::max( step_max, Vectormath::max_abs_component(step) );
+    }
+
+    // Limit the rotation of the spins
+    if( step_max > parameters.lbfgs_max_rotation )
+    {
+        for (int img=0; img<this->noi; img++)
+            Vectormath::scale( this->lbfgs_step[img], parameters.lbfgs_max_rotation / step_max );
+    }
+
+    // Rotate the spins and transport the step
+    for (int img=0; img<this->noi; img++)
+    {
+        Vectormath::set_c_a( 1, this->forces[img], this->forces_previous[img] );
+        Vectormath::geodesic_step( *this->configurations[img], this->lbfgs_step[img] );
+    }
+
+    // F = - grad at the new configurations
+    this->Calculate_Force( this->configurations, this->forces );
+
+    for (int img=0; img<this->noi; img++)
+    {
+        auto& force = this->forces[img];
+        int idx = this->lbfgs_index[img];
+        auto& s = this->lbfgs_s[img][idx];
+        auto& y = this->lbfgs_y[img][idx];
+
+        // Store s = step and y = grad_new - grad_previous in the tangent spaces of the new configuration
+        Manifoldmath::project_tangential( force, *this->configurations[img] );
+        Manifoldmath::project_tangential( this->forces_previous[img], *this->configurations[img] );
+        Vectormath::set_c_a( 1, this->lbfgs_step[img], s );
+        Vectormath::set_c_a( 1, this->forces_previous[img], y );
+        Vectormath::add_c_a( -1, force, y );
+
+        scalar s_dot_y = Vectormath::dot( s, y );
+        // The stored pair is only kept if the step did not increase the force, as the GNEB forces are not conservative
+        if( s_dot_y > 0 && Vectormath::dot( force, force ) <= Vectormath::dot( this->forces_previous[img], this->forces_previous[img] ) )
+        {
+            this->lbfgs_rho[img][idx] = 1 / s_dot_y;
+            this->lbfgs_gamma[img]    = s_dot_y / Vectormath::dot( y, y );
+            this->lbfgs_index[img]    = ( idx + 1 ) % memory;
+            this->lbfgs_n_stored[img] = std::min( this->lbfgs_n_stored[img] + 1, memory );
+        }
+        else
+            this->lbfgs_n_stored[img] = 0;
+    }
+
+    // The virtual forces are used to check the convergence
+    this->Calculate_Force_Virtual( this->configurations, this->forces, this->forces_virtual );
+};
+
+template <> inline
+std::string Method_Solver<Solver::BFGS>::SolverName()
+{
+    return "LBFGS";
+};
+
+template <> inline
+std::string Method_Solver<Solver::BFGS>::SolverFullName()
+{
+    return "Limited-memory BFGS";
+};
@@ -7,15 +7,9 @@ void Method_Solver<Solver::Depondt>::Initialize ()
     this->forces_predictor = std::vector<vectorfield>( this->noi, vectorfield( this->nos, {0, 0, 0} ) );
     this->forces_virtual_predictor = std::vector<vectorfield>( this->noi, vectorfield( this->nos, {0, 0, 0} ) );
 
-    this->rotationaxis = std::vector<vectorfield>( this->noi, vectorfield( this->nos, {0, 0, 0} ) );
-    this->angle = scalarfield( this->nos, 0 );
-    this->forces_virtual_norm = std::vector<scalarfield>( this->noi, scalarfield( this->nos, 0 ) );
-
     this->configurations_predictor = std::vector<std::shared_ptr<vectorfield>>( this->noi );
     for (int i=0; i<this->noi; i++)
         configurations_predictor[i] = std::shared_ptr<vectorfield>( new vectorfield( this->nos, {0, 0, 0} ) );
-
-    this->temp1 = vectorfield( this->nos, {0, 0, 0} );
 };
 
 
@@ -42,14 +36,8 @@ void Method_Solver<Solver::Depondt>::Iteration ()
         auto& conf           = *this->configurations[i];
         auto& conf_predictor = *this->configurations_predictor[i];
 
-        // For Rotation matrix R := R( H_normed, angle )
-        Vectormath::norm( forces_virtual[i], angle );   // angle = |forces_virtual|
-
-        Vectormath::set_c_a( 1, forces_virtual[i], rotationaxis[i] );  // rotationaxis = |forces_virtual|
-        Vectormath::normalize_vectors( rotationaxis[i] );            // normalize rotation axis
-
-        // Get spin predictor n' = R(H) * n
-        Vectormath::rotate( conf, rotationaxis[i], angle, conf_predictor );
+        // Get spin predictor n' = R(H) * n, where the rotation axis is H_normed and the angle is |H|
+        Vectormath::depondt_rotate( conf, forces_virtual[i], conf_predictor );
     }
 
     // Calculate_Force for the Corrector
@@ -61,18 +49,8 @@ void Method_Solver<Solver::Depondt>::Iteration ()
     {
         auto& conf   = *this->configurations[i];
 
-        // Calculate the linear combination of the two forces_virtuals
-        Vectormath::set_c_a( 0.5, forces_virtual[i], temp1);   // H = H/2
-        Vectormath::add_c_a( 0.5, forces_virtual_predictor[i], temp1 ); // H = (H + H')/2
-
-        // Get the rotation angle as norm of temp1 ...For Rotation matrix R' := R( H'_normed, angle' )
-        Vectormath::norm( temp1, angle );   // angle' = |forces_virtual lin combination|
-
-        // Normalize temp1 to get rotation axes
-        Vectormath::normalize_vectors( temp1 );
-
         // Get new spin conf n_new = R( (H+H')/2 ) * n
-        Vectormath::rotate( conf, temp1, angle, conf );
+        Vectormath::depondt_rotate( conf, 0.5, forces_virtual[i], 0.5, forces_virtual_predictor[i], conf );
     }
 };
 
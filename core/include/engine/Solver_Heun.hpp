@@ -14,8 +14,6 @@ void Method_Solver<Solver::Heun>::Initialize ()
     this->configurations_predictor = std::vector<std::shared_ptr<vectorfield>>( this->noi );
     for (int i=0; i<this->noi; i++)
       configurations_predictor[i] = std::shared_ptr<vectorfield>(new vectorfield(this->nos));
-
-    this->temp1 = vectorfield( this->nos, {0, 0, 0} );
 };
 
 
@@ -45,12 +43,8 @@ void Method_Solver<Solver::Heun>::Iteration ()
         auto& conf_predictor = *this->configurations_predictor[i];
 
         // First step - Predictor
-        Vectormath::set_c_cross( -1, conf, forces_virtual[i], conf_temp );  // temp1 = -( conf x A )
-        Vectormath::set_c_a( 1, conf, conf_predictor );                   // configurations_predictor = conf
-        Vectormath::add_c_a( 1, conf_temp, conf_predictor );         // configurations_predictor = conf + dt*temp1
-
-        // Normalize spins
-        Vectormath::normalize_vectors( conf_predictor );
+        //      configurations_temp = -( conf x A ), configurations_predictor = normalize( conf + configurations_temp )
+        Vectormath::explicit_stage( conf, conf, forces_virtual[i], 1, conf_temp, conf_predictor );
     }
 
     // Calculate_Force for the Corrector
@@ -65,16 +59,8 @@ void Method_Solver<Solver::Heun>::Iteration ()
         auto& conf_predictor = *this->configurations_predictor[i];
 
         // Second step - Corrector
-        Vectormath::scale( conf_temp, 0.5 );                                     // configurations_temp = 0.5 * configurations_temp
-        Vectormath::add_c_a( 1, conf, conf_temp );                               // configurations_temp = conf + 0.5 * configurations_temp
-        Vectormath::set_c_cross( -1, conf_predictor, forces_virtual_predictor[i], temp1 );   // temp1 = - ( conf' x A' )
-        Vectormath::add_c_a( 0.5, temp1, conf_temp );                            // configurations_temp = conf + 0.5 * configurations_temp + 0.5 * temp1
-
-        // Normalize spins
-        Vectormath::normalize_vectors( conf_temp );
-
-        // Copy out
-        conf = conf_temp;
+        //      conf = normalize( conf + 0.5 * configurations_temp - 0.5 * ( conf' x A' ) )
+        Vectormath::heun_corrector( conf, conf_temp, conf_predictor, forces_virtual_predictor[i], conf );
     }
 };
 
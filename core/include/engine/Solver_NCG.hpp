@@ -1,48 +1,37 @@
 template <> inline
 void Method_Solver<Solver::NCG>::Initialize ()
 {
-    this->jmax    = 500;    // max iterations
-    this->n       = 50;     // restart every n iterations XXX: what's the appropriate val?
-    
-    this->tolerance_NR  = 1e-5;   // Newton-Raphson error tolerance
-    this->tolerance_nCG = 1e-5;   // solver's error tolerance1
-	this->epsilon_NR  = 1e-5;// pow(this->tolerance_NR, 2);   // for Newton-Raphson's convergence condition 
-    this->epsilon_nCG = pow( this->tolerance_nCG, 2 );  // for solver's convergence condition
-    
-    this->alpha = std::vector<scalarfield>( this->noi, scalarfield( this->nos, 0 ) );
-    this->beta  = std::vector<scalarfield>( this->noi, scalarfield( this->nos, 0 ) );
-    
-    // XXX: right type might be std::vector<scalar> and NOT std::vector<scalarfield>
-    this->delta_0   = std::vector<scalarfield>( this->noi, scalarfield( this->nos, 0 ) );
-    this->delta_new = std::vector<scalarfield>( this->noi, scalarfield( this->nos, 0 ) );
-    this->delta_old = std::vector<scalarfield>( this->noi, scalarfield( this->nos, 0 ) );
-    this->delta_d   = std::vector<scalarfield>( this->noi, scalarfield( this->nos, 0 ) );
-    
-    this->residual  = std::vector<vectorfield>( this->noi, vectorfield( this->nos, { 0, 0, 0 } ) );
-    this->direction = std::vector<vectorfield>( this->noi, vectorfield( this->nos, { 0, 0, 0 } ) );
-    
-    this->r_dot_d = std::vector<scalarfield>( this->noi, scalarfield( this->nos, 0 ) );
-    this->dda2    = std::vector<scalarfield>( this->noi, scalarfield( this->nos, 0 ) );
-    
-	// F = - grad
+    this->jmax = 20;    // max force evaluations per line search
+    this->n    = 50;    // restart every n iterations
+
+    this->c2_NCG        = 0.1;  // strong Wolfe curvature parameter
+    this->max_angle_NCG = 0.5;  // max. rotation of a spin in one line search
+
+    this->alpha_NCG = 0;
+    this->slope_NCG = 0;
+
+    this->forces         = std::vector<vectorfield>( this->noi, vectorfield( this->nos, { 0, 0, 0 } ) );
+    this->forces_virtual = std::vector<vectorfield>( this->noi, vectorfield( this->nos, { 0, 0, 0 } ) );
+
+    this->residual          = std::vector<vectorfield>( this->noi, vectorfield( this->nos, { 0, 0, 0 } ) );
+    this->residual_previous = std::vector<vectorfield>( this->noi, vectorfield( this->nos, { 0, 0, 0 } ) );
+    this->direction         = std::vector<vectorfield>( this->noi, vectorfield( this->nos, { 0, 0, 0 } ) );
+
+    this->configurations_temp = std::vector<std::shared_ptr<vectorfield>>( this->noi );
+    for (int i=0; i<this->noi; i++)
+      configurations_temp[i] = std::shared_ptr<vectorfield>(new vectorfield(this->nos));
+
+    // F = - grad
     this->Calculate_Force( this->configurations, this->forces );
-    
+
     for (int img=0; img<this->noi; img++)
     {
         // Project force into the tangent space of the spin configuration
         Manifoldmath::project_tangential(this->forces[img], *this->configurations[img]);
 
-        // set residual = - f'(x)
+        // residual = - f'(x), direction = residual
         Vectormath::set_c_a( 1, this->forces[img], this->residual[img] );
-        
-        // direction = residual
         Vectormath::set_c_a( 1, this->residual[img], this->direction[img] );
-        
-        // delta new = r * r
-        Vectormath::dot( this->residual[img], this->residual[img], this->delta_new[img] );
-        
-        // save initial delta
-        this->delta_0[img] = this->delta_new[img];
     }
 };
 
@@ -50,134 +39,169 @@ void Method_Solver<Solver::NCG>::Initialize ()
 /*
     Template instantiation of the Simulation class for use with the NCG Solver
     The method of nonlinear conjugate gradients is a proven and effective solver.
-    TODO: reference painless conjugate gradients
+        The search direction is updated with the Polak-Ribiere formula and the method
+        restarts with the steepest descent every n iterations or if the direction is not
+        a descent direction.
+        The line search does not need the Hessian: it is a secant search for the root of
+        the directional derivative -F*d along the line x(alpha) = normalize(x + alpha*d),
+        which only needs the forces. It stops when the strong Wolfe curvature condition
+        |F(alpha)*d| <= c2 |F(0)*d| is fulfilled. As the Method_Solver only knows the
+        forces, no energy based (Armijo) test is used. Instead, the search keeps a
+        bracket [alpha_lo, alpha_hi] with F*d > 0 at alpha_lo and F*d < 0 at alpha_hi,
+        so it cannot move past a maximum along the line, and a single step rotates
+        no spin by more than max_angle_NCG.
+        All images are moved along a common line.
+    Reference: J. R. Shewchuk, An Introduction to the Conjugate Gradient Method
+               Without the Agonizing Pain (1994).
 */
 template <> inline
 void Method_Solver<Solver::NCG>::Iteration ()
 {
-	// By default continue Newton-Raphson
-    this->continue_NR = true;
-	// By default do not restart( XXX:reset?? ) the whole method
-    this->restart_nCG = false;
-    
-    // Calculate delta_d
-    for (int img=0; img<this->noi; img++)
-        Engine::Vectormath::dot( this->direction[img], this->direction[img], this->delta_d[img] );
-    
-    // Perform a Newton-Raphson line search in order to determine the minimum along d  
-    for( int j=0; j<jmax && continue_NR; j++ )
+    // Directional derivative of the energy along the search direction, summed over the images
+    auto slope = [this]()
     {
-        // Calculate force F = - grad
-        this->Calculate_Force(this->configurations, this->forces);
+        scalar s = 0;
+        for (int img=0; img<this->noi; img++)
+            s -= Vectormath::dot( this->forces[img], this->direction[img] );
+        return s;
+    };
 
-		// Do line search per image
-        for (int img = 0; img < this->noi; img++)
+    // Move all images to x(alpha) and calculate the projected forces there
+    auto move_to = [this](scalar alpha)
+    {
+        for (int img=0; img<this->noi; img++)
         {
-            // Project force into the tangent space of the spin configuration
-            Manifoldmath::project_tangential(this->forces[img], *this->configurations[img]);
-
-            // Calculate Hessian
-            auto hessian = MatrixX(3 * this->nos, 3 * this->nos);
-            this->systems[img]->hamiltonian->Hessian(*this->configurations[img], hessian);
-
-            // Calculate alpha (NR step length)
-            // alpha = - (f'*d)/(d*f''*d)	// TODO: How to get the second derivative from here??
-            Eigen::Ref<VectorX> direction_ref = Eigen::Map<VectorX>(this->direction[img][0].data(), this->nos);
-            scalar denominator = direction_ref.dot( hessian * direction_ref );
-            scalar numerator = Engine::Vectormath::dot(this->forces[img], this->direction[img]); // / ppp;
-            scalar ratio = 1;
-            if (std::abs(denominator) > 0)
-                ratio = numerator / denominator;
-            Vectormath::fill(this->alpha[img], ratio);
-
-            // Update the spins (NR step)
-            // x = x + alpha*direction where x is the spin configuration
-            // Engine::Vectormath::add_c_a(this->alpha[img], this->direction[img], *this->configurations[img]);
-            Engine::Vectormath::add_c_a(ratio, this->direction[img], *this->configurations[img]);
-            Vectormath::normalize_vectors(*this->configurations[img]);
-                
-			// Check NR convergence
-            // Square alpha: alpha[i] = alpha[i]*alpha[i] (in next iteration we will have new alpha)
-            Engine::Vectormath::dot( this->alpha[img], this->alpha[img], this->alpha[img] ); 
-            // Calculate dda2[i] = delta_d[i] * alpha_sq[i]
-            Engine::Vectormath::dot( this->delta_d[img], this->alpha[img], this->dda2[img] );
-            // Check that convergence is achieved for every spin of that image
-            scalar dmax = 0;
-            for (auto& x : this->dda2[img]) dmax = std::max(dmax, std::abs(x));
-            if (dmax < this->epsilon_NR)
-            {
-                this->continue_NR = false; // stop Newton-Raphson
-                break;                     // break the convergence check
-            }
-        } // end of convergence test
-    } // end Newton-Raphson
-    
-    // Calculate force F = - grad from the new configurations
-    this->Calculate_Force( this->configurations, this->forces );
-    
-    // Update the direction
+            auto& conf = *this->configurations[img];
+            Vectormath::set_c_a( 1, *this->configurations_temp[img], conf );
+            Vectormath::add_c_a( alpha, this->direction[img], conf );
+            Vectormath::normalize_vectors( conf );
+        }
+        this->Calculate_Force( this->configurations, this->forces );
+        for (int img=0; img<this->noi; img++)
+            Manifoldmath::project_tangential( this->forces[img], *this->configurations[img] );
+    };
+
+    // Start of the line search
     for (int img=0; img<this->noi; img++)
+        Vectormath::set_c_a( 1, *this->configurations[img], *this->configurations_temp[img] );
+
+    scalar slope_0 = slope();
+    scalar d_max = 0;
+    for (int img=0; img<this->noi; img++)
+        d_max = std::max( d_max, Vectormath::max_abs_component(this->direction[img]) );
+
+    if( slope_0 < 0 && d_max > 0 )
     {
-        // Project force into the tangent space of the spin configuration
-        Manifoldmath::project_tangential(this->forces[img], *this->configurations[img]);
+        scalar alpha_max = this->max_angle_NCG / d_max;
 
-        // Set residual = - f'(x)
-        Engine::Vectormath::set_c_a( 1, this->forces[img], this->residual[img] );
+        // Initial guess from the previous line search, assuming the same change of the energy
+        scalar alpha_trial = 1e-2 / d_max;
+        if( this->alpha_NCG > 0 && this->slope_NCG < 0 )
+            alpha_trial = this->alpha_NCG * this->slope_NCG / slope_0;
+        alpha_trial = std::min( alpha_trial, alpha_max );
 
-        // delta_old = delta_new
-        this->delta_old[img] = this->delta_new[img];
+        // Points with descending (lo) and ascending (hi) energy along the line
+        scalar alpha_lo = 0, slope_lo = slope_0, alpha_prev = 0, slope_prev = slope_0;
+        scalar alpha_hi = -1, slope_hi = 0;
+        scalar alpha_current = 0;
+        bool accepted = false;
 
-        // delta_new = residual * residual
-        Engine::Vectormath::dot( this->residual[img], this->residual[img], this->delta_new[img] );
+        for( int j = 0; j < this->jmax; ++j )
+        {
+            move_to( alpha_trial );
+            alpha_current = alpha_trial;
+            scalar slope_trial = slope();
 
-        // beta = delta_new / delta_old
-        Engine::Vectormath::divide( this->delta_new[img], this->delta_old[img], this->beta[img] );
+            // Strong Wolfe curvature condition
+            if( std::abs(slope_trial) <= this->c2_NCG * std::abs(slope_0) )
+            {
+                accepted = true;
+                break;
+            }
 
-        // direction = residual + beta*direction
-        Engine::Vectormath::set_c_a( this->beta[img], this->direction[img], this->direction[img] ); // direction = beta*direction
-        Engine::Vectormath::add_c_a( 1, this->residual[img], this->direction[img] );                // direction += residual
+            if( slope_trial < 0 )
+            {
+                alpha_prev = alpha_lo;
+                slope_prev = slope_lo;
+                alpha_lo   = alpha_trial;
+                slope_lo   = slope_trial;
+            }
+            else
+            {
+                alpha_hi = alpha_trial;
+                slope_hi = slope_trial;
+            }
+
+            if( alpha_hi > 0 )
+            {
+                // Secant step inside the bracket, kept away from its ends
+                scalar width = alpha_hi - alpha_lo;
+                alpha_trial = alpha_lo - slope_lo * width / (slope_hi - slope_lo);
+                alpha_trial = std::max( alpha_lo + 0.1*width, std::min( alpha_trial, alpha_hi - 0.1*width ) );
+            }
+            else
+            {
+                // Still descending: extrapolate with the secant, at most by a factor 4 and up to alpha_max
+                if( alpha_lo >= alpha_max )
+                    break;
+                alpha_trial = 4 * alpha_lo;
+                if( slope_lo > slope_prev )
+                    alpha_trial = alpha_lo - slope_lo * (alpha_lo - alpha_prev) / (slope_lo - slope_prev);
+                alpha_trial = std::min( std::max( alpha_trial, 1.1*alpha_lo ), std::min( 4*alpha_lo, alpha_max ) );
+            }
+        }
+
+        // Without convergence of the line search, the furthest point with descending energy is used
+        if( !accepted && alpha_current != alpha_lo )
+        {
+            move_to( alpha_lo );
+            alpha_current = alpha_lo;
+        }
+
+        this->alpha_NCG = alpha_current;
+        this->slope_NCG = slope_0;
+    }
+    else
+    {
+        this->alpha_NCG = 0;
+        this->slope_NCG = 0;
     }
 
-    // Restart if direction is not a descent direction or after nos iterations
-    //    The latter improves convergence for small nos
+    // Update the direction with the Polak-Ribiere formula
+    scalar r_dot_r_previous = 0, r_dot_delta_r = 0;
+    for (int img=0; img<this->noi; img++)
+    {
+        // Residual = - f'(x) = projected force
+        Vectormath::set_c_a( 1, this->residual[img], this->residual_previous[img] );
+        Vectormath::set_c_a( 1, this->forces[img], this->residual[img] );
 
-    // XXX: probably the issuing of the restarting can be in a seperate function since it has
-    // its own semantics
+        r_dot_r_previous += Vectormath::dot( this->residual_previous[img], this->residual_previous[img] );
+        r_dot_delta_r    += Vectormath::dot( this->residual[img], this->residual[img] ) - Vectormath::dot( this->residual[img], this->residual_previous[img] );
+    }
 
-    // In case you are in the nth iteration restart nCG
-    if ( this->iteration > 0 && ( this->iteration % this->n ) != 0 )
-    this->restart_nCG = true;
+    scalar beta = 0;
+    if( r_dot_r_previous > 0 && ( this->iteration + 1 ) % this->n != 0 )
+        beta = std::max( scalar(0), r_dot_delta_r / r_dot_r_previous );
 
-    // In case there is no previous request to restart nCG check restarting criterion rd < 0 
-    if ( this->restart_nCG == false )
+    // direction = residual + beta*direction
+    scalar r_dot_d = 0;
+    for (int img=0; img<this->noi; img++)
     {
-        this->restart_nCG = true; // set restarting to true
-    
-        for (int img=0; img<this->noi && this->restart_nCG == true; img++)
-        {
-            // r_dot_d = residual * direction for that image
-            Engine::Vectormath::dot( this->residual[img], this->direction[img], this->r_dot_d[img] );
-            
-            // TODO: better check with minmax_component
-            for (int sp=0; sp<this->nos; sp++)
-            {
-                // In case of residual*direction not meeting the restarting criterion set restarting to false
-                // break this loop and the outermost loop will not continue due to its conditional
-                if( this->r_dot_d[img][sp] > 0 )
-                {
-                    this->restart_nCG = false;
-                    break;    
-                }
-            }
-        }
+        Vectormath::scale( this->direction[img], beta );
+        Vectormath::add_c_a( 1, this->residual[img], this->direction[img] );
+        Manifoldmath::project_tangential( this->direction[img], *this->configurations[img] );
+        r_dot_d += Vectormath::dot( this->residual[img], this->direction[img] );
     }
-    
-    // Reset direction in case of restart
-    if ( this->restart_nCG )
+
+    // Restart if the direction is not a descent direction
+    if( r_dot_d <= 0 )
     {
         for (int img=0; img<this->noi; img++)
-            Engine::Vectormath::set_c_a( 1, { 0, 0, 0 }, this->direction[img] );
+            Vectormath::set_c_a( 1, this->residual[img], this->direction[img] );
     }
+
+    // The virtual forces are used to check the convergence
+    this->Calculate_Force_Virtual( this->configurations, this->forces, this->forces_virtual );
 };
 
 template <> inline
@@ -190,4 +214,4 @@ template <> inline
 std::string Method_Solver<Solver::NCG>::SolverFullName()
 {
     return "Nonlinear conjugate gradients";
-};
\ No newline at end of file
+};
@@ -0,0 +1,159 @@
+template <> inline
+void Method_Solver<Solver::RungeKutta23>::Initialize ()
+{
+    this->forces         = std::vector<vectorfield>( this->noi, vectorfield( this->nos, {0, 0, 0} ) );
+    this->forces_virtual = std::vector<vectorfield>( this->noi, vectorfield( this->nos, {0, 0, 0} ) );
+
+    this->forces_predictor = std::vector<vectorfield>( this->noi, vectorfield( this->nos, {0, 0, 0} ) );
+    this->forces_virtual_predictor = std::vector<vectorfield>( this->noi, vectorfield( this->nos, {0, 0, 0} ) );
+
+    this->configurations_predictor = std::vector<std::shared_ptr<vectorfield>>( this->noi );
+    for (int i=0; i<this->noi; i++)
+      this->configurations_predictor[i] = std::shared_ptr<vectorfield>(new vectorfield(this->nos));
+
+    this->configurations_temp = std::vector<std::shared_ptr<vectorfield>>( this->noi );
+    for (int i=0; i<this->noi; i++)
+      this->configurations_temp[i] = std::shared_ptr<vectorfield>(new vectorfield(this->nos));
+
+    this->configurations_k1 = std::vector<std::shared_ptr<vectorfield>>( this->noi );
+    for (int i=0; i<this->noi; i++)
+      this->configurations_k1[i] = std::shared_ptr<vectorfield>(new vectorfield(this->nos));
+
+    this->configurations_k2 = std::vector<std::shared_ptr<vectorfield>>( this->noi );
+    for (int i=0; i<this->noi; i++)
+      this->configurations_k2[i] = std::shared_ptr<vectorfield>(new vectorfield(this->nos));
+
+    this->configurations_k3 = std::vector<std::shared_ptr<vectorfield>>( this->noi );
+    for (int i=0; i<this->noi; i++)
+      this->configurations_k3[i] = std::shared_ptr<vectorfield>(new vectorfield(this->nos));
+
+    this->rk23_rotation = std::vector<vectorfield>( this->noi, vectorfield( this->nos, {0, 0, 0} ) );
+    this->rk23_error    = vectorfield( this->nos, {0, 0, 0} );
+
+    // The first trial step uses the time step of the parameters
+    this->rk23_dt          = 0;
+    this->rk23_dt_accepted = 0;
+};
+
+
+/*
+    Template instantiation of the Simulation class for use with the adaptive 3rd order Runge Kutta Solver.
+        The Bogacki-Shampine 3(2) pair is used as a Runge-Kutta-Munthe-Kaas method: the stages are
+        rotation vectors of the spins (the virtual forces), corrected by the first commutator term of
+        the inverse derivative of the exponential map, so that the spins stay on the unit sphere.
+        The difference of the 3rd and embedded 2nd order rotation vectors estimates the local error.
+        The time step is adapted such that the largest local error of a spin is about dt_tolerance.
+        If the error is larger, the step is repeated with a smaller time step.
+        The forces are calculated anew at the start of every iteration instead of reusing those at the
+        accepted spins (first same as last), as the spins or the Hamiltonian may have been changed in between.
+        An accepted step therefore needs four force calculations.
+        The virtual forces are calculated with the dt of the parameters and scaled to the adaptive time
+        step. As this scaling does not hold for the stochastic thermal field, the time step is not
+        adapted at finite temperature.
+    Paper: P. Bogacki and L. F. Shampine, A 3(2) pair of Runge-Kutta formulas, Appl. Math. Lett. 2, 321 (1989).
+           H. Munthe-Kaas, High order Runge-Kutta methods on manifolds, Appl. Numer. Math. 29, 115 (1999).
+*/
+template <> inline
+void Method_Solver<Solver::RungeKutta23>::Iteration ()
+{
+    auto& parameters = *this->systems[0]->llg_parameters;
+    bool temperature = parameters.temperature > 0 || parameters.temperature_gradient_inclination != 0;
+
+    // Generate random vectors for this iteration
+    this->Prepare_Thermal_Field();
+
+    // Get the actual forces on the configurations
+    this->Calculate_Force(this->configurations, this->forces);
+    this->Calculate_Force_Virtual(this->configurations, this->forces, this->forces_virtual);
+
+    if( temperature || this->rk23_dt <= 0 )
+        this->rk23_dt = parameters.dt;
+    this->rk23_dt = std::max( parameters.dt_min, std::min( this->rk23_dt, parameters.dt_max ) );
+
+    while( true )
+    {
+        // Ratio of the trial time step to the time step of the virtual forces
+        scalar ratio = this->rk23_dt / parameters.dt;
+
+        // k1 and predictor for k2
+        for (int i = 0; i < this->noi; ++i)
+        {
+            auto& conf = *this->configurations[i];
+            auto& k1   = *this->configurations_k1[i];
+            Vectormath::rk23_stage( conf, conf, 0, this->forces_virtual[i], this->forces_virtual[i], ratio, 0.5, k1, *this->configurations_predictor[i] );
+        }
+
+        this->Calculate_Force(this->configurations_predictor, this->forces_predictor);
+        this->Calculate_Force_Virtual(this->configurations_predictor, this->forces_predictor, this->forces_virtual_predictor);
+
+        // k2 and predictor for k3
+        for (int i = 0; i < this->noi; ++i)
+        {
+            auto& conf           = *this->configurations[i];
+            auto& conf_predictor = *this->configurations_predictor[i];
+            auto& k1             = *this->configurations_k1[i];
+            auto& k2             = *this->configurations_k2[i];
+            Vectormath::rk23_stage( conf, conf_predictor, 0.5, k1, this->forces_virtual_predictor[i], ratio, 0.75, k2, conf_predictor );
+        }
+
+        this->Calculate_Force(this->configurations_predictor, this->forces_predictor);
+        this->Calculate_Force_Virtual(this->configurations_predictor, this->forces_predictor, this->forces_virtual_predictor);
+
+        // k3 and 3rd order solution
+        for (int i = 0; i < this->noi; ++i)
+        {
+            auto& conf           = *this->configurations[i];
+            auto& conf_predictor = *this->configurations_predictor[i];
+            auto& k1             = *this->configurations_k1[i];
+            auto& k2             = *this->configurations_k2[i];
+            auto& k3             = *this->configurations_k3[i];
+            Vectormath::rk23_solution( conf, k1, k2, conf_predictor, this->forces_virtual_predictor[i], ratio, k3, this->rk23_rotation[i], *this->configurations_temp[i] );
+        }
+
+        this->Calculate_Force(this->configurations_temp, this->forces_predictor);
+        this->Calculate_Force_Virtual(this->configurations_temp, this->forces_predictor, this->forces_virtual_predictor);
+
+        // Local error from k4 and the embedded 2nd order solution
+        scalar error = 0;
+        for (int i = 0; i < this->noi; ++i)
+        {
+            auto& k1 = *this->configurations_k1[i];
+            auto& k2 = *this->configurations_k2[i];
+            auto& k3 = *this->configurations_k3[i];
+            Vectormath::rk23_error( k1, k2, k3, this->rk23_rotation[i], *this->configurations_temp[i], this->forces_virtual_predictor[i], ratio, this->rk23_error );
+            error = std::max( error, Vectormath::max_abs_component(this->rk23_error) );
+        }
+
+        scalar dt_trial = this->rk23_dt;
+        bool accepted = temperature || error <= parameters.dt_tolerance || dt_trial <= parameters.dt_min;
+
+        // New time step, changed by at most a factor 5 and with a safety factor 0.9
+        if( !temperature )
+        {
+            scalar factor = 5;
+            if( error > 0 )
+                factor = std::max( scalar(0.2), std::min( scalar(5), scalar(0.9) * std::cbrt(parameters.dt_tolerance / error) ) );
+            this->rk23_dt = std::max( parameters.dt_min, std::min( dt_trial * factor, parameters.dt_max ) );
+        }
+
+        if( accepted )
+        {
+            for (int i = 0; i < this->noi; ++i)
+                Vectormath::set_c_a( 1, *this->configurations_temp[i], *this->configurations[i] );
+            this->rk23_dt_accepted = dt_trial;
+            break;
+        }
+    }
+};
+
+template <> inline
+std::string Method_Solver<Solver::RungeKutta23>::SolverName()
+{
+    return "RK23";
+};
+
+template <> inline
+std::string Method_Solver<Solver::RungeKutta23>::SolverFullName()
+{
+    return "Runge Kutta (Bogacki-Shampine 3(2), adaptive time step)";
+};
@@ -7,10 +7,6 @@ void Method_Solver<Solver::RungeKutta4>::Initialize ()
     this->forces_predictor = std::vector<vectorfield>( this->noi, vectorfield( this->nos, {0, 0, 0} ) );
     this->forces_virtual_predictor = std::vector<vectorfield>( this->noi, vectorfield( this->nos, {0, 0, 0} ) );
 
-    this->configurations_temp  = std::vector<std::shared_ptr<vectorfield>>( this->noi );
-    for (int i=0; i<this->noi; i++)
-      this->configurations_temp[i] = std::shared_ptr<vectorfield>(new vectorfield(this->nos));
-
     this->configurations_predictor = std::vector<std::shared_ptr<vectorfield>>( this->noi );
     for (int i=0; i<this->noi; i++)
       this->configurations_predictor[i] = std::shared_ptr<vectorfield>(new vectorfield(this->nos));
@@ -27,11 +23,6 @@ void Method_Solver<Solver::RungeKutta4>::Initialize ()
     for (int i=0; i<this->noi; i++)
       this->configurations_k3[i] = std::shared_ptr<vectorfield>(new vectorfield(this->nos));
 
-    this->configurations_k4 = std::vector<std::shared_ptr<vectorfield>>( this->noi );
-    for (int i=0; i<this->noi; i++)
-      this->configurations_k4[i] = std::shared_ptr<vectorfield>(new vectorfield(this->nos));
-
-    this->temp1 = vectorfield( this->nos, {0, 0, 0} );
 };
 
 
@@ -56,14 +47,8 @@ void Method_Solver<Solver::RungeKutta4>::Iteration ()
         auto& conf_predictor = *this->configurations_predictor[i];
         auto& force          =  this->forces_virtual[i];
 
-        // k1
-        Vectormath::set_c_cross( -1, conf, force, k1 );
-
-        // Predictor for k2
-        Vectormath::set_c_a( 1, conf, conf_predictor );
-        Vectormath::add_c_a( 0.5, k1, conf_predictor );
-        // Normalize
-        Vectormath::normalize_vectors( conf_predictor );
+        // k1 and predictor for k2
+        Vectormath::explicit_stage( conf, conf, force, 0.5, k1, conf_predictor );
     }
 
     // Calculate_Force for the predictor
@@ -78,14 +63,8 @@ void Method_Solver<Solver::RungeKutta4>::Iteration ()
         auto& conf_predictor = *this->configurations_predictor[i];
         auto& force          =  this->forces_virtual_predictor[i];
 
-        // k2
-        Vectormath::set_c_cross( -1, conf_predictor, force, k2 );
-
-        // Predictor for k3
-        Vectormath::set_c_a( 1, conf, conf_predictor );
-        Vectormath::add_c_a( 0.5, k2, conf_predictor );
-        // Normalize
-        Vectormath::normalize_vectors( conf_predictor );
+        // k2 and predictor for k3
+        Vectormath::explicit_stage( conf, conf_predictor, force, 0.5, k2, conf_predictor );
     }
 
     // Calculate_Force for the predictor (k3)
@@ -100,14 +79,8 @@ void Method_Solver<Solver::RungeKutta4>::Iteration ()
         auto& conf_predictor = *this->configurations_predictor[i];
         auto& force          =  this->forces_virtual_predictor[i];
 
-        // k3
-        Vectormath::set_c_cross( -1, conf_predictor, force, k3 );
-
-        // Predictor for k4
-        Vectormath::set_c_a( 1, conf, conf_predictor );
-        Vectormath::add_c_a( 1, k3, conf_predictor );
-        // Normalize
-        Vectormath::normalize_vectors( conf_predictor );
+        // k3 and predictor for k4
+        Vectormath::explicit_stage( conf, conf_predictor, force, 1, k3, conf_predictor );
     }
 
     // Calculate_Force for the predictor (k4)
@@ -121,26 +94,11 @@ void Method_Solver<Solver::RungeKutta4>::Iteration ()
         auto& k1             = *this->configurations_k1[i];
         auto& k2             = *this->configurations_k2[i];
         auto& k3             = *this->configurations_k3[i];
-        auto& k4             = *this->configurations_k4[i];
         auto& conf_predictor = *this->configurations_predictor[i];
-        auto& conf_temp      = *this->configurations_temp[i];
         auto& force          =  this->forces_virtual_predictor[i];
 
-        // k4
-        Vectormath::set_c_cross( -1, conf_predictor, force, k4 );
-
-        // 4th order Runge Kutta step
-        Vectormath::set_c_a( 1, conf, conf_temp );
-        Vectormath::add_c_a( 1.0/6.0, k1, conf_temp );
-        Vectormath::add_c_a( 1.0/3.0, k2, conf_temp );
-        Vectormath::add_c_a( 1.0/3.0, k3, conf_temp );
-        Vectormath::add_c_a( 1.0/6.0, k4, conf_temp );
-
-        // Normalize spins
-        Vectormath::normalize_vectors( conf_temp );
-
-        // Copy out
-        conf = conf_temp;
+        // k4 and 4th order Runge Kutta step
+        Vectormath::rk4_corrector( conf, k1, k2, k3, conf_predictor, force, conf );
     }
 };
 
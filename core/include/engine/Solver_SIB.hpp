@@ -33,9 +33,8 @@ void Method_Solver<Solver::SIB>::Iteration ()
         auto& image     = *this->systems[i]->spins;
         auto& predictor = *this->configurations_predictor[i];
 
-        Vectormath::transform(image, forces_virtual[i], predictor);
-        Vectormath::add_c_a(1, image, predictor);
-        Vectormath::scale(predictor, 0.5);
+        // predictor = ( image + transform(image) ) / 2
+        Vectormath::sib_predictor(image, forces_virtual[i], predictor);
     }
 
     // Second part of the step
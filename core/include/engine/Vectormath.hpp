@@ -453,10 +453,45 @@ namespace Engine
         std::array<scalar, 3> Magnetization(const vectorfield & vf);
         // Calculate the topological charge inside a vectorfield
         scalar TopologicalCharge(const vectorfield & vf, const Data::Geometry & geom, const intfield & boundary_conditions);
+        // Calculate the topological charge density of each spin (a third of the charge of each triangle it belongs to)
+        //      and return the total topological charge
+        scalar TopologicalChargeDensity(const vectorfield & vf, const Data::Geometry & geom, const intfield & boundary_conditions, scalarfield & charge_density);
         
         // Utility function for the SIB Solver - maybe create a MathUtil namespace?
         void transform(const vectorfield & spins, const vectorfield & force, vectorfield & out);
 
+        // Fused per-spin kernels for the Solvers, which combine the operations of one solver stage into a single pass
+        //      SIB predictor: out = ( spins + transform(spins, force) ) / 2
+        void sib_predictor(const vectorfield & spins, const vectorfield & force, vectorfield & out);
+        //      Heun and RK4 stages: k = - spins_stage x force, out = normalize( spins + c * k )
+        void explicit_stage(const vectorfield & spins, const vectorfield & spins_stage, const vectorfield & force, const scalar & c, vectorfield & k, vectorfield & out);
+        //      Heun corrector: out = normalize( spins + (k1 + k2) / 2 ), where k2 = - spins_stage x force
+        void heun_corrector(const vectorfield & spins, const vectorfield & k1, const vectorfield & spins_stage, const vectorfield & force, vectorfield & out);
+        //      RK4 corrector: out = normalize( spins + (k1 + 2*k2 + 2*k3 + k4) / 6 ), where k4 = - spins_stage x force
+        void rk4_corrector(const vectorfield & spins, const vectorfield & k1, const vectorfield & k2, const vectorfield & k3, const vectorfield & spins_stage, const vectorfield & force, vectorfield & out);
+        //      RK23 (Runge-Kutta-Munthe-Kaas, Bogacki-Shampine 3(2)) stage: with the angular velocity omega = c * force projected
+        //      onto the tangent space of spins_stage, the rotation vector is k = omega - (c_u*u) x omega / 2 and out = spins rotated by c_next * k
+        void rk23_stage(const vectorfield & spins, const vectorfield & spins_stage, const scalar & c_u, const vectorfield & u, const vectorfield & force, const scalar & c, const scalar & c_next, vectorfield & k, vectorfield & out);
+        //      RK23 solution: k3 as in rk23_stage with u = 3/4 k2, rotation vector u = (2*k1 + 3*k2 + 4*k3) / 9 and out = spins rotated by u
+        void rk23_solution(const vectorfield & spins, const vectorfield & k1, const vectorfield & k2, const vectorfield & spins_stage, const vectorfield & force, const scalar & c, vectorfield & k3, vectorfield & u, vectorfield & out);
+        //      RK23 error estimate: difference of the rotation vectors of the 3rd and 2nd order solutions,
+        //      error = u - (7*k1/24 + k2/4 + k3/3 + k4/8), where k4 as in rk23_stage with the force at the new spins
+        void rk23_error(const vectorfield & k1, const vectorfield & k2, const vectorfield & k3, const vectorfield & u, const vectorfield & spins_new, const vectorfield & force, const scalar & c, vectorfield & error);
+        //      Depondt predictor: rotate the spins around the direction of force by its norm
+        void depondt_rotate(const vectorfield & spins, const vectorfield & force, vectorfield & out);
+        //      Depondt corrector: rotate the spins around the direction of (c1 * force_1 + c2 * force_2) by its norm
+        void depondt_rotate(const vectorfield & spins, const scalar & c1, const vectorfield & force_1, const scalar & c2, const vectorfield & force_2, vectorfield & out);
+        //      Geodesic step: rotate each spin towards its tangent vector step[i] by the angle |step[i]| and
+        //      transport step[i] into the tangent space of the rotated spin
+        void geodesic_step(vectorfield & spins, vectorfield & step);
+        //      LLG dynamics: force_virtual = dtg / mu_s * ( force + damping * spins x force ) + xi + damping * spins x xi
+        //      + stt_c_a * s_c + stt_c_cross * s_c x spins, where the STT direction s_c is s_c_grad[i] (if stt_gradient)
+        //      or s_c_vec (if stt_monolayer). The thermal field xi is only used if temperature is true.
+        //      Pinned spins, where mask_unpinned is zero, are given no force if pinning is enabled.
+        void llg_force_virtual(const vectorfield & spins, const vectorfield & force, const scalarfield & mu_s, const intfield & mask_unpinned,
+            const scalar & dtg, const scalar & damping, bool stt_gradient, const vectorfield & s_c_grad, bool stt_monolayer, const Vector3 & s_c_vec,
+            const scalar & stt_c_a, const scalar & stt_c_cross, bool temperature, const vectorfield & xi, vectorfield & force_virtual);
+
         void get_random_vector(std::uniform_real_distribution<scalar> & distribution, std::mt19937 & prng, Vector3 & vec);
         void get_random_vectorfield(std::mt19937 & prng, vectorfield & xi);
         void get_random_vector_unitsphere(std::uniform_real_distribution<scalar> & distribution, std::mt19937 & prng, Vector3 & vec);
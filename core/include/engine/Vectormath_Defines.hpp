@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Eigen/Core>
+#include <Eigen/SparseCore>
 
 #include <vector>
 #include <array>
@@ -13,6 +14,10 @@ using VectorX    = Eigen::Matrix<scalar, -1,  1>;
 using RowVectorX = Eigen::Matrix<scalar,  1, -1>;
 using MatrixX    = Eigen::Matrix<scalar, -1, -1>;
 
+// Sparse Eigen typedefs
+using SpMatrixX  = Eigen::SparseMatrix<scalar>;
+using SpTriplet  = Eigen::Triplet<scalar>;
+
 // 3D Eigen typedefs
 using Vector3    = Eigen::Matrix<scalar, 3, 1>;
 using RowVector3 = Eigen::Matrix<scalar, 1, 3>;
@@ -16,6 +16,7 @@ namespace IO
     // Note that due to the modular structure of the input parsers, input may be given in one or in separate files.
     // Input may be given incomplete. In this case a log entry is created and default values are used.
     void Log_from_Config(const std::string configFile, bool force_quiet=false);
+    void FFT_from_Config(const std::string configFile);
     std::unique_ptr<Data::Spin_System> Spin_System_from_Config(const std::string configFile);
     Data::Pinning Pinning_from_Config(const std::string configFile, int n_cell_atoms);
     std::shared_ptr<Data::Geometry> Geometry_from_Config(const std::string configFile);
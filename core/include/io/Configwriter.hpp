@@ -19,6 +19,7 @@ namespace IO
             const std::shared_ptr<Data::Parameters_Method_GNEB> parameters_gneb,
             const std::shared_ptr<Data::Parameters_Method_MMF> parameters_mmf);
     void Log_Levels_to_Config(const std::string configFile);
+    void FFT_to_Config(const std::string configFile);
     void Geometry_to_Config(const std::string configFile, const std::shared_ptr<Data::Geometry> geometry);
     void Parameters_Method_LLG_to_Config(const std::string configFile, const std::shared_ptr<Data::Parameters_Method_LLG> parameters);
     void Parameters_Method_MC_to_Config(const std::string configFile, const std::shared_ptr<Data::Parameters_Method_MC> parameters);
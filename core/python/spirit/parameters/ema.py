@@ -32,6 +32,24 @@ def set_n_mode_follow(p_state, n_mode, idx_image=-1, idx_chain=-1):
     _EMA_Set_N_Mode_Follow(ctypes.c_void_p(p_state), ctypes.c_int(n_mode),
                           ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
 
+_EMA_Set_Sparse          = _spirit.Parameters_EMA_Set_Sparse
+_EMA_Set_Sparse.argtypes = [ctypes.c_void_p, ctypes.c_bool,
+                                ctypes.c_int, ctypes.c_int]
+_EMA_Set_Sparse.restype  = None
+def set_sparse(p_state, sparse, idx_image=-1, idx_chain=-1):
+    """Set whether to use a sparse representation of the Hessian."""
+    _EMA_Set_Sparse(ctypes.c_void_p(p_state), ctypes.c_bool(sparse),
+                          ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
+
+_EMA_Set_Matrix_Free          = _spirit.Parameters_EMA_Set_Matrix_Free
+_EMA_Set_Matrix_Free.argtypes = [ctypes.c_void_p, ctypes.c_bool,
+                                     ctypes.c_int, ctypes.c_int]
+_EMA_Set_Matrix_Free.restype  = None
+def set_matrix_free(p_state, matrix_free, idx_image=-1, idx_chain=-1):
+    """Set whether to calculate Hessian-vector products on the fly instead of assembling the Hessian."""
+    _EMA_Set_Matrix_Free(ctypes.c_void_p(p_state), ctypes.c_bool(matrix_free),
+                          ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
+
 ## ---------------------------------- Get ----------------------------------
 
 _EMA_Get_N_Modes          = _spirit.Parameters_EMA_Get_N_Modes
@@ -46,4 +64,18 @@ _EMA_Get_N_Mode_Follow.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
 _EMA_Get_N_Mode_Follow.restype  = ctypes.c_int
 def get_n_mode_follow(p_state, idx_image=-1, idx_chain=-1):
     """Returns the index of the mode to use."""
-    return int(_EMA_Get_N_Mode_Follow(p_state, ctypes.c_int(idx_image), ctypes.c_int(idx_chain)))
\ No newline at end of file
+    return int(_EMA_Get_N_Mode_Follow(p_state, ctypes.c_int(idx_image), ctypes.c_int(idx_chain)))
+
+_EMA_Get_Sparse          = _spirit.Parameters_EMA_Get_Sparse
+_EMA_Get_Sparse.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
+_EMA_Get_Sparse.restype  = ctypes.c_bool
+def get_sparse(p_state, idx_image=-1, idx_chain=-1):
+    """Returns whether to use a sparse representation of the Hessian."""
+    return bool(_EMA_Get_Sparse(p_state, ctypes.c_int(idx_image), ctypes.c_int(idx_chain)))
+
+_EMA_Get_Matrix_Free          = _spirit.Parameters_EMA_Get_Matrix_Free
+_EMA_Get_Matrix_Free.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
+_EMA_Get_Matrix_Free.restype  = ctypes.c_bool
+def get_matrix_free(p_state, idx_image=-1, idx_chain=-1):
+    """Returns whether to calculate Hessian-vector products on the fly instead of assembling the Hessian."""
+    return bool(_EMA_Get_Matrix_Free(p_state, ctypes.c_int(idx_image), ctypes.c_int(idx_chain)))
\ No newline at end of file
@@ -109,6 +109,39 @@ def set_metropolis_cone(p_state, use_cone=True, cone_angle=40, use_adaptive_cone
     """
     _MC_Set_Metropolis_Cone(p_state, ctypes.c_bool(use_cone), ctypes.c_float(cone_angle), ctypes.c_bool(use_adaptive_cone), ctypes.c_float(target_acceptance_ratio), idx_image, idx_chain)
 
+_MC_Set_Update_Moves             = _spirit.Parameters_MC_Set_Update_Moves
+_MC_Set_Update_Moves.argtypes    = [ctypes.c_void_p, ctypes.c_bool, ctypes.c_int, ctypes.c_int, ctypes.c_int]
+_MC_Set_Update_Moves.restype     = None
+def set_update_moves(p_state, heat_bath=False, n_overrelaxation=0, idx_image=-1, idx_chain=-1):
+    """Configure the update moves.
+
+    - heat_bath: whether to sample the spins from the Boltzmann distribution in their local field
+      (otherwise: Metropolis sampling as configured by `set_metropolis_cone`)
+    - n_overrelaxation: number of energy-conserving over-relaxation sweeps after each heat bath or Metropolis sweep
+    """
+    _MC_Set_Update_Moves(ctypes.c_void_p(p_state), ctypes.c_bool(heat_bath), ctypes.c_int(n_overrelaxation),
+                         ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
+
+_MC_Set_Replica_Exchange_Interval             = _spirit.Parameters_MC_Set_Replica_Exchange_Interval
+_MC_Set_Replica_Exchange_Interval.argtypes    = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int, ctypes.c_int]
+_MC_Set_Replica_Exchange_Interval.restype     = None
+def set_replica_exchange_interval(p_state, n_iterations, idx_image=-1, idx_chain=-1):
+    """Set the number of iterations between replica exchanges in a parallel tempering calculation."""
+    _MC_Set_Replica_Exchange_Interval(ctypes.c_void_p(p_state), ctypes.c_int(n_iterations),
+                                      ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
+
+_MC_Set_Parallel_Sweep             = _spirit.Parameters_MC_Set_Parallel_Sweep
+_MC_Set_Parallel_Sweep.argtypes    = [ctypes.c_void_p, ctypes.c_bool, ctypes.c_int, ctypes.c_int]
+_MC_Set_Parallel_Sweep.restype     = None
+def set_parallel_sweep(p_state, parallel_sweep=True, idx_image=-1, idx_chain=-1):
+    """Set whether the spins should be updated in parallel.
+
+    The lattice is coloured such that no two spins of the same colour interact and the spins of each
+    colour are updated concurrently. This requires short-ranged interactions (no FFT or direct DDI).
+    """
+    _MC_Set_Parallel_Sweep(ctypes.c_void_p(p_state), ctypes.c_bool(parallel_sweep),
+                           ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
+
 ## ---------------------------------- Get ----------------------------------
 
 _MC_Get_N_Iterations             = _spirit.Parameters_MC_Get_N_Iterations
@@ -153,4 +186,36 @@ def get_metropolis_cone(p_state, idx_image=-1, idx_chain=-1):
                 ctypes.pointer(use_cone), ctypes.pointer(cone_angle),
                 ctypes.pointer(use_adaptive_cone), ctypes.pointer(target_acceptance_ratio),
                 ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
-    return bool(use_cone), float(cone_angle), bool(use_adaptive_cone), float(target_acceptance_ratio)
\ No newline at end of file
+    return bool(use_cone), float(cone_angle), bool(use_adaptive_cone), float(target_acceptance_ratio)
+
+_MC_Get_Update_Moves             = _spirit.Parameters_MC_Get_Update_Moves
+_MC_Get_Update_Moves.argtypes    = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_bool), ctypes.POINTER(ctypes.c_int),
+                                    ctypes.c_int, ctypes.c_int]
+_MC_Get_Update_Moves.restype     = None
+def get_update_moves(p_state, idx_image=-1, idx_chain=-1):
+    """Returns the configuration of the update moves.
+
+    - whether heat bath sampling is used (otherwise: Metropolis sampling)
+    - the number of over-relaxation sweeps after each heat bath or Metropolis sweep
+    """
+    heat_bath = ctypes.c_bool()
+    n_overrelaxation = ctypes.c_int()
+    _MC_Get_Update_Moves(ctypes.c_void_p(p_state), ctypes.pointer(heat_bath), ctypes.pointer(n_overrelaxation),
+                         ctypes.c_int(idx_image), ctypes.c_int(idx_chain))
+    return bool(heat_bath.value), int(n_overrelaxation.value)
+
+_MC_Get_Replica_Exchange_Interval             = _spirit.Parameters_MC_Get_Replica_Exchange_Interval
+_MC_Get_Replica_Exchange_Interval.argtypes    = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
+_MC_Get_Replica_Exchange_Interval.restype     = ctypes.c_int
+def get_replica_exchange_interval(p_state, idx_image=-1, idx_chain=-1):
+    """Returns the number of iterations between replica exchanges in a parallel tempering calculation."""
+    return int(_MC_Get_Replica_Exchange_Interval(ctypes.c_void_p(p_state), ctypes.c_int(idx_image),
+                                                 ctypes.c_int(idx_chain)))
+
+_MC_Get_Parallel_Sweep             = _spirit.Parameters_MC_Get_Parallel_Sweep
+_MC_Get_Parallel_Sweep.argtypes    = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int]
+_MC_Get_Parallel_Sweep.restype     = ctypes.c_bool
+def get_parallel_sweep(p_state, idx_image=-1, idx_chain=-1):
+    """Returns whether the spins should be updated in parallel."""
+    return bool(_MC_Get_Parallel_Sweep(ctypes.c_void_p(p_state), ctypes.c_int(idx_image),
+                                       ctypes.c_int(idx_chain)))
\ No newline at end of file
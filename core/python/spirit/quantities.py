@@ -83,4 +83,24 @@ def get_topological_charge(p_state, idx_image=-1, idx_chain=-1):
     Returns 0 for systems of other dimensionality.
     """
     return float(_Get_Topological_Charge(ctypes.c_void_p(p_state),
-                       ctypes.c_int(idx_image), ctypes.c_int(idx_chain)))
\ No newline at end of file
+                       ctypes.c_int(idx_image), ctypes.c_int(idx_chain)))
+
+_Get_Topological_Charge_Density          = _spirit.Quantity_Get_Topological_Charge_Density
+_Get_Topological_Charge_Density.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_float),
+                                            ctypes.c_int, ctypes.c_int]
+_Get_Topological_Charge_Density.restype  = ctypes.c_float
+def get_topological_charge_density(p_state, idx_image=-1, idx_chain=-1):
+    """Calculates the topological charge density of 2D systems and returns
+    the total topological charge and a `numpy.array` of shape (NOS) with the
+    charge density of each spin.
+
+    Each spin gets a third of the charge of the triangles it is a corner of,
+    so the density sums up to the total charge.
+
+    The density is zero for systems of other dimensionality.
+    """
+    nos = system.get_nos(p_state, idx_image, idx_chain)
+    _density = (nos*ctypes.c_float)()
+    charge = float(_Get_Topological_Charge_Density(ctypes.c_void_p(p_state), _density,
+                       ctypes.c_int(idx_image), ctypes.c_int(idx_chain)))
+    return charge, np.array(_density)
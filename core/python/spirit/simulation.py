@@ -40,6 +40,15 @@ SOLVER_HEUN = 3
 SOLVER_RK4 = 4
 """4th order Runge-Kutta method."""
 
+SOLVER_NCG = 5
+"""Nonlinear conjugate gradients (direct minimization only)."""
+
+SOLVER_LBFGS = 6
+"""Limited-memory BFGS (direct minimization only)."""
+
+SOLVER_RK23 = 7
+"""Bogacki-Shampine 3(2) Runge-Kutta method with adaptive time step (LLG only)."""
+
 
 METHOD_MC   = 0
 """Monte Carlo.
@@ -80,12 +89,25 @@ of images corresponding to the movement of the system under the mode.
 """
 
 
+METHOD_PT   = 5
+"""Parallel tempering Monte Carlo.
+
+Runs on the entire chain, each image at the temperature set in its MC parameters.
+Neighbouring images periodically exchange their configurations.
+"""
+
+
 ### ----- Start methods
 ### MC
 _MC_Start          = _spirit.Simulation_MC_Start
 _MC_Start.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int,
                         ctypes.c_bool, ctypes.c_int, ctypes.c_int]
 _MC_Start.restype  = None
+### PT
+_PT_Start          = _spirit.Simulation_PT_Start
+_PT_Start.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int,
+                        ctypes.c_bool, ctypes.c_int]
+_PT_Start.restype  = None
 ### LLG
 _LLG_Start          = _spirit.Simulation_LLG_Start
 _LLG_Start.argtypes = [ctypes.c_void_p, ctypes.c_int, ctypes.c_int, ctypes.c_int,
@@ -116,7 +138,7 @@ def start(p_state, method_type, solver_type=None, n_iterations=-1, n_iterations_
     - n_iterations: the maximum number of iterations that will be performed (default: take from parameters)
     - n_iterations_log: the number of iterations after which to log the status and write output (default: take from parameters)
     - single_shot: if set to `True`, iterations have to be triggered individually
-    - idx_image: the image on which to run the calculation (default: active image). Not used for GNEB
+    - idx_image: the image on which to run the calculation (default: active image). Not used for GNEB and PT
     """
 
     if method_type == METHOD_MC:
@@ -124,6 +146,11 @@ def start(p_state, method_type, solver_type=None, n_iterations=-1, n_iterations_
                                             ctypes.c_int(n_iterations), ctypes.c_int(n_iterations_log),
                                             ctypes.c_bool(single_shot),
                                             ctypes.c_int(idx_image), ctypes.c_int(idx_chain)])
+    elif method_type == METHOD_PT:
+        spiritlib.wrap_function(_PT_Start, [ctypes.c_void_p(p_state),
+                                            ctypes.c_int(n_iterations), ctypes.c_int(n_iterations_log),
+                                            ctypes.c_bool(single_shot),
+                                            ctypes.c_int(idx_chain)])
     elif method_type == METHOD_LLG:
         spiritlib.wrap_function(_LLG_Start, [ctypes.c_void_p(p_state),
                                             ctypes.c_int(solver_type),
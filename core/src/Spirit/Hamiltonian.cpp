@@ -35,6 +35,10 @@ void Hamiltonian_Set_Boundary_Conditions(State *state, const bool * periodical,
             image->hamiltonian->boundary_conditions[0] = periodical[0];
             image->hamiltonian->boundary_conditions[1] = periodical[1];
             image->hamiltonian->boundary_conditions[2] = periodical[2];
+
+            // The neighbour tables depend on the boundary conditions
+            if (image->hamiltonian->Name() == "Heisenberg")
+                ((Engine::Hamiltonian_Heisenberg*)image->hamiltonian.get())->Update_Interactions();
         }
         catch( ... )
         {
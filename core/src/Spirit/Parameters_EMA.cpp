@@ -134,6 +134,46 @@ void Parameters_EMA_Set_Snapshot(State *state, bool snapshot, int idx_image, int
 }
 
 
+void Parameters_EMA_Set_Sparse(State *state, bool sparse, int idx_image, int idx_chain) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        image->Lock();
+        image->ema_parameters->sparse = sparse;
+        image->Unlock();
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+    }
+}
+
+void Parameters_EMA_Set_Matrix_Free(State *state, bool matrix_free, int idx_image, int idx_chain) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        image->Lock();
+        image->ema_parameters->matrix_free = matrix_free;
+        image->Unlock();
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+    }
+}
+
 /*------------------------------------------------------------------------------------------------------ */
 /*---------------------------------- Get EMA ----------------------------------------------------------- */
 /*------------------------------------------------------------------------------------------------------ */
@@ -233,4 +273,42 @@ bool Parameters_EMA_Get_Snapshot(State *state, int idx_image, int idx_chain) noe
         spirit_handle_exception_api(idx_image, idx_chain);
         return 0;
     }
+}
+
+bool Parameters_EMA_Get_Sparse(State *state, int idx_image, int idx_chain) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        return image->ema_parameters->sparse;
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+        return false;
+    }
+}
+
+bool Parameters_EMA_Get_Matrix_Free(State *state, int idx_image, int idx_chain) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        return image->ema_parameters->matrix_free;
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+        return false;
+    }
 }
\ No newline at end of file
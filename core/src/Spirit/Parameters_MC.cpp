@@ -240,6 +240,68 @@ catch( ... )
     spirit_handle_exception_api(idx_image, idx_chain);
 }
 
+void Parameters_MC_Set_Update_Moves(State *state, bool heat_bath, int n_overrelaxation, int idx_image, int idx_chain) noexcept
+try
+{
+    std::shared_ptr<Data::Spin_System> image;
+    std::shared_ptr<Data::Spin_System_Chain> chain;
+
+    // Fetch correct indices and pointers
+    from_indices( state, idx_image, idx_chain, image, chain );
+
+    if( n_overrelaxation < 0 )
+    {
+        Log(Utility::Log_Level::Error, Utility::Log_Sender::API, fmt::format(
+            "Illegal number of over-relaxation sweeps: {}", n_overrelaxation), idx_image, idx_chain);
+        return;
+    }
+
+    image->Lock();
+    image->mc_parameters->heat_bath        = heat_bath;
+    image->mc_parameters->n_overrelaxation = n_overrelaxation;
+    image->Unlock();
+
+    Log(Utility::Log_Level::Info, Utility::Log_Sender::API, fmt::format(
+        "Set MC update moves: {} with {} over-relaxation sweep(s)",
+        heat_bath ? "heat bath" : "Metropolis", n_overrelaxation), idx_image, idx_chain);
+}
+catch( ... )
+{
+    spirit_handle_exception_api(idx_image, idx_chain);
+}
+
+void Parameters_MC_Set_Replica_Exchange_Interval(State *state, int n_iterations, int idx_image, int idx_chain) noexcept
+try
+{
+    std::shared_ptr<Data::Spin_System> image;
+    std::shared_ptr<Data::Spin_System_Chain> chain;
+
+    // Fetch correct indices and pointers
+    from_indices( state, idx_image, idx_chain, image, chain );
+
+    image->mc_parameters->replica_exchange_interval = n_iterations;
+}
+catch( ... )
+{
+    spirit_handle_exception_api(idx_image, idx_chain);
+}
+
+void Parameters_MC_Set_Parallel_Sweep(State *state, bool parallel_sweep, int idx_image, int idx_chain) noexcept
+try
+{
+    std::shared_ptr<Data::Spin_System> image;
+    std::shared_ptr<Data::Spin_System_Chain> chain;
+
+    // Fetch correct indices and pointers
+    from_indices( state, idx_image, idx_chain, image, chain );
+
+    image->mc_parameters->metropolis_parallel = parallel_sweep;
+}
+catch( ... )
+{
+    spirit_handle_exception_api(idx_image, idx_chain);
+}
+
 
 /*------------------------------------------------------------------------------------------------------ */
 /*---------------------------------- Get MC ------------------------------------------------------------ */
@@ -423,6 +485,57 @@ try
     return image->mc_parameters->metropolis_random_sample;
 }
 catch( ... )
+{
+    spirit_handle_exception_api(idx_image, idx_chain);
+    return false;
+}
+
+void Parameters_MC_Get_Update_Moves(State *state, bool * heat_bath, int * n_overrelaxation, int idx_image, int idx_chain) noexcept
+try
+{
+    std::shared_ptr<Data::Spin_System> image;
+    std::shared_ptr<Data::Spin_System_Chain> chain;
+
+    // Fetch correct indices and pointers
+    from_indices( state, idx_image, idx_chain, image, chain );
+
+    *heat_bath        = image->mc_parameters->heat_bath;
+    *n_overrelaxation = image->mc_parameters->n_overrelaxation;
+}
+catch( ... )
+{
+    spirit_handle_exception_api(idx_image, idx_chain);
+}
+
+int Parameters_MC_Get_Replica_Exchange_Interval(State *state, int idx_image, int idx_chain) noexcept
+try
+{
+    std::shared_ptr<Data::Spin_System> image;
+    std::shared_ptr<Data::Spin_System_Chain> chain;
+
+    // Fetch correct indices and pointers
+    from_indices( state, idx_image, idx_chain, image, chain );
+
+    return image->mc_parameters->replica_exchange_interval;
+}
+catch( ... )
+{
+    spirit_handle_exception_api(idx_image, idx_chain);
+    return 0;
+}
+
+bool Parameters_MC_Get_Parallel_Sweep(State *state, int idx_image, int idx_chain) noexcept
+try
+{
+    std::shared_ptr<Data::Spin_System> image;
+    std::shared_ptr<Data::Spin_System_Chain> chain;
+
+    // Fetch correct indices and pointers
+    from_indices( state, idx_image, idx_chain, image, chain );
+
+    return image->mc_parameters->metropolis_parallel;
+}
+catch( ... )
 {
     spirit_handle_exception_api(idx_image, idx_chain);
     return false;
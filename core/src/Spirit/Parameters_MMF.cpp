@@ -229,6 +229,46 @@ void Parameters_MMF_Set_N_Mode_Follow(State *state, int n_mode_follow, int idx_i
 }
 
 
+void Parameters_MMF_Set_Sparse(State *state, bool sparse, int idx_image, int idx_chain) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        image->Lock();
+        image->mmf_parameters->sparse = sparse;
+        image->Unlock();
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+    }
+}
+
+void Parameters_MMF_Set_Matrix_Free(State *state, bool matrix_free, int idx_image, int idx_chain) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        image->Lock();
+        image->mmf_parameters->matrix_free = matrix_free;
+        image->Unlock();
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+    }
+}
+
 
 /*------------------------------------------------------------------------------------------------------ */
 /*---------------------------------- Get MMF ----------------------------------------------------------- */
@@ -406,4 +446,42 @@ int Parameters_MMF_Get_N_Mode_Follow(State *state, int idx_image, int idx_chain)
         spirit_handle_exception_api(idx_image, idx_chain);
         return 0;
     }
+}
+
+bool Parameters_MMF_Get_Sparse(State *state, int idx_image, int idx_chain) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        return image->mmf_parameters->sparse;
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+        return false;
+    }
+}
+
+bool Parameters_MMF_Get_Matrix_Free(State *state, int idx_image, int idx_chain) noexcept
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        return image->mmf_parameters->matrix_free;
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+        return false;
+    }
 }
\ No newline at end of file
@@ -68,6 +68,39 @@ float Quantity_Get_Topological_Charge(State * state, int idx_image, int idx_chai
     }
 }
 
+float Quantity_Get_Topological_Charge_Density(State * state, float * charge_density, int idx_image, int idx_chain)
+{
+    try
+    {
+        std::shared_ptr<Data::Spin_System> image;
+        std::shared_ptr<Data::Spin_System_Chain> chain;
+
+        // Fetch correct indices and pointers
+        from_indices( state, idx_image, idx_chain, image, chain );
+
+        // image->Lock(); // Mutex locks in these functions may cause problems with the performance of UIs
+
+        scalarfield density(image->nos, 0);
+        scalar charge = 0;
+        int dimensionality = Geometry_Get_Dimensionality(state, idx_image, idx_chain);
+        if (dimensionality == 2)
+            charge = Engine::Vectormath::TopologicalChargeDensity(*image->spins,
+                *image->geometry, image->hamiltonian->boundary_conditions, density);
+
+        // image->Unlock();
+
+        for (int i=0; i<image->nos; ++i)
+            charge_density[i] = (float)density[i];
+
+        return (float)charge;
+    }
+    catch( ... )
+    {
+        spirit_handle_exception_api(idx_image, idx_chain);
+        return 0;
+    }
+}
+
 void check_modes(const vectorfield & image, const vectorfield & grad, const MatrixX & tangent_basis, const VectorX & eigenvalues, const MatrixX & eigenvectors_2N, const vectorfield & minimum_mode)
 {
     using namespace Engine;
@@ -210,19 +243,6 @@ void Quantity_Get_Grad_Force_MinimumMode(State * state, float * f_grad, float *
 
     // The Hessian (unprojected)
     system->hamiltonian->Hessian(image, hess);
-    // Remove blocks of pinned spins
-    #ifdef SPIRIT_ENABLE_PINNING
-        for (int i=0; i<nos; ++i)
-        {
-            for (int j=0; j<nos; ++j)
-            {
-                if ((!system->geometry->mask_unpinned[i]) || (!system->geometry->mask_unpinned[j]))
-                {
-                    hess.block<3,3>(3*i,3*j).setZero();
-                }
-            }
-        }
-    #endif // SPIRIT_ENABLE_PINNING
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -232,7 +252,7 @@ void Quantity_Get_Grad_Force_MinimumMode(State * state, float * f_grad, float *
     MatrixX basis_3Nx2N = MatrixX::Zero(3*nos, 2*nos);
     VectorX eigenvalues;
     MatrixX eigenvectors;
-    bool successful = Eigenmodes::Hessian_Partial_Spectrum(system->mmf_parameters, image, grad, hess, n_modes, basis_3Nx2N, hessian_final, eigenvalues, eigenvectors);
+    bool successful = Eigenmodes::Hessian_Partial_Spectrum(system->mmf_parameters, image, grad, system->geometry->mask_unpinned, hess, n_modes, basis_3Nx2N, hessian_final, eigenvalues, eigenvectors);
 
     if (successful)
     {
@@ -5,6 +5,7 @@
 #include <data/State.hpp>
 #include <engine/Method_LLG.hpp>
 #include <engine/Method_MC.hpp>
+#include <engine/Method_PT.hpp>
 #include <engine/Method_GNEB.hpp>
 #include <engine/Method_EMA.hpp>
 #include <engine/Method_MMF.hpp>
@@ -90,6 +91,61 @@ catch( ... )
     spirit_handle_exception_api(idx_image, idx_chain);
 }
 
+void Simulation_PT_Start(State *state,
+    int n_iterations, int n_iterations_log, bool singleshot, int idx_chain) noexcept
+try
+{
+    int idx_image = -1;
+
+    // Fetch correct indices and pointers for image and chain
+    std::shared_ptr<Data::Spin_System> image;
+    std::shared_ptr<Data::Spin_System_Chain> chain;
+
+    // Fetch correct indices and pointers
+    from_indices( state, idx_image, idx_chain, image, chain );
+
+    // Determine wether to stop or start a simulation
+    if (chain->iteration_allowed)
+    {
+        // Currently iterating chain
+        spirit_throw(Utility::Exception_Classifier::Unknown_Exception, Utility::Log_Level::Warning, fmt::format(
+            "Tried to use Simulation_PT_Start on chain {}, but there is already a simulation running.", idx_chain));
+    }
+    else if (Simulation_Running_Anywhere_On_Chain(state, idx_chain))
+    {
+        // Currently iterating an image of the chain
+        Log( Utility::Log_Level::Error, Utility::Log_Sender::API,
+                std::string( "There are still one or more simulations running on the specified chain!" ) +
+                std::string( " Please stop them before starting a parallel tempering calculation." ), -1, idx_chain );
+    }
+    else
+    {
+        // We are not iterating, so we create the Method and call Iterate
+        chain->Lock();
+
+        chain->iteration_allowed = true;
+        chain->singleshot_allowed = singleshot;
+
+        auto& parameters = chain->images[0]->mc_parameters;
+        if (n_iterations > 0)
+            parameters->n_iterations = n_iterations;
+        if (n_iterations_log > 0)
+            parameters->n_iterations_log = n_iterations_log;
+
+        auto method = std::shared_ptr<Engine::Method>(
+            new Engine::Method_PT( chain, idx_chain ) );
+
+        chain->Unlock();
+
+        state->method_chain = method;
+        run_method(method, singleshot);
+    }
+}
+catch( ... )
+{
+    spirit_handle_exception_api(-1, idx_chain);
+}
+
 void Simulation_LLG_Start(State *state, int solver_type,
     int n_iterations, int n_iterations_log, bool singleshot, int idx_image, int idx_chain) noexcept
 try
@@ -142,9 +198,15 @@ try
         else if (solver_type == int(Engine::Solver::RungeKutta4))
             method = std::shared_ptr<Engine::Method>(
                 new Engine::Method_LLG<Engine::Solver::RungeKutta4>( image, idx_image, idx_chain ) );
-        // else if (solver_type == int(Engine::Solver::NCG))
-        //     method = std::shared_ptr<Engine::Method>(
-        //         new Engine::Method_LLG<Engine::Solver::NCG>( image, idx_image, idx_chain ) );
+        else if (solver_type == int(Engine::Solver::RungeKutta23))
+            method = std::shared_ptr<Engine::Method>(
+                new Engine::Method_LLG<Engine::Solver::RungeKutta23>( image, idx_image, idx_chain ) );
+        else if (solver_type == int(Engine::Solver::NCG))
+            method = std::shared_ptr<Engine::Method>(
+                new Engine::Method_LLG<Engine::Solver::NCG>( image, idx_image, idx_chain ) );
+        else if (solver_type == int(Engine::Solver::BFGS))
+            method = std::shared_ptr<Engine::Method>(
+                new Engine::Method_LLG<Engine::Solver::BFGS>( image, idx_image, idx_chain ) );
         else if (solver_type == int(Engine::Solver::VP))
             method = std::shared_ptr<Engine::Method>(
                 new Engine::Method_LLG<Engine::Solver::VP>( image, idx_image, idx_chain ) );
@@ -231,6 +293,9 @@ try
             // else if (solver_type == int(Engine::Solver::NCG))
             //     method = std::shared_ptr<Engine::Method>(
             //         new Engine::Method_GNEB<Engine::Solver::NCG>( chain, idx_chain ) );
+            else if (solver_type == int(Engine::Solver::BFGS))
+                method = std::shared_ptr<Engine::Method>(
+                    new Engine::Method_GNEB<Engine::Solver::BFGS>( chain, idx_chain ) );
             else if (solver_type == int(Engine::Solver::VP))
                 method = std::shared_ptr<Engine::Method>(
                     new Engine::Method_GNEB<Engine::Solver::VP>( chain, idx_chain ) );
@@ -80,6 +80,18 @@ State * State_Setup(const char * config_file, bool quiet) noexcept
     }
     //------------------------------------------------------------------------------------------
 
+    //---------------------- Initialize the FFT ------------------------------------------------
+    try
+    {
+        // Read the FFTW wisdom file
+        IO::FFT_from_Config(state->config_file);
+    }
+    catch (...)
+    {
+        spirit_handle_exception_api(-1, -1);
+    }
+    //------------------------------------------------------------------------------------------
+
     //----------------------- Additional info log ----------------------------------------------
     try
     {
@@ -325,6 +337,12 @@ try
     // Log Parameters
     IO::Append_String_to_File("\n\n\n", cfg);
     IO::Log_Levels_to_Config(cfg);
+    // FFT Parameters
+    if( !Engine::FFT::Get_Wisdom_File().empty() )
+    {
+        IO::Append_String_to_File("\n\n\n", cfg);
+        IO::FFT_to_Config(cfg);
+    }
     // Geometry
     IO::Append_String_to_File("\n\n\n", cfg);
     IO::Geometry_to_Config(cfg, state->active_image->geometry);
@@ -76,6 +76,32 @@ namespace Data
         // For updates of triangulation and tetrahedra
         this->last_update_n_cell_step = -1;
         this->last_update_n_cells = intfield(3, -1);
+
+        // The triangles for the topological charge, initially for open boundary conditions
+        this->calculateCellTriangles();
+        this->_spin_triangles.boundary_conditions = intfield{ 0, 0, 0 };
+        this->_spin_triangles.triangles = std::make_shared<const std::vector<triangle_t>>(
+            this->calculateSpinTriangles(this->_spin_triangles.boundary_conditions) );
+    }
+
+    Geometry::Spin_Triangles::Spin_Triangles(const Spin_Triangles & other)
+    {
+        std::lock_guard<std::mutex> guard(other.mutex);
+        this->boundary_conditions = other.boundary_conditions;
+        this->triangles           = other.triangles;
+    }
+
+    Geometry::Spin_Triangles & Geometry::Spin_Triangles::operator=(const Spin_Triangles & other)
+    {
+        if( this != &other )
+        {
+            std::lock(this->mutex, other.mutex);
+            std::lock_guard<std::mutex> guard(this->mutex, std::adopt_lock);
+            std::lock_guard<std::mutex> guard_other(other.mutex, std::adopt_lock);
+            this->boundary_conditions = other.boundary_conditions;
+            this->triangles           = other.triangles;
+        }
+        return *this;
     }
 
     void Geometry::generatePositions()
@@ -374,6 +400,119 @@ namespace Data
         return _tetrahedra;
     }
 
+    std::shared_ptr<const std::vector<triangle_t>> Geometry::spin_triangles(const intfield & boundary_conditions) const
+    {
+        std::lock_guard<std::mutex> guard(this->_spin_triangles.mutex);
+
+        // The triangles only need to be rebuilt if the boundary conditions changed
+        if( this->_spin_triangles.boundary_conditions != boundary_conditions )
+        {
+            this->_spin_triangles.boundary_conditions = boundary_conditions;
+            this->_spin_triangles.triangles = std::make_shared<const std::vector<triangle_t>>(
+                this->calculateSpinTriangles(boundary_conditions) );
+        }
+        return this->_spin_triangles.triangles;
+    }
+
+    void Geometry::calculateCellTriangles()
+    {
+        // Only 2D systems have a topological charge
+        _cell_triangles.clear();
+        if( this->dimensionality != 2 )
+            return;
+
+        // This implementations assumes
+        // 1. No basis atom lies outside the cell spanned by the basis vectors of the lattice
+        // 2. The geometry is a plane in x and y and spanned by the first 2 basis_vectors of the lattice
+        // 3. The first basis atom lies at (0,0)
+
+        // Compute Delaunay for unitcell + basis with neighbouring lattice sites in directions a, b, and a+b
+        std::vector<vector2_t> basis_cell_points(n_cell_atoms + 3);
+        for( int i = 0; i < n_cell_atoms; i++ )
+        {
+            basis_cell_points[i].x = double(positions[i][0]);
+            basis_cell_points[i].y = double(positions[i][1]);
+        }
+
+        // To avoid cases where the basis atoms lie on the boundary of the convex hull the corners of the parallelogram
+        // spanned by the lattice sites 0, a, b and a+b are stretched away from the center for the triangulation
+        scalar stretch_factor = 0.1;
+
+        Vector3 ta = lattice_constant * bravais_vectors[0];
+        Vector3 tb = lattice_constant * bravais_vectors[1];
+
+        // basis_cell_points[0] coincides with the '0' lattice site (plus the position of the first basis atom)
+        basis_cell_points[0].x -= stretch_factor * (ta + tb)[0];
+        basis_cell_points[0].y -= stretch_factor * (ta + tb)[1];
+
+        // a+b
+        basis_cell_points[n_cell_atoms].x   = double((ta + tb + positions[0] + stretch_factor * (ta + tb))[0]);
+        basis_cell_points[n_cell_atoms].y   = double((ta + tb + positions[0] + stretch_factor * (ta + tb))[1]);
+        // b
+        basis_cell_points[n_cell_atoms+1].x = double((tb + positions[0] - stretch_factor * (ta - tb))[0]);
+        basis_cell_points[n_cell_atoms+1].y = double((tb + positions[0] - stretch_factor * (ta - tb))[1]);
+        // a
+        basis_cell_points[n_cell_atoms+2].x = double((ta + positions[0] + stretch_factor * (ta - tb))[0]);
+        basis_cell_points[n_cell_atoms+2].y = double((ta + positions[0] + stretch_factor * (ta - tb))[1]);
+
+        _cell_triangles = compute_delaunay_triangulation_2D(basis_cell_points);
+
+        // Orient all triangles counter-clockwise, so that the sign of the solid angle needs no correction
+        for( auto & tri : _cell_triangles )
+        {
+            auto & p0 = basis_cell_points[tri[0]];
+            auto & p1 = basis_cell_points[tri[1]];
+            auto & p2 = basis_cell_points[tri[2]];
+            if( (p1.x - p0.x) * (p2.y - p0.y) - (p1.y - p0.y) * (p2.x - p0.x) < 0 )
+                std::swap( tri[1], tri[2] );
+        }
+    }
+
+    std::vector<triangle_t> Geometry::calculateSpinTriangles(const intfield & boundary_conditions) const
+    {
+        // We apply the triangulation of the basis cell at each bravais-lattice point
+        // For each corner of the triangle we check wether it is "allowed" (which means either inside the simulation box or permitted by periodic boundary conditions)
+        std::vector<triangle_t> triangles;
+        triangles.reserve( _cell_triangles.size() * n_cells[0] * n_cells[1] );
+        for( int b = 0; b < n_cells[1]; ++b )
+        {
+            for( int a = 0; a < n_cells[0]; ++a )
+            {
+                // bools to check wether it is allowed to take the next lattice site in direction a, b or a+b
+                bool a_next_allowed = (a+1 < n_cells[0] || boundary_conditions[0]);
+                bool b_next_allowed = (b+1 < n_cells[1] || boundary_conditions[1]);
+                int a_next = (a + 1) % n_cells[0];
+                int b_next = (b + 1) % n_cells[1];
+
+                for( auto & tri : _cell_triangles )
+                {
+                    triangle_t spins;
+                    bool valid_triangle = true;
+                    for( int i = 0; i < 3; ++i )
+                    {
+                        if( tri[i] < n_cell_atoms ) // tri[i] is an index of a basis atom, no wrap around can occur
+                            spins[i] = tri[i] + a * n_cell_atoms + b * n_cell_atoms * n_cells[0];
+                        else if( tri[i] == n_cell_atoms + 2 && a_next_allowed ) // Translation by a
+                            spins[i] = a_next * n_cell_atoms + b * n_cell_atoms * n_cells[0];
+                        else if( tri[i] == n_cell_atoms + 1 && b_next_allowed ) // Translation by b
+                            spins[i] = a * n_cell_atoms + b_next * n_cell_atoms * n_cells[0];
+                        else if( tri[i] == n_cell_atoms && a_next_allowed && b_next_allowed ) // Translation by a + b
+                            spins[i] = a_next * n_cell_atoms + b_next * n_cell_atoms * n_cells[0];
+                        else // Translation not allowed, skip to next triangle
+                        {
+                            valid_triangle = false;
+                            break;
+                        }
+                    }
+                    if( valid_triangle )
+                        triangles.push_back(spins);
+                }
+            }
+        }
+
+        return triangles;
+    }
+
 
     std::vector<Vector3> Geometry::BravaisVectorsSC()
     {
@@ -5,6 +5,7 @@
 #include <Eigen/Dense>
 #include <Eigen/Eigenvalues>
 #include <SymEigsSolver.h>  // Also includes <MatOp/DenseSymMatProd.h>
+#include <MatOp/SparseSymMatProd.h>
 
 #include <fmt/format.h>
 #include <fmt/ostream.h>
@@ -16,6 +17,264 @@ namespace Engine
         using Utility::Log_Level;
         using Utility::Log_Sender;
 
+        // Remove the degrees of freedom of pinned spins from a constrained Hessian in the 2N tangent basis.
+        // Their interaction blocks are removed and their diagonal entries are set to a large value, so that
+        // their modes decouple from the rest and are moved to the upper end of the spectrum.
+        void Remove_Pinned(const intfield & mask_unpinned, MatrixX & hessian_constrained)
+        {
+            int nos = mask_unpinned.size();
+            for (int i=0; i<nos; ++i)
+            {
+                if (!mask_unpinned[i])
+                {
+                    // Remove interaction block
+                    hessian_constrained.middleRows(2*i, 2).setZero();
+                    hessian_constrained.middleCols(2*i, 2).setZero();
+                    // Set diagonal matrix entries of pinned spins to a large value
+                    hessian_constrained.block<2,2>(2*i,2*i).diagonal().setConstant(nos*1e5);
+                }
+            }
+        }
+
+        void Remove_Pinned(const intfield & mask_unpinned, SpMatrixX & hessian_constrained)
+        {
+            int nos = mask_unpinned.size();
+            // Remove interaction blocks
+            hessian_constrained.prune([&](const Eigen::Index & row, const Eigen::Index & col, const scalar &)
+                { return mask_unpinned[row/2] && mask_unpinned[col/2]; });
+            // Set diagonal matrix entries of pinned spins to a large value
+            for (int i=0; i<nos; ++i)
+            {
+                if (!mask_unpinned[i])
+                {
+                    hessian_constrained.coeffRef(2*i,   2*i)   = nos*1e5;
+                    hessian_constrained.coeffRef(2*i+1, 2*i+1) = nos*1e5;
+                }
+            }
+            hessian_constrained.makeCompressed();
+        }
+
+        // Transform approximate eigenvectors in 3N representation into the current tangent basis, for use
+        // as the initial subspace of Refine_Spectrum. As the constrained Hessians do not couple pinned spins
+        // to the others, their components are removed, so that the refinement works on the same operator
+        // as a calculation from scratch. Returns an empty matrix if the given modes do not fit the system.
+        template<typename BasisType>
+        MatrixX Initial_Subspace(const intfield & mask_unpinned, const BasisType & tangent_basis, const MatrixX & initial_modes)
+        {
+            int nos = mask_unpinned.size();
+            MatrixX initial_subspace;
+            if (initial_modes.cols() > 0 && initial_modes.rows() == 3*nos)
+            {
+                initial_subspace = tangent_basis.transpose() * initial_modes;
+                #ifdef SPIRIT_ENABLE_PINNING
+                    for (int i=0; i<nos; ++i)
+                    {
+                        if (!mask_unpinned[i])
+                            initial_subspace.middleRows(2*i, 2).setZero();
+                    }
+                #endif // SPIRIT_ENABLE_PINNING
+            }
+            return initial_subspace;
+        }
+
+        // Spectra matrix operation for the constrained Hessian T^T (H - diag(lambda)) T,
+        // where the product with H is calculated by the Hamiltonian without assembling it.
+        // Pinned spins are treated as in Remove_Pinned.
+        class Hessian_Constrained_Product
+        {
+        public:
+            Hessian_Constrained_Product(std::shared_ptr<Engine::Hamiltonian> hamiltonian,
+                const vectorfield & spins, const vectorfield & gradient, const intfield & mask_unpinned,
+                const SpMatrixX & tangent_basis) :
+                hamiltonian(hamiltonian), spins(spins), mask_unpinned(mask_unpinned), tangent_basis(tangent_basis),
+                nos(spins.size()), lambda(spins.size()), vec(spins.size()), result(spins.size())
+            {
+                // The Lagrange multipliers of the bordered Hessian
+                for (int i=0; i<nos; ++i)
+                    lambda[i] = spins[i].dot(gradient[i]);
+            }
+
+            int rows() const { return 2*nos; }
+            int cols() const { return 2*nos; }
+
+            // y_out = T^T (H - diag(lambda)) T x_in
+            void perform_op(scalar * x_in, scalar * y_out)
+            {
+                Eigen::Map<VectorX> x(x_in, 2*nos);
+                Eigen::Map<VectorX> y(y_out, 2*nos);
+
+                Eigen::Map<VectorX>(vec[0].data(), 3*nos) = tangent_basis * x;
+                #ifdef SPIRIT_ENABLE_PINNING
+                    Vectormath::set_c_a(1, vec, vec, mask_unpinned);
+                #endif // SPIRIT_ENABLE_PINNING
+                hamiltonian->Hessian_Vector_Product(spins, vec, result);
+                for (int i=0; i<nos; ++i)
+                    result[i] -= lambda[i] * vec[i];
+                y.noalias() = tangent_basis.transpose() * Eigen::Map<VectorX>(result[0].data(), 3*nos);
+                #ifdef SPIRIT_ENABLE_PINNING
+                    for (int i=0; i<nos; ++i)
+                    {
+                        if (!mask_unpinned[i])
+                            y.segment<2>(2*i) = nos*1e5 * x.segment<2>(2*i);
+                    }
+                #endif // SPIRIT_ENABLE_PINNING
+            }
+
+        private:
+            std::shared_ptr<Engine::Hamiltonian> hamiltonian;
+            const vectorfield & spins;
+            const intfield & mask_unpinned;
+            const SpMatrixX & tangent_basis;
+            int nos;
+            scalarfield lambda;
+            vectorfield vec;
+            vectorfield result;
+        };
+
+        // Orthonormalize the columns of W against the (orthonormal) columns of V and against each other,
+        // using two passes of Gram-Schmidt. Columns which are numerically linearly dependent are dropped.
+        // If AW is given, the same transformations are applied to it (using AV), so that AW = A*W holds.
+        void Orthonormalize(const MatrixX & V, const MatrixX * AV, MatrixX & W, MatrixX * AW)
+        {
+            int n_kept = 0;
+            for (int j=0; j<W.cols(); ++j)
+            {
+                scalar norm_initial = W.col(j).norm();
+                for (int pass=0; pass<2; ++pass)
+                {
+                    VectorX c = V.transpose() * W.col(j);
+                    W.col(j) -= V * c;
+                    if (AW) AW->col(j) -= (*AV) * c;
+
+                    VectorX d = W.leftCols(n_kept).transpose() * W.col(j);
+                    W.col(j) -= W.leftCols(n_kept) * d;
+                    if (AW) AW->col(j) -= AW->leftCols(n_kept) * d;
+                }
+
+                scalar norm = W.col(j).norm();
+                if (norm > 1e-8 * norm_initial && norm > 0)
+                {
+                    W.col(n_kept) = W.col(j) / norm;
+                    if (AW) AW->col(n_kept) = AW->col(j) / norm;
+                    ++n_kept;
+                }
+            }
+            W.conservativeResize(Eigen::NoChange, n_kept);
+            if (AW) AW->conservativeResize(Eigen::NoChange, n_kept);
+        }
+
+        // Apply a Spectra matrix operation to each column of W
+        template<typename OpType>
+        void Apply(OpType & op, MatrixX & W, MatrixX & AW)
+        {
+            AW.resize(W.rows(), W.cols());
+            for (int j=0; j<W.cols(); ++j)
+                op.perform_op(W.col(j).data(), AW.col(j).data());
+        }
+
+        // Refine a given subspace to the lowest n_modes eigenpairs of a symmetric matrix operation
+        // using the locally optimal block preconditioned conjugate gradient method (LOBPCG, without
+        // preconditioner). Each iteration needs n_modes matrix-vector products, so that only a few
+        // iterations are needed if the initial subspace is already close to the eigenvectors.
+        // Returns false if the residuals have not converged within the given number of iterations.
+        template<typename OpType>
+        bool Refine_Spectrum(OpType & op, int n_modes, const MatrixX & initial_subspace, int n_iterations, scalar tolerance,
+            VectorX & eigenvalues, MatrixX & eigenvectors)
+        {
+            int n = op.rows();
+            MatrixX X = initial_subspace, AX, P(n, 0), AP(n, 0), R, AR;
+
+            Orthonormalize(MatrixX(n, 0), nullptr, X, nullptr);
+            if (X.cols() < n_modes)
+                return false;
+            Apply(op, X, AX);
+
+            // Initial Rayleigh-Ritz step
+            MatrixX G = X.transpose() * AX;
+            Eigen::SelfAdjointEigenSolver<MatrixX> ritz(0.5 * (G + G.transpose()));
+            MatrixX Y  = ritz.eigenvectors().leftCols(n_modes);
+            eigenvalues = ritz.eigenvalues().head(n_modes);
+            X  = X * Y;
+            AX = AX * Y;
+            // The residuals are measured relative to the largest Ritz value encountered
+            scalar scale = ritz.eigenvalues().cwiseAbs().maxCoeff();
+
+            for (int iteration=0; iteration < n_iterations; ++iteration)
+            {
+                R = AX - X * eigenvalues.asDiagonal();
+
+                bool converged = true;
+                for (int j=0; j<n_modes; ++j)
+                    converged = converged && R.col(j).norm() <= tolerance * std::max(scale, scalar(1e-12));
+                if (converged)
+                {
+                    eigenvectors = X;
+                    return true;
+                }
+
+                // Orthonormal basis of the search space [X, P, R]
+                Orthonormalize(X, &AX, P, &AP);
+                MatrixX XP(n, X.cols() + P.cols());
+                XP.leftCols(X.cols())  = X;
+                XP.rightCols(P.cols()) = P;
+                Orthonormalize(XP, nullptr, R, nullptr);
+                Apply(op, R, AR);
+
+                int n_x = X.cols(), n_p = P.cols(), n_r = R.cols();
+                MatrixX S(n, n_x + n_p + n_r), AS(n, n_x + n_p + n_r);
+                S.leftCols(n_x)       = X;
+                S.middleCols(n_x, n_p) = P;
+                S.rightCols(n_r)      = R;
+                AS.leftCols(n_x)       = AX;
+                AS.middleCols(n_x, n_p) = AP;
+                AS.rightCols(n_r)      = AR;
+
+                // Rayleigh-Ritz step in the search space
+                G = S.transpose() * AS;
+                ritz.compute(0.5 * (G + G.transpose()));
+                Y = ritz.eigenvectors().leftCols(n_modes);
+                eigenvalues = ritz.eigenvalues().head(n_modes);
+                scale = std::max(scale, ritz.eigenvalues().cwiseAbs().maxCoeff());
+
+                // The new search directions are the components from P and R
+                P  = S.rightCols(n_p + n_r)  * Y.bottomRows(n_p + n_r);
+                AP = AS.rightCols(n_p + n_r) * Y.bottomRows(n_p + n_r);
+                X  = S  * Y;
+                AX = AS * Y;
+            }
+
+            return false;
+        }
+
+        // Calculate the lowest n_modes eigenpairs of a symmetric matrix operation.
+        // If an initial subspace is given, it is first refined iteratively to the same tolerance as
+        // the Spectra solver. If the residuals do not become small, the refined subspace is discarded
+        // and the Spectra solver is started from scratch.
+        template<typename OpType>
+        bool Partial_Spectrum(OpType & op, int n_modes, int ncv, const MatrixX & initial_subspace,
+            VectorX & eigenvalues, MatrixX & eigenvectors)
+        {
+            if (initial_subspace.cols() >= n_modes &&
+                Refine_Spectrum(op, n_modes, initial_subspace, 50, 1e-10, eigenvalues, eigenvectors))
+                return true;
+
+            // Create and initialize a Spectra solver
+            Spectra::SymEigsSolver< scalar, Spectra::SMALLEST_ALGE, OpType > hessian_spectrum(&op, n_modes, ncv);
+            hessian_spectrum.init();
+
+            // Compute the specified spectrum, sorted by smallest real eigenvalue
+            int nconv = hessian_spectrum.compute(1000, 1e-10, int(Spectra::SMALLEST_ALGE));
+
+            // Extract real eigenvalues
+            eigenvalues = hessian_spectrum.eigenvalues().real();
+
+            // Retrieve the real eigenvectors
+            eigenvectors = hessian_spectrum.eigenvectors().real();
+
+            // Return whether the calculation was successful
+            return (hessian_spectrum.info() == Spectra::SUCCESSFUL) && (nconv > 0);
+        }
+
         void Check_Eigenmode_Parameters(std::shared_ptr<Data::Spin_System> system)
         {
             int nos = system->nos;
@@ -58,30 +317,57 @@ namespace Engine
 
             // Calculate the Eigenmodes
             vectorfield gradient(nos);
-            MatrixX hessian(3*nos, 3*nos);
 
             // The gradient (unprojected)
             system->hamiltonian->Gradient(spins_initial, gradient);
             Vectormath::set_c_a(1, gradient, gradient, system->geometry->mask_unpinned);
 
-            // The Hessian (unprojected)
-            system->hamiltonian->Hessian(spins_initial, hessian);
-
-            // Get the eigenspectrum
-            MatrixX hessian_constrained = MatrixX::Zero(2*nos, 2*nos);
-            MatrixX tangent_basis = MatrixX::Zero(3*nos, 2*nos);
+            // Get the eigenspectrum and the modes in 3N representation
             VectorX eigenvalues;
             MatrixX eigenvectors;
-            bool successful = Eigenmodes::Hessian_Partial_Spectrum(system->ema_parameters, spins_initial, gradient, hessian, 
-                n_modes, tangent_basis, hessian_constrained, eigenvalues, eigenvectors);
+            MatrixX modes_3N;
+            bool successful;
+            if (system->ema_parameters->matrix_free)
+            {
+                SpMatrixX tangent_basis;
+                successful = Eigenmodes::Hessian_Partial_Spectrum_Matrix_Free(system->ema_parameters, spins_initial, gradient,
+                    system->geometry->mask_unpinned, system->hamiltonian, n_modes, tangent_basis, eigenvalues, eigenvectors);
+                if (successful)
+                    modes_3N = tangent_basis * eigenvectors;
+            }
+            else if (system->ema_parameters->sparse)
+            {
+                // The Hessian (unprojected)
+                SpMatrixX hessian;
+                system->hamiltonian->Sparse_Hessian(spins_initial, hessian);
+
+                SpMatrixX hessian_constrained, tangent_basis;
+                successful = Eigenmodes::Hessian_Partial_Spectrum(system->ema_parameters, spins_initial, gradient,
+                    system->geometry->mask_unpinned, hessian, n_modes, tangent_basis, hessian_constrained, eigenvalues, eigenvectors);
+                if (successful)
+                    modes_3N = tangent_basis * eigenvectors;
+            }
+            else
+            {
+                // The Hessian (unprojected)
+                MatrixX hessian(3*nos, 3*nos);
+                system->hamiltonian->Hessian(spins_initial, hessian);
+
+                MatrixX hessian_constrained = MatrixX::Zero(2*nos, 2*nos);
+                MatrixX tangent_basis = MatrixX::Zero(3*nos, 2*nos);
+                successful = Eigenmodes::Hessian_Partial_Spectrum(system->ema_parameters, spins_initial, gradient,
+                    system->geometry->mask_unpinned, hessian, n_modes, tangent_basis, hessian_constrained, eigenvalues, eigenvectors);
+                if (successful)
+                    modes_3N = tangent_basis * eigenvectors;
+            }
 
             if (successful)
             {
                 // get every mode and save it to system->modes
                 for (int i=0; i<n_modes; i++)
                 {
-                    // Extract the minimum mode (transform evec_lowest_2N back to 3N)
-                    VectorX evec_3N = tangent_basis * eigenvectors.col(i);
+                    // The mode transformed back to 3N
+                    VectorX evec_3N = modes_3N.col(i);
 
                     // dynamically allocate the system->modes
                     system->modes[i] = std::shared_ptr<vectorfield>(new vectorfield(nos, Vector3{1,0,0}));
@@ -110,7 +396,7 @@ namespace Engine
         }
         
         bool Hessian_Full_Spectrum(const std::shared_ptr<Data::Parameters_Method> parameters,
-            const vectorfield & spins, const vectorfield & gradient, const MatrixX & hessian,
+            const vectorfield & spins, const vectorfield & gradient, const intfield & mask_unpinned, const MatrixX & hessian,
             MatrixX & tangent_basis, MatrixX & hessian_constrained, VectorX & eigenvalues, MatrixX & eigenvectors)
         {
             int nos = spins.size();
@@ -124,6 +410,11 @@ namespace Engine
             // Manifoldmath::hessian_weingarten(spins, gradient, hessian, tangent_basis, hessian_constrained);
             // Manifoldmath::hessian_spherical(spins, gradient, hessian, tangent_basis, hessian_constrained);
             // Manifoldmath::hessian_covariant(spins, gradient, hessian, tangent_basis, hessian_constrained);
+
+            // Remove degrees of freedom of pinned spins
+            #ifdef SPIRIT_ENABLE_PINNING
+                Remove_Pinned(mask_unpinned, hessian_constrained);
+            #endif // SPIRIT_ENABLE_PINNING
             
             // Create and initialize a Eigen solver. Note: the hessian matrix should be symmetric!
             Eigen::SelfAdjointEigenSolver<MatrixX> hessian_spectrum(hessian_constrained);
@@ -138,8 +429,9 @@ namespace Engine
         }
 
         bool Hessian_Partial_Spectrum(const std::shared_ptr<Data::Parameters_Method> parameters,
-            const vectorfield & spins, const vectorfield & gradient, const MatrixX & hessian, int n_modes,
-            MatrixX & tangent_basis, MatrixX & hessian_constrained, VectorX & eigenvalues, MatrixX & eigenvectors)
+            const vectorfield & spins, const vectorfield & gradient, const intfield & mask_unpinned, const MatrixX & hessian, int n_modes,
+            MatrixX & tangent_basis, MatrixX & hessian_constrained, VectorX & eigenvalues, MatrixX & eigenvectors,
+            const MatrixX & initial_modes)
         {
             int nos = spins.size();
 
@@ -148,7 +440,7 @@ namespace Engine
 
             // If we have only one spin, we can only calculate the full spectrum
             if (n_modes == nos)
-                return Hessian_Full_Spectrum(parameters, spins, gradient, hessian, tangent_basis, hessian_constrained, eigenvalues, eigenvectors);
+                return Hessian_Full_Spectrum(parameters, spins, gradient, mask_unpinned, hessian, tangent_basis, hessian_constrained, eigenvalues, eigenvectors);
 
             // Calculate the final Hessian to use for the minimum mode
             // TODO: add option to choose different Hessian calculation
@@ -162,41 +454,86 @@ namespace Engine
             
             // Remove degrees of freedom of pinned spins
             #ifdef SPIRIT_ENABLE_PINNING
-                for (int i=0; i<nos; ++i)
-                {
-                    // TODO: pinning is now in Data::Geometry
-                    // if (!parameters->pinning->mask_unpinned[i])
-                    // {
-                    //     // Remove interaction block
-                    //     for (int j=0; j<nos; ++j)
-                    //     {
-                    //         hessian_constrained.block<2,2>(2*i,2*j).setZero();
-                    //         hessian_constrained.block<2,2>(2*j,2*i).setZero();
-                    //     }
-                    //     // Set diagonal matrix entries of pinned spins to a large value
-                    //     hessian_constrained.block<2,2>(2*i,2*i).setZero();
-                    //     hessian_constrained.block<2,2>(2*i,2*i).diagonal().setConstant(nos*1e5);
-                    // }
-                }
+                Remove_Pinned(mask_unpinned, hessian_constrained);
             #endif // SPIRIT_ENABLE_PINNING
 
+            // The initial guess in the current tangent basis
+            MatrixX initial_subspace = Initial_Subspace(mask_unpinned, tangent_basis, initial_modes);
+
             // Create the Spectra Matrix product operation
             Spectra::DenseSymMatProd<scalar> op(hessian_constrained);
-            // Create and initialize a Spectra solver
-            Spectra::SymEigsSolver< scalar, Spectra::SMALLEST_ALGE, Spectra::DenseSymMatProd<scalar> > hessian_spectrum(&op, n_modes, 2*nos);
-            hessian_spectrum.init();
+            return Partial_Spectrum(op, n_modes, 2*nos, initial_subspace, eigenvalues, eigenvectors);
+        }
 
-            // Compute the specified spectrum, sorted by smallest real eigenvalue
-            int nconv = hessian_spectrum.compute(1000, 1e-10, int(Spectra::SMALLEST_ALGE));
+        bool Hessian_Partial_Spectrum(const std::shared_ptr<Data::Parameters_Method> parameters,
+            const vectorfield & spins, const vectorfield & gradient, const intfield & mask_unpinned, const SpMatrixX & hessian, int n_modes,
+            SpMatrixX & tangent_basis, SpMatrixX & hessian_constrained, VectorX & eigenvalues, MatrixX & eigenvectors,
+            const MatrixX & initial_modes)
+        {
+            int nos = spins.size();
 
-            // Extract real eigenvalues
-            eigenvalues = hessian_spectrum.eigenvalues().real();
+            // Restrict number of calculated modes to [1,2N)
+            n_modes = std::max(1, std::min(2*nos-2, n_modes));
 
-            // Retrieve the real eigenvectors
-            eigenvectors = hessian_spectrum.eigenvectors().real();
+            // If we have only one spin, we can only calculate the full spectrum
+            if (n_modes == nos)
+            {
+                MatrixX tangent_basis_dense, hessian_constrained_dense;
+                bool successful = Hessian_Full_Spectrum(parameters, spins, gradient, mask_unpinned, MatrixX(hessian),
+                    tangent_basis_dense, hessian_constrained_dense, eigenvalues, eigenvectors);
+                tangent_basis       = tangent_basis_dense.sparseView();
+                hessian_constrained = hessian_constrained_dense.sparseView();
+                return successful;
+            }
 
-            // Return whether the calculation was successful
-            return (hessian_spectrum.info() == Spectra::SUCCESSFUL) && (nconv > 0);
+            // Calculate the final Hessian to use for the minimum mode
+            Manifoldmath::hessian_bordered(spins, gradient, hessian, tangent_basis, hessian_constrained);
+
+            // Remove degrees of freedom of pinned spins
+            #ifdef SPIRIT_ENABLE_PINNING
+                Remove_Pinned(mask_unpinned, hessian_constrained);
+            #endif // SPIRIT_ENABLE_PINNING
+
+            // The initial guess in the current tangent basis
+            MatrixX initial_subspace = Initial_Subspace(mask_unpinned, tangent_basis, initial_modes);
+
+            // Create the Spectra Matrix product operation
+            Spectra::SparseSymMatProd<scalar> op(hessian_constrained);
+            // The size of the Krylov subspace is kept small, as Spectra stores it as a dense 2N x ncv matrix
+            int ncv = std::min(2*nos, std::max(2*n_modes + 1, 20));
+            return Partial_Spectrum(op, n_modes, ncv, initial_subspace, eigenvalues, eigenvectors);
+        }
+
+        bool Hessian_Partial_Spectrum_Matrix_Free(const std::shared_ptr<Data::Parameters_Method> parameters,
+            const vectorfield & spins, const vectorfield & gradient, const intfield & mask_unpinned,
+            std::shared_ptr<Engine::Hamiltonian> hamiltonian, int n_modes,
+            SpMatrixX & tangent_basis, VectorX & eigenvalues, MatrixX & eigenvectors,
+            const MatrixX & initial_modes)
+        {
+            int nos = spins.size();
+
+            // Restrict number of calculated modes to [1,2N)
+            n_modes = std::max(1, std::min(2*nos-2, n_modes));
+
+            // If we have only one spin, we can only calculate the full spectrum
+            if (n_modes == nos)
+            {
+                SpMatrixX hessian, hessian_constrained;
+                hamiltonian->Sparse_Hessian(spins, hessian);
+                return Hessian_Partial_Spectrum(parameters, spins, gradient, mask_unpinned, hessian, n_modes, tangent_basis, hessian_constrained, eigenvalues, eigenvectors);
+            }
+
+            // The basis transformation matrix has only 6N non-zero entries
+            Manifoldmath::tangent_basis_spherical(spins, tangent_basis);
+
+            // The initial guess in the current tangent basis
+            MatrixX initial_subspace = Initial_Subspace(mask_unpinned, tangent_basis, initial_modes);
+
+            // Create the matrix-free operation
+            Hessian_Constrained_Product op(hamiltonian, spins, gradient, mask_unpinned, tangent_basis);
+            // The size of the Krylov subspace is kept small, as Spectra stores it as a dense 2N x ncv matrix
+            int ncv = std::min(2*nos, std::max(2*n_modes + 1, 20));
+            return Partial_Spectrum(op, n_modes, ncv, initial_subspace, eigenvalues, eigenvectors);
         }
     }
 }
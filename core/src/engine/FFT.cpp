@@ -2,14 +2,50 @@
 #include "FFT.hpp"
 #include <iostream>
 #include <vector>
+#include <map>
+#include <set>
+#include <tuple>
+#include <mutex>
 
 namespace Engine 
 {
     namespace FFT
     {
+        static std::string wisdom_file = "";
+        static std::mutex wisdom_file_mutex;
+
+        void Set_Wisdom_File(const std::string & file)
+        {
+            std::lock_guard<std::mutex> guard(wisdom_file_mutex);
+            wisdom_file = file;
+        }
+
+        std::string Get_Wisdom_File()
+        {
+            std::lock_guard<std::mutex> guard(wisdom_file_mutex);
+            return wisdom_file;
+        }
+
         //=== Functions for FFTW backend ===
         #ifdef SPIRIT_USE_FFTW
 
+        // Plans are shared between all FFT_Plan objects describing the same problem, so that identical
+        //      geometries do not need to be measured again. A plan is identified by the dimensions,
+        //      number of transforms, direction, alignment of the input and output arrays and number of threads,
+        //      as it can be executed on any arrays with the same alignment. The plans are reference counted
+        //      and destroyed when no FFT_Plan uses them anymore.
+        struct Shared_Plan
+        {
+            FFT_cfg cfg;
+            int n_users;
+        };
+        using Plan_Key = std::tuple<std::vector<int>, int, bool, int, int, int>;
+        static std::map<Plan_Key, Shared_Plan> plan_registry;
+        // The FFTW planner is not thread-safe
+        static std::mutex planner_mutex;
+        // Wisdom files which have already been imported
+        static std::set<std::string> imported_wisdom_files;
+
         //Dont need the single transforms because FFTW can do real batch transforms
         void Four_3D(const FFT_cfg & cfg, FFT_real_type * in, FFT_cpx_type * out)
         {
@@ -22,12 +58,12 @@ namespace Engine
 
         void batch_Four_3D(FFT_Plan & plan)
         {
-            FFTW_EXECUTE(plan.cfg);
+            FFTW_EXECUTE_DFT_R2C(plan.cfg, plan.real_ptr.data(), reinterpret_cast<FFTW_COMPLEX*>(plan.cpx_ptr.data()));
         }
 
         void batch_iFour_3D(FFT_Plan & plan)
         {
-            FFTW_EXECUTE(plan.cfg);
+            FFTW_EXECUTE_DFT_C2R(plan.cfg, reinterpret_cast<FFTW_COMPLEX*>(plan.cpx_ptr.data()), plan.real_ptr.data());
         }
 
         void FFT_Plan::Create_Configuration()
@@ -35,24 +71,79 @@ namespace Engine
             int rank = this->dims.size();
             int *n = this->dims.data();
             int n_transforms = this->n_transforms;
-            int istride = n_transforms, ostride = n_transforms;
-            int *inembed = n, *onembed = n;
-            
+
             int size = 1;
             for(auto k : dims)
                 size *= k;
 
-            int idist = 1, odist = 1;
-         
+            // The transforms are stored one after another, as with kissFFT. The complex arrays have the
+            //      default layout of the real FFT, i.e. only half of the last dimension is stored.
+            int istride = 1, ostride = 1;
+            int idist = size, odist = size;
+            int *inembed = nullptr, *onembed = nullptr;
+
+            int n_threads = 1;
+            #ifdef SPIRIT_USE_OPENMP
+            n_threads = omp_get_max_threads();
+            #endif
+
+            Plan_Key key(this->dims, n_transforms, this->inverse,
+                FFTW_ALIGNMENT_OF(this->real_ptr.data()),
+                FFTW_ALIGNMENT_OF(reinterpret_cast<FFT_real_type*>(this->cpx_ptr.data())),
+                n_threads);
+
+            std::lock_guard<std::mutex> guard(planner_mutex);
+
+            // Re-use an existing plan for the same problem
+            auto existing = plan_registry.find(key);
+            if( existing != plan_registry.end() )
+            {
+                this->cfg = existing->second.cfg;
+                ++existing->second.n_users;
+                return;
+            }
+
+            // Import the wisdom of previous runs, so that the measurement can be skipped
+            std::string wisdom_filename = Get_Wisdom_File();
+            if( !wisdom_filename.empty() )
+            {
+                wisdom_filename += std::string(".") + FFTW_PRECISION;
+                if( imported_wisdom_files.insert(wisdom_filename).second )
+                    FFTW_IMPORT_WISDOM_FROM_FILENAME(wisdom_filename.c_str());
+            }
+
             if(this->inverse == false)
                 this->cfg = FFTW_PLAN_MANY_DFT_R2C(rank, n, n_transforms, this->real_ptr.data(), inembed, istride, idist, reinterpret_cast<FFTW_COMPLEX*>(this->cpx_ptr.data()), onembed, ostride, odist, FFTW_MEASURE);
             else
                 this->cfg = FFTW_PLAN_MANY_DFT_C2R(rank, n, n_transforms, reinterpret_cast<FFTW_COMPLEX*>(this->cpx_ptr.data()), inembed, istride, idist, this->real_ptr.data(), onembed, ostride, odist, FFTW_MEASURE);
+
+            plan_registry[key] = Shared_Plan{ this->cfg, 1 };
+
+            // Store the accumulated wisdom for later runs
+            if( !wisdom_filename.empty() )
+                FFTW_EXPORT_WISDOM_TO_FILENAME(wisdom_filename.c_str());
         }
 
         void FFT_Plan::Free_Configuration()
         {
-            FFTW_DESTROY_PLAN(this->cfg);
+            if( this->cfg == nullptr )
+                return;
+
+            std::lock_guard<std::mutex> guard(planner_mutex);
+            for( auto it = plan_registry.begin(); it != plan_registry.end(); ++it )
+            {
+                if( it->second.cfg == this->cfg )
+                {
+                    // FFTW keeps the wisdom of a destroyed plan, so re-creating it does not need a new measurement
+                    if( --it->second.n_users == 0 )
+                    {
+                        FFTW_DESTROY_PLAN(it->second.cfg);
+                        plan_registry.erase(it);
+                    }
+                    break;
+                }
+            }
+            this->cfg = nullptr;
         }
 
         void FFT_Plan::Clean()
@@ -117,6 +208,7 @@ namespace Engine
         void FFT_Plan::Free_Configuration()
         {
             free(this->cfg);
+            this->cfg = nullptr;
         }
         #endif //end kiss_fft backend
     }
@@ -5,6 +5,18 @@ namespace Engine
 {
     namespace FFT
     {
+        static std::string wisdom_file = "";
+
+        void Set_Wisdom_File(const std::string & file)
+        {
+            wisdom_file = file;
+        }
+
+        std::string Get_Wisdom_File()
+        {
+            return wisdom_file;
+        }
+
         //Dont need the single transforms because cuFFT can do real batch transforms
         void Four_3D(FFT_cfg cfg, FFT_real_type * in, FFT_cpx_type * out)
         {
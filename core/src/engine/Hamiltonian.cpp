@@ -31,6 +31,31 @@ namespace Engine
         this->Hessian_FD(spins, hessian);
     }
 
+    void Hamiltonian::Sparse_Hessian(const vectorfield & spins, SpMatrixX & hessian)
+    {
+        int nos = spins.size();
+        MatrixX hessian_dense = MatrixX::Zero(3*nos, 3*nos);
+        this->Hessian(spins, hessian_dense);
+        hessian = hessian_dense.sparseView();
+    }
+
+    void Hamiltonian::Hessian_Vector_Product(const vectorfield & spins, const vectorfield & vec, vectorfield & result)
+    {
+        // H*v = ( g(s + delta*v) - g(s - delta*v) ) / (2*delta)
+        int nos = spins.size();
+        vectorfield spins_displaced = spins;
+        vectorfield gradient_minus(nos);
+
+        Vectormath::add_c_a(-this->delta, vec, spins_displaced);
+        this->Gradient(spins_displaced, gradient_minus);
+
+        Vectormath::add_c_a(2*this->delta, vec, spins_displaced);
+        this->Gradient(spins_displaced, result);
+
+        Vectormath::add_c_a(-1, gradient_minus, result);
+        Vectormath::scale(result, 1/(2*this->delta));
+    }
+
     void Hamiltonian::Hessian_FD(const vectorfield & spins, MatrixX & hessian)
     {
         // This is a regular finite difference implementation (probably not very efficient)
@@ -158,6 +183,36 @@ namespace Engine
             "Tried to use  Hamiltonian::Energy_Single_Spin() of the Hamiltonian base class!");
     }
 
+    scalar Hamiltonian::Energy_Single_Spin_Difference(int ispin, const Vector3 & spin_old, const Vector3 & spin_new, const vectorfield & spins)
+    {
+        vectorfield spins_temp = spins;
+
+        spins_temp[ispin] = spin_old;
+        scalar E_old = this->Energy_Single_Spin(ispin, spins_temp);
+
+        spins_temp[ispin] = spin_new;
+        scalar E_new = this->Energy_Single_Spin(ispin, spins_temp);
+
+        return E_new - E_old;
+    }
+
+    void Hamiltonian::Gradient_Batch(const std::vector<const vectorfield*> & spins, std::vector<vectorfield*> & gradients)
+    {
+        for( unsigned int img = 0; img < spins.size(); ++img )
+            this->Gradient(*spins[img], *gradients[img]);
+    }
+
+    bool Hamiltonian::Equivalent(const Hamiltonian & other)
+    {
+        return this == &other;
+    }
+
+    bool Hamiltonian::Interaction_Neighbours(field<intfield> & neighbours)
+    {
+        // In general we do not know the range of the interactions
+        return false;
+    }
+
     static const std::string name = "--";
     const std::string& Hamiltonian::Name()
     {
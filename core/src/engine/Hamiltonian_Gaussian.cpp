@@ -11,67 +11,153 @@ namespace Engine
     ) :
         Hamiltonian(intfield{false, false, false}), amplitude(amplitude), width(width), center(center)
     {
-        this->n_gaussians = amplitude.size();
         this->Update_Energy_Contributions();
     }
 
     void Hamiltonian_Gaussian::Update_Energy_Contributions()
     {
         this->energy_contributions_per_spin = { { "Gaussian", scalarfield(0) } };
+
+        // Constants of the kernels
+        this->n_gaussians = amplitude.size();
+        this->center_x = std::vector<scalar>(n_gaussians);
+        this->center_y = std::vector<scalar>(n_gaussians);
+        this->center_z = std::vector<scalar>(n_gaussians);
+        this->inverse_width_squared = std::vector<scalar>(n_gaussians);
+        for (int i = 0; i < this->n_gaussians; ++i)
+        {
+            this->center_x[i] = this->center[i][0];
+            this->center_y[i] = this->center[i][1];
+            this->center_z[i] = this->center[i][2];
+            this->inverse_width_squared[i] = 1 / (this->width[i] * this->width[i]);
+        }
+    }
+
+    scalar Hamiltonian_Gaussian::Energy_Spin(const Vector3 & spin)
+    {
+        const scalar * cx = this->center_x.data();
+        const scalar * cy = this->center_y.data();
+        const scalar * cz = this->center_z.data();
+        const scalar * a  = this->amplitude.data();
+        const scalar * w  = this->inverse_width_squared.data();
+        const scalar sx = spin[0], sy = spin[1], sz = spin[2];
+
+        scalar E = 0;
+        #pragma omp simd reduction(+:E)
+        for (int i = 0; i < this->n_gaussians; ++i)
+        {
+            // Distance between spin and gaussian center
+            scalar l = 1 - (cx[i]*sx + cy[i]*sy + cz[i]*sz);
+            E += a[i] * std::exp(-scalar(0.5) * l * l * w[i]);
+        }
+        return E;
+    }
+
+    Vector3 Hamiltonian_Gaussian::Gradient_Spin(const Vector3 & spin)
+    {
+        const scalar * cx = this->center_x.data();
+        const scalar * cy = this->center_y.data();
+        const scalar * cz = this->center_z.data();
+        const scalar * a  = this->amplitude.data();
+        const scalar * w  = this->inverse_width_squared.data();
+        const scalar sx = spin[0], sy = spin[1], sz = spin[2];
+
+        scalar gx = 0, gy = 0, gz = 0;
+        #pragma omp simd reduction(+:gx,gy,gz)
+        for (int i = 0; i < this->n_gaussians; ++i)
+        {
+            // Distance between spin and gaussian center
+            scalar l = 1 - (cx[i]*sx + cy[i]*sy + cz[i]*sz);
+            // dE/dl * dl/dm = - a exp(-l^2/(2 sigma^2)) l / sigma^2 * (-c)
+            scalar prefactor = a[i] * std::exp(-scalar(0.5) * l * l * w[i]) * l * w[i];
+            gx += prefactor * cx[i];
+            gy += prefactor * cy[i];
+            gz += prefactor * cz[i];
+        }
+        return { gx, gy, gz };
+    }
+
+    Matrix3 Hamiltonian_Gaussian::Hessian_Block(const Vector3 & spin)
+    {
+        const scalar * cx = this->center_x.data();
+        const scalar * cy = this->center_y.data();
+        const scalar * cz = this->center_z.data();
+        const scalar * a  = this->amplitude.data();
+        const scalar * w  = this->inverse_width_squared.data();
+        const scalar sx = spin[0], sy = spin[1], sz = spin[2];
+
+        // The block is symmetric, so only the upper triangle is calculated
+        scalar Hxx = 0, Hxy = 0, Hxz = 0, Hyy = 0, Hyz = 0, Hzz = 0;
+        #pragma omp simd reduction(+:Hxx,Hxy,Hxz,Hyy,Hyz,Hzz)
+        for (int i = 0; i < this->n_gaussians; ++i)
+        {
+            // Distance between spin and gaussian center
+            scalar l = 1 - (cx[i]*sx + cy[i]*sy + cz[i]*sz);
+            // Prefactor for all alpha, beta
+            scalar prefactor = a[i] * std::exp(-scalar(0.5) * l * l * w[i]) * w[i] * (l * l * w[i] - 1);
+            Hxx += prefactor * cx[i] * cx[i];
+            Hxy += prefactor * cx[i] * cy[i];
+            Hxz += prefactor * cx[i] * cz[i];
+            Hyy += prefactor * cy[i] * cy[i];
+            Hyz += prefactor * cy[i] * cz[i];
+            Hzz += prefactor * cz[i] * cz[i];
+        }
+
+        Matrix3 block;
+        block << Hxx, Hxy, Hxz,
+                 Hxy, Hyy, Hyz,
+                 Hxz, Hyz, Hzz;
+        return block;
     }
 
     void Hamiltonian_Gaussian::Hessian(const vectorfield & spins, MatrixX & hessian)
     {
         int nos = spins.size();
+
+        // Only the blocks on the diagonal are non-zero
+        hessian.setZero();
+        #pragma omp parallel for
+        for (int ispin = 0; ispin < nos; ++ispin)
+            hessian.block<3,3>(3*ispin, 3*ispin) = this->Hessian_Block(spins[ispin]);
+    }
+
+    void Hamiltonian_Gaussian::Sparse_Hessian(const vectorfield & spins, SpMatrixX & hessian)
+    {
+        int nos = spins.size();
+
+        // Each spin has its own nine entries in the list of triplets, so it can be filled in parallel
+        std::vector<SpTriplet> triplets(9*nos);
+        #pragma omp parallel for
         for (int ispin = 0; ispin < nos; ++ispin)
         {
-            // Set Hessian to zero
-            hessian.setZero();
-            // Calculate Hessian
-            for (int igauss = 0; igauss < this->n_gaussians; ++igauss)
+            Matrix3 block = this->Hessian_Block(spins[ispin]);
+            for (int alpha = 0; alpha < 3; ++alpha)
             {
-                // Distance between spin and gaussian center
-                scalar l = 1 - this->center[igauss].dot(spins[ispin]);
-                // Prefactor for all alpha, beta
-                scalar prefactor = this->amplitude[igauss] * std::exp(-std::pow(l, 2) / (2.0*std::pow(this->width[igauss], 2)))
-                    / std::pow(this->width[igauss], 2)
-                    * (std::pow(l, 2) / std::pow(this->width[igauss], 2) - 1);
-                // Effective Field contribution
-                for (int alpha = 0; alpha < 3; ++alpha)
-                {
-                    for (int beta = 0; beta < 3; ++beta)
-                    {
-                        int i = 3 * ispin + alpha;
-                        int j = 3 * ispin + beta;
-                        hessian(i,j) += prefactor * this->center[igauss][alpha] * this->center[igauss][beta];
-                    }
-                }
+                for (int beta = 0; beta < 3; ++beta)
+                    triplets[9*ispin + 3*alpha + beta] = SpTriplet(3*ispin + alpha, 3*ispin + beta, block(alpha, beta));
             }
         }
+
+        hessian.resize(3*nos, 3*nos);
+        hessian.setFromTriplets(triplets.begin(), triplets.end());
+    }
+
+    void Hamiltonian_Gaussian::Hessian_Vector_Product(const vectorfield & spins, const vectorfield & vec, vectorfield & result)
+    {
+        int nos = spins.size();
+
+        #pragma omp parallel for
+        for (int ispin = 0; ispin < nos; ++ispin)
+            result[ispin] = this->Hessian_Block(spins[ispin]) * vec[ispin];
     }
 
     void Hamiltonian_Gaussian::Gradient(const vectorfield & spins, vectorfield & gradient)
     {
         int nos = spins.size();
 
+        #pragma omp parallel for
         for (int ispin = 0; ispin < nos; ++ispin)
-        {
-            // Set gradient to zero
-            gradient[ispin] = { 0,0,0 };
-            // Calculate gradient
-            for (int i = 0; i < this->n_gaussians; ++i)
-            {
-                // Distance between spin and gaussian center
-                scalar l = 1 - this->center[i].dot(spins[ispin]); //Utility::Manifoldmath::Dist_Greatcircle(this->center[i], n);
-                // Scalar product of spin and gaussian center
-                //scalar nc = 0;
-                //for (int dim = 0; dim < 3; ++dim) nc += spins[ispin + dim*nos] * this->center[i][dim];
-                // Prefactor
-                scalar prefactor = this->amplitude[i] * std::exp(-std::pow(l, 2) / (2.0*std::pow(this->width[i], 2))) * l / std::pow(this->width[i],2);
-                // Gradient contribution
-                gradient[ispin] += prefactor * this->center[i];
-            }
-        }
+            gradient[ispin] = this->Gradient_Spin(spins[ispin]);
     }
 
     void Hamiltonian_Gaussian::Energy_Contributions_per_Spin(const vectorfield & spins, std::vector<std::pair<std::string, scalarfield>> & contributions)
@@ -79,34 +165,23 @@ namespace Engine
         int nos = spins.size();
 
         // Allocate if not already allocated
-        if (this->energy_contributions_per_spin[0].second.size() != nos) this->energy_contributions_per_spin = { { "Gaussian", scalarfield(nos,0) } };
-
-        // Set to zero
-        for (auto& pair : energy_contributions_per_spin) Vectormath::fill(pair.second, 0);
+        if (contributions.size() != 1 || contributions[0].second.size() != nos)
+            contributions = { { "Gaussian", scalarfield(nos, 0) } };
 
-        for (int i = 0; i < this->n_gaussians; ++i)
-        {
-            for (int ispin = 0; ispin < nos; ++ispin)
-            {
-                // Distance between spin and gaussian center
-                scalar l = 1 - this->center[i].dot(spins[ispin]); //Utility::Manifoldmath::Dist_Greatcircle(this->center[i], n);
-                // Energy contribution
-                this->energy_contributions_per_spin[0].second[ispin] += this->amplitude[i] * std::exp(-std::pow(l, 2) / (2.0*std::pow(this->width[i], 2)));
-            }
-        }
+        auto & energy = contributions[0].second;
+        #pragma omp parallel for
+        for (int ispin = 0; ispin < nos; ++ispin)
+            energy[ispin] = this->Energy_Spin(spins[ispin]);
     }
 
     scalar Hamiltonian_Gaussian::Energy_Single_Spin(int ispin, const vectorfield & spins)
     {
-        scalar Energy = 0;
-        for (int i = 0; i < this->n_gaussians; ++i)
-        {
-            // Distance between spin and gaussian center
-            scalar l = 1 - this->center[i].dot(spins[ispin]); //Utility::Manifoldmath::Dist_Greatcircle(this->center[i], n);
-            // Energy contribution
-            this->energy_contributions_per_spin[0].second[ispin] += this->amplitude[i] * std::exp(-std::pow(l, 2) / (2.0*std::pow(this->width[i], 2)));
-        }
-        return Energy;
+        return this->Energy_Spin(spins[ispin]);
+    }
+
+    scalar Hamiltonian_Gaussian::Energy_Single_Spin_Difference(int ispin, const Vector3 & spin_old, const Vector3 & spin_new, const vectorfield & spins)
+    {
+        return this->Energy_Spin(spin_new) - this->Energy_Spin(spin_old);
     }
 
     // Hamiltonian name as string
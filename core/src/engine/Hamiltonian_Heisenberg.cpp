@@ -6,10 +6,15 @@
 #include <data/Spin_System.hpp>
 #include <utility/Constants.hpp>
 #include <algorithm>
+#include <mutex>
 
 #include <Eigen/Dense>
 #include <Eigen/Core>
 
+#ifdef SPIRIT_USE_OPENMP
+#include <omp.h>
+#endif
+
 
 using namespace Data;
 using namespace Utility;
@@ -27,7 +32,7 @@ namespace Engine
         intfield anisotropy_indices, scalarfield anisotropy_magnitudes, vectorfield anisotropy_normals,
         pairfield exchange_pairs, scalarfield exchange_magnitudes,
         pairfield dmi_pairs, scalarfield dmi_magnitudes, vectorfield dmi_normals,
-        DDI_Method ddi_method, intfield ddi_n_periodic_images, scalar ddi_radius,
+        DDI_Method ddi_method, intfield ddi_n_periodic_images, scalar ddi_radius, scalar ddi_theta,
         quadrupletfield quadruplets, scalarfield quadruplet_magnitudes,
         std::shared_ptr<Data::Geometry> geometry,
         intfield boundary_conditions
@@ -39,7 +44,7 @@ namespace Engine
         exchange_pairs_in(exchange_pairs), exchange_magnitudes_in(exchange_magnitudes), exchange_shell_magnitudes(0),
         dmi_pairs_in(dmi_pairs), dmi_magnitudes_in(dmi_magnitudes), dmi_normals_in(dmi_normals), dmi_shell_magnitudes(0), dmi_shell_chirality(0),
         quadruplets(quadruplets), quadruplet_magnitudes(quadruplet_magnitudes),
-        ddi_method(ddi_method), ddi_n_periodic_images(ddi_n_periodic_images), ddi_cutoff_radius(ddi_radius),
+        ddi_method(ddi_method), ddi_n_periodic_images(ddi_n_periodic_images), ddi_cutoff_radius(ddi_radius), ddi_theta(ddi_theta),
         fft_plan_reverse(FFT::FFT_Plan()), fft_plan_spins(FFT::FFT_Plan())
     {
         // Generate interaction pairs, constants etc.
@@ -52,7 +57,7 @@ namespace Engine
         intfield anisotropy_indices, scalarfield anisotropy_magnitudes, vectorfield anisotropy_normals,
         scalarfield exchange_shell_magnitudes,
         scalarfield dmi_shell_magnitudes, int dm_chirality,
-        DDI_Method ddi_method, intfield ddi_n_periodic_images, scalar ddi_radius,
+        DDI_Method ddi_method, intfield ddi_n_periodic_images, scalar ddi_radius, scalar ddi_theta,
         quadrupletfield quadruplets, scalarfield quadruplet_magnitudes,
         std::shared_ptr<Data::Geometry> geometry,
         intfield boundary_conditions
@@ -64,7 +69,7 @@ namespace Engine
         exchange_pairs_in(0), exchange_magnitudes_in(0), exchange_shell_magnitudes(exchange_shell_magnitudes),
         dmi_pairs_in(0), dmi_magnitudes_in(0), dmi_normals_in(0), dmi_shell_magnitudes(dmi_shell_magnitudes), dmi_shell_chirality(dm_chirality),
         quadruplets(quadruplets), quadruplet_magnitudes(quadruplet_magnitudes),
-        ddi_method(ddi_method), ddi_n_periodic_images(ddi_n_periodic_images), ddi_cutoff_radius(ddi_radius),
+        ddi_method(ddi_method), ddi_n_periodic_images(ddi_n_periodic_images), ddi_cutoff_radius(ddi_radius), ddi_theta(ddi_theta),
         fft_plan_reverse(FFT::FFT_Plan()), fft_plan_spins(FFT::FFT_Plan())
 
     {
@@ -146,6 +151,10 @@ namespace Engine
             }
         }
 
+        // Neighbour tables of the pair interactions
+        this->Build_Pair_Table(this->exchange_pairs, use_redundant_neighbours, this->exchange_table);
+        this->Build_Pair_Table(this->dmi_pairs,      use_redundant_neighbours, this->dmi_table);
+
         // Dipole-dipole (cutoff)
         scalar radius = this->ddi_cutoff_radius;
         if( this->ddi_method != DDI_Method::Cutoff )
@@ -153,21 +162,156 @@ namespace Engine
         this->ddi_pairs      = Engine::Neighbours::Get_Pairs_in_Radius(*this->geometry, radius);
         this->ddi_magnitudes = scalarfield(this->ddi_pairs.size());
         this->ddi_normals    = vectorfield(this->ddi_pairs.size());
+        this->ddi_tensors    = field<Matrix3>(this->ddi_pairs.size());
 
+        // The translations are in Angstrom, so the |r|[m] becomes |r|[m]*10^-10
+        const scalar mult = C::mu_0 * C::mu_B * C::mu_B / ( 4*C::Pi * 1e-30 );
         for( unsigned int i = 0; i < this->ddi_pairs.size(); ++i )
         {
             Engine::Neighbours::DDI_from_Pair(
                 *this->geometry,
                 { this->ddi_pairs[i].i, this->ddi_pairs[i].j, this->ddi_pairs[i].translations },
                 this->ddi_magnitudes[i], this->ddi_normals[i]);
+
+            const Vector3 & n = this->ddi_normals[i];
+            if( this->ddi_magnitudes[i] > 0.0 )
+                this->ddi_tensors[i] = mult / std::pow(this->ddi_magnitudes[i], 3.0) * (3 * n * n.transpose() - Matrix3::Identity());
+            else
+                this->ddi_tensors[i] = Matrix3::Zero();
         }
+        // The pairs in a radius contain both orientations of each pair
+        this->Build_Pair_Table(this->ddi_pairs, true, this->ddi_table);
         // Dipole-dipole
         this->Prepare_DDI();
+        this->Prepare_DDI_Tree();
+
+        // Quadruplets
+        this->quadruplet_basis_index = field<intfield>(geometry->n_cell_atoms);
+        for( int iquad = 0; iquad < quadruplets.size(); ++iquad )
+        {
+            const auto& q = quadruplets[iquad];
+            const int basis[4] = { q.i, q.j, q.k, q.l };
+            for( int position = 0; position < 4; ++position )
+                this->quadruplet_basis_index[basis[position]].push_back(4*iquad + position);
+        }
 
         // Update, which terms still contribute
         this->Update_Energy_Contributions();
     }
 
+    // Look up an object with the given signature in a cache of shared objects, removing expired entries on the way
+    template<typename T, typename Signature>
+    static std::shared_ptr<T> Find_Cached(std::vector<std::weak_ptr<T>> & cache, const Signature & signature)
+    {
+        cache.erase(std::remove_if(cache.begin(), cache.end(),
+            [](const std::weak_ptr<T> & entry) { return entry.expired(); }), cache.end());
+        for( auto& entry : cache )
+        {
+            auto object = entry.lock();
+            if( object && object->signature == signature )
+                return object;
+        }
+        return nullptr;
+    }
+
+    // Cache of the neighbour tables which are currently in use
+    static std::vector<std::weak_ptr<const Pair_Table>> pair_table_cache;
+    static std::mutex pair_table_cache_mutex;
+
+    void Hamiltonian_Heisenberg::Build_Pair_Table(const pairfield & pairs, bool use_redundant_neighbours, std::shared_ptr<const Pair_Table> & table_out)
+    {
+        const int nos     = geometry->nos;
+        const int N       = geometry->n_cell_atoms;
+        const int n_pairs = pairs.size();
+
+        // Everything the table depends on
+        intfield signature = { int(use_redundant_neighbours), N, nos,
+            geometry->n_cells[0], geometry->n_cells[1], geometry->n_cells[2],
+            boundary_conditions[0], boundary_conditions[1], boundary_conditions[2] };
+        for( auto& pair : pairs )
+            signature.insert(signature.end(), { pair.i, pair.j, pair.translations[0], pair.translations[1], pair.translations[2] });
+        signature.insert(signature.end(), geometry->atom_types.begin(), geometry->atom_types.end());
+
+        // Re-use the table of another Hamiltonian with the same pairs and geometry, if there is one
+        std::lock_guard<std::mutex> guard(pair_table_cache_mutex);
+        if( table_out && table_out->signature == signature )
+            return;
+        auto cached = Find_Cached(pair_table_cache, signature);
+        if( cached )
+        {
+            table_out = cached;
+            return;
+        }
+
+        auto new_table = std::make_shared<Pair_Table>();
+        auto& table = *new_table;
+        table.signature = signature;
+
+        // Resolve the partner index of every pair in every cell (this is the expensive part)
+        intfield jspins(geometry->n_cells_total * n_pairs);
+        #pragma omp parallel for
+        for( int icell = 0; icell < geometry->n_cells_total; ++icell )
+        {
+            for( int i_pair = 0; i_pair < n_pairs; ++i_pair )
+            {
+                int ispin = pairs[i_pair].i + icell*N;
+                jspins[icell*n_pairs + i_pair] = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, N, geometry->atom_types, pairs[i_pair]);
+            }
+        }
+
+        // Count the number of entries per spin. If the pairs are unique,
+        // the inverted pair has to be stored for the partner spin as well.
+        table.row_ptr = intfield(nos + 1, 0);
+        for( int icell = 0; icell < geometry->n_cells_total; ++icell )
+        {
+            for( int i_pair = 0; i_pair < n_pairs; ++i_pair )
+            {
+                int ispin = pairs[i_pair].i + icell*N;
+                int jspin = jspins[icell*n_pairs + i_pair];
+                if( jspin >= 0 )
+                {
+                    ++table.row_ptr[ispin + 1];
+                    if( !use_redundant_neighbours )
+                        ++table.row_ptr[jspin + 1];
+                }
+            }
+        }
+        for( int ispin = 0; ispin < nos; ++ispin )
+            table.row_ptr[ispin + 1] += table.row_ptr[ispin];
+
+        // Fill the entries
+        int n_entries     = table.row_ptr[nos];
+        table.jspin       = intfield(n_entries);
+        table.ipair       = intfield(n_entries);
+        table.orientation = scalarfield(n_entries);
+        intfield position(table.row_ptr.begin(), table.row_ptr.end() - 1);
+        for( int icell = 0; icell < geometry->n_cells_total; ++icell )
+        {
+            for( int i_pair = 0; i_pair < n_pairs; ++i_pair )
+            {
+                int ispin = pairs[i_pair].i + icell*N;
+                int jspin = jspins[icell*n_pairs + i_pair];
+                if( jspin >= 0 )
+                {
+                    int idx = position[ispin]++;
+                    table.jspin[idx]       = jspin;
+                    table.ipair[idx]       = i_pair;
+                    table.orientation[idx] = 1;
+                    if( !use_redundant_neighbours )
+                    {
+                        idx = position[jspin]++;
+                        table.jspin[idx]       = ispin;
+                        table.ipair[idx]       = i_pair;
+                        table.orientation[idx] = -1;
+                    }
+                }
+            }
+        }
+
+        pair_table_cache.push_back(new_table);
+        table_out = new_table;
+    }
+
     void Hamiltonian_Heisenberg::Update_Energy_Contributions()
     {
         this->energy_contributions_per_spin = std::vector<std::pair<std::string, scalarfield>>(0);
@@ -283,40 +427,31 @@ namespace Engine
 
     void Hamiltonian_Heisenberg::E_Exchange(const vectorfield & spins, scalarfield & Energy)
     {
+        const auto& table = *this->exchange_table;
+
         #pragma omp parallel for
-        for( unsigned int icell = 0; icell < geometry->n_cells_total; ++icell )
+        for( int ispin = 0; ispin < geometry->nos; ++ispin )
         {
-            for( unsigned int i_pair = 0; i_pair < exchange_pairs.size(); ++i_pair )
+            for( int idx = table.row_ptr[ispin]; idx < table.row_ptr[ispin + 1]; ++idx )
             {
-                int ispin = exchange_pairs[i_pair].i + icell*geometry->n_cell_atoms;
-                int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, exchange_pairs[i_pair]);
-                if( jspin >= 0 )
-                {
-                    Energy[ispin] -= 0.5 * exchange_magnitudes[i_pair] * spins[ispin].dot(spins[jspin]);
-                    #ifndef SPIRIT_USE_OPENMP
-                    Energy[jspin] -= 0.5 * exchange_magnitudes[i_pair] * spins[ispin].dot(spins[jspin]);
-                    #endif
-                }
+                int jspin = table.jspin[idx];
+                Energy[ispin] -= 0.5 * exchange_magnitudes[table.ipair[idx]] * spins[ispin].dot(spins[jspin]);
             }
         }
     }
 
     void Hamiltonian_Heisenberg::E_DMI(const vectorfield & spins, scalarfield & Energy)
     {
+        const auto& table = *this->dmi_table;
+
         #pragma omp parallel for
-        for( unsigned int icell = 0; icell < geometry->n_cells_total; ++icell )
+        for( int ispin = 0; ispin < geometry->nos; ++ispin )
         {
-            for( unsigned int i_pair = 0; i_pair < dmi_pairs.size(); ++i_pair )
+            for( int idx = table.row_ptr[ispin]; idx < table.row_ptr[ispin + 1]; ++idx )
             {
-                int ispin = dmi_pairs[i_pair].i + icell*geometry->n_cell_atoms;
-                int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, dmi_pairs[i_pair]);
-                if( jspin >= 0 )
-                {
-                    Energy[ispin] -= 0.5 * dmi_magnitudes[i_pair] * dmi_normals[i_pair].dot(spins[ispin].cross(spins[jspin]));
-                    #ifndef SPIRIT_USE_OPENMP
-                    Energy[jspin] -= 0.5 * dmi_magnitudes[i_pair] * dmi_normals[i_pair].dot(spins[ispin].cross(spins[jspin]));
-                    #endif
-                }
+                int jspin  = table.jspin[idx];
+                int i_pair = table.ipair[idx];
+                Energy[ispin] -= 0.5 * table.orientation[idx] * dmi_magnitudes[i_pair] * dmi_normals[i_pair].dot(spins[ispin].cross(spins[jspin]));
             }
         }
     }
@@ -325,6 +460,8 @@ namespace Engine
     {
         if( this->ddi_method == DDI_Method::FFT )
             this->E_DDI_FFT(spins, Energy);
+        else if( this->ddi_method == DDI_Method::FMM )
+            this->E_DDI_Tree(spins, Energy);
         else if( this->ddi_method == DDI_Method::Cutoff )
         {
             // TODO: Merge these implementations in the future
@@ -347,37 +484,28 @@ namespace Engine
             Energy[ispin] += 0.5 * spins[ispin].dot(gradients_temp[ispin]);
     }
 
-    void Hamiltonian_Heisenberg::E_DDI_Cutoff(const vectorfield & spins, scalarfield & Energy)
+    void Hamiltonian_Heisenberg::E_DDI_Tree(const vectorfield & spins, scalarfield & Energy)
     {
-        auto& mu_s = this->geometry->mu_s;
-        // The translations are in angstr�m, so the |r|[m] becomes |r|[m]*10^-10
-        const scalar mult = C::mu_0 * std::pow(C::mu_B, 2) / ( 4*C::Pi * 1e-30 );
+        vectorfield gradients_temp(geometry->nos, Vector3::Zero());
+        this->Gradient_DDI_Tree(spins, gradients_temp);
 
-        scalar result = 0.0;
+        #pragma omp parallel for
+        for( int ispin = 0; ispin < geometry->nos; ispin++ )
+            Energy[ispin] += 0.5 * spins[ispin].dot(gradients_temp[ispin]);
+    }
 
-        for( unsigned int i_pair = 0; i_pair < ddi_pairs.size(); ++i_pair )
+    void Hamiltonian_Heisenberg::E_DDI_Cutoff(const vectorfield & spins, scalarfield & Energy)
+    {
+        const auto& mu_s  = this->geometry->mu_s;
+        const auto& table = *this->ddi_table;
+
+        #pragma omp parallel for
+        for( int ispin = 0; ispin < geometry->nos; ++ispin )
         {
-            if( ddi_magnitudes[i_pair] > 0.0 )
+            for( int idx = table.row_ptr[ispin]; idx < table.row_ptr[ispin + 1]; ++idx )
             {
-                for( int da = 0; da < geometry->n_cells[0]; ++da )
-                {
-                    for( int db = 0; db < geometry->n_cells[1]; ++db )
-                    {
-                        for( int dc = 0; dc < geometry->n_cells[2]; ++dc )
-                        {
-                            std::array<int, 3 > translations = { da, db, dc };
-                            int i = ddi_pairs[i_pair].i;
-                            int j = ddi_pairs[i_pair].j;
-                            int ispin = i + Vectormath::idx_from_translations(geometry->n_cells, geometry->n_cell_atoms, translations);
-                            int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, ddi_pairs[i_pair]);
-                            if( jspin >= 0 )
-                            {
-                                Energy[ispin] -= 0.5 * mu_s[ispin] * mu_s[jspin] * mult / std::pow(ddi_magnitudes[i_pair], 3.0) *
-                                    (3 * spins[ispin].dot(ddi_normals[i_pair]) * spins[jspin].dot(ddi_normals[i_pair]) - spins[ispin].dot(spins[jspin]));
-                            }
-                        }
-                    }
-                }
+                int jspin = table.jspin[idx];
+                Energy[ispin] -= 0.5 * mu_s[ispin] * mu_s[jspin] * spins[ispin].dot(ddi_tensors[table.ipair[idx]] * spins[jspin]);
             }
         }
     }// end DipoleDipole
@@ -460,7 +588,6 @@ namespace Engine
             int icell  = ispin / this->geometry->n_cell_atoms;
             int ibasis = ispin - icell*this->geometry->n_cell_atoms;
             auto& mu_s = this->geometry->mu_s;
-            Pair pair_inv;
 
             // External field
             if( this->idx_zeeman >= 0 )
@@ -482,50 +609,19 @@ namespace Engine
             // Exchange
             if( this->idx_exchange >= 0 )
             {
-                for( unsigned int ipair = 0; ipair < exchange_pairs.size(); ++ipair )
-                {
-                    const auto& pair = exchange_pairs[ipair];
-                    if( pair.i == ibasis )
-                    {
-                        int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, pair);
-                        if (jspin >= 0)
-                            Energy -= this->exchange_magnitudes[ipair] * spins[ispin].dot(spins[jspin]);
-                    }
-                    #ifndef SPIRIT_USE_OPENMP
-                    if( pair.j == ibasis )
-                    {
-                        const auto& t = pair.translations;
-                        pair_inv = Pair{pair.j, pair.i, {-t[0], -t[1], -t[2]}};
-                        int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, pair_inv);
-                        if( jspin >= 0 )
-                            Energy -= this->exchange_magnitudes[ipair] * spins[ispin].dot(spins[jspin]);
-                    }
-                    #endif
-                }
+                const auto& table = *this->exchange_table;
+                for( int idx = table.row_ptr[ispin]; idx < table.row_ptr[ispin + 1]; ++idx )
+                    Energy -= this->exchange_magnitudes[table.ipair[idx]] * spins[ispin].dot(spins[table.jspin[idx]]);
             }
 
             // DMI
             if( this->idx_dmi >= 0 )
             {
-                for( unsigned int ipair = 0; ipair < dmi_pairs.size(); ++ipair )
+                const auto& table = *this->dmi_table;
+                for( int idx = table.row_ptr[ispin]; idx < table.row_ptr[ispin + 1]; ++idx )
                 {
-                    const auto& pair = dmi_pairs[ipair];
-                    if( pair.i == ibasis )
-                    {
-                        int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, pair);
-                        if (jspin >= 0)
-                            Energy -= this->dmi_magnitudes[ipair] * this->dmi_normals[ipair].dot(spins[ispin].cross(spins[jspin]));
-                    }
-                    #ifndef SPIRIT_USE_OPENMP
-                    if( pair.j == ibasis )
-                    {
-                        const auto& t = pair.translations;
-                        pair_inv = Pair{pair.j, pair.i, {-t[0], -t[1], -t[2]}};
-                        int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, pair_inv);
-                        if (jspin >= 0)
-                            Energy += this->dmi_magnitudes[ipair] * this->dmi_normals[ipair].dot(spins[ispin].cross(spins[jspin]));
-                    }
-                    #endif
+                    int i_pair = table.ipair[idx];
+                    Energy -= table.orientation[idx] * this->dmi_magnitudes[i_pair] * this->dmi_normals[i_pair].dot(spins[ispin].cross(spins[table.jspin[idx]]));
                 }
             }
 
@@ -565,6 +661,175 @@ namespace Engine
     }
 
 
+    scalar Hamiltonian_Heisenberg::Energy_Single_Spin_Difference(int ispin, const Vector3 & spin_old, const Vector3 & spin_new, const vectorfield & spins)
+    {
+        if( !check_atom_type(this->geometry->atom_types[ispin]) )
+            return 0;
+
+        const int N      = this->geometry->n_cell_atoms;
+        const int ibasis = ispin % N;
+        auto& mu_s       = this->geometry->mu_s;
+
+        // All terms except anisotropy, quadruplets and DDI self-interaction are linear in the spin
+        const Vector3 spin_diff = spin_new - spin_old;
+        scalar Ediff = 0;
+
+        // External field
+        if( this->idx_zeeman >= 0 )
+            Ediff -= mu_s[ispin] * this->external_field_magnitude * this->external_field_normal.dot(spin_diff);
+
+        // Anisotropy
+        if( this->idx_anisotropy >= 0 )
+        {
+            for( int iani = 0; iani < anisotropy_indices.size(); ++iani )
+            {
+                if( anisotropy_indices[iani] == ibasis )
+                    Ediff -= this->anisotropy_magnitudes[iani] * ( std::pow(anisotropy_normals[iani].dot(spin_new), 2.0)
+                                                                 - std::pow(anisotropy_normals[iani].dot(spin_old), 2.0) );
+            }
+        }
+
+        // Exchange (an interaction of a spin with its own periodic image does not change the energy)
+        if( this->idx_exchange >= 0 )
+        {
+            const auto& table = *this->exchange_table;
+            for( int idx = table.row_ptr[ispin]; idx < table.row_ptr[ispin + 1]; ++idx )
+            {
+                int jspin = table.jspin[idx];
+                if( jspin != ispin )
+                    Ediff -= this->exchange_magnitudes[table.ipair[idx]] * spin_diff.dot(spins[jspin]);
+            }
+        }
+
+        // DMI
+        if( this->idx_dmi >= 0 )
+        {
+            const auto& table = *this->dmi_table;
+            for( int idx = table.row_ptr[ispin]; idx < table.row_ptr[ispin + 1]; ++idx )
+            {
+                int jspin  = table.jspin[idx];
+                int i_pair = table.ipair[idx];
+                if( jspin != ispin )
+                    Ediff -= table.orientation[idx] * this->dmi_magnitudes[i_pair] * this->dmi_normals[i_pair].dot(spin_diff.cross(spins[jspin]));
+            }
+        }
+
+        // DDI
+        if( this->idx_ddi >= 0 )
+        {
+            Vector3 field_ddi;
+            Matrix3 tensor_self;
+            this->Field_DDI_Single_Spin(ispin, spins, field_ddi, tensor_self);
+            Ediff -= mu_s[ispin] * spin_diff.dot(field_ddi)
+                   + 0.5 * mu_s[ispin] * mu_s[ispin] * ( spin_new.dot(tensor_self * spin_new) - spin_old.dot(tensor_self * spin_old) );
+        }
+
+        // Quadruplets
+        if( this->idx_quadruplet >= 0 )
+        {
+            for( int entry : this->quadruplet_basis_index[ibasis] )
+            {
+                const int iquad    = entry / 4;
+                const int position = entry % 4;
+                int idx[4];
+                this->Quadruplet_Spin_Indices(ispin, iquad, position, idx);
+
+                // If ispin appears more than once in the quadruplet, it is only counted at its first position
+                bool counted = false;
+                for( int p = 0; p < position; ++p )
+                    counted = counted || idx[p] == ispin;
+                if( counted )
+                    continue;
+
+                if( check_atom_type(this->geometry->atom_types[idx[0]]) && check_atom_type(this->geometry->atom_types[idx[1]]) &&
+                    check_atom_type(this->geometry->atom_types[idx[2]]) && check_atom_type(this->geometry->atom_types[idx[3]]) )
+                {
+                    auto energy = [&]( const Vector3 & spin ) -> scalar
+                    {
+                        const Vector3 & si = idx[0] == ispin ? spin : spins[idx[0]];
+                        const Vector3 & sj = idx[1] == ispin ? spin : spins[idx[1]];
+                        const Vector3 & sk = idx[2] == ispin ? spin : spins[idx[2]];
+                        const Vector3 & sl = idx[3] == ispin ? spin : spins[idx[3]];
+                        return -quadruplet_magnitudes[iquad] * (si.dot(sj)) * (sk.dot(sl));
+                    };
+                    Ediff += energy(spin_new) - energy(spin_old);
+                }
+            }
+        }
+
+        return Ediff;
+    }
+
+
+    void Hamiltonian_Heisenberg::Quadruplet_Spin_Indices(int ispin, int iquad, int position, int idx[4])
+    {
+        const int N = this->geometry->n_cell_atoms;
+        const auto& q = quadruplets[iquad];
+        const std::array<int, 3> d_zero{ 0, 0, 0 };
+
+        // Find the cell of the first spin of the quadruplet and from it the indices of all four spins
+        auto translations = Vectormath::translations_from_idx(geometry->n_cells, N, ispin);
+        const std::array<int, 3>* d[4] = { &d_zero, &q.d_j, &q.d_k, &q.d_l };
+        const auto& d_pos = *d[position];
+        int icell_q = Vectormath::idx_from_translations(geometry->n_cells, N, translations, { -d_pos[0], -d_pos[1], -d_pos[2] });
+        auto translations_q = Vectormath::translations_from_idx(geometry->n_cells, N, icell_q);
+        idx[0] = q.i + icell_q;
+        idx[1] = q.j + Vectormath::idx_from_translations(geometry->n_cells, N, translations_q, q.d_j);
+        idx[2] = q.k + Vectormath::idx_from_translations(geometry->n_cells, N, translations_q, q.d_k);
+        idx[3] = q.l + Vectormath::idx_from_translations(geometry->n_cells, N, translations_q, q.d_l);
+    }
+
+
+    bool Hamiltonian_Heisenberg::Interaction_Neighbours(field<intfield> & neighbours)
+    {
+        // FFT and direct summation of the DDI couple every spin to every other spin
+        if( this->idx_ddi >= 0 && !(this->ddi_method == DDI_Method::Cutoff && this->ddi_cutoff_radius >= 0) )
+            return false;
+
+        const int nos = this->geometry->nos;
+        const int N   = this->geometry->n_cell_atoms;
+        neighbours = field<intfield>(nos);
+
+        // Pair interactions (the tables always contain both orientations of a pair)
+        std::vector<const Pair_Table *> tables;
+        if( this->idx_exchange >= 0 )
+            tables.push_back(this->exchange_table.get());
+        if( this->idx_dmi >= 0 )
+            tables.push_back(this->dmi_table.get());
+        if( this->idx_ddi >= 0 )
+            tables.push_back(this->ddi_table.get());
+
+        #pragma omp parallel for
+        for( int ispin = 0; ispin < nos; ++ispin )
+        {
+            auto& list = neighbours[ispin];
+            for( auto table : tables )
+            {
+                for( int idx = table->row_ptr[ispin]; idx < table->row_ptr[ispin + 1]; ++idx )
+                    list.push_back(table->jspin[idx]);
+            }
+
+            // Quadruplets couple all four of their spins
+            if( this->idx_quadruplet >= 0 )
+            {
+                for( int entry : this->quadruplet_basis_index[ispin % N] )
+                {
+                    int idx[4];
+                    this->Quadruplet_Spin_Indices(ispin, entry / 4, entry % 4, idx);
+                    list.insert(list.end(), idx, idx + 4);
+                }
+            }
+
+            // Remove duplicates and the spin itself
+            std::sort(list.begin(), list.end());
+            list.erase(std::unique(list.begin(), list.end()), list.end());
+            list.erase(std::remove(list.begin(), list.end(), ispin), list.end());
+        }
+
+        return true;
+    }
+
+
     void Hamiltonian_Heisenberg::Gradient(const vectorfield & spins, vectorfield & gradient)
     {
         // Set to zero
@@ -589,6 +854,121 @@ namespace Engine
         this->Gradient_Quadruplet(spins, gradient);
     }
 
+    void Hamiltonian_Heisenberg::Gradient_Batch(const std::vector<const vectorfield*> & spins, std::vector<vectorfield*> & gradients)
+    {
+        const int n_img = spins.size();
+        const int nos   = geometry->nos;
+
+        // Zeeman, anisotropy, exchange and DMI of all images in one parallel region
+        #pragma omp parallel for collapse(2)
+        for( int img = 0; img < n_img; ++img )
+        {
+            for( int ispin = 0; ispin < nos; ++ispin )
+                (*gradients[img])[ispin] = this->Gradient_Local_Single_Spin(ispin, *spins[img]);
+        }
+
+        // DD
+        if( this->ddi_method == DDI_Method::FFT )
+        {
+            this->Prepare_DDI_Batch(n_img);
+            this->Gradient_DDI_FFT(spins, gradients, fft_plan_spins_batch, fft_plan_reverse_batch, spin_stride_batch, spin_stride_batch_img);
+        }
+        else
+        {
+            for( int img = 0; img < n_img; ++img )
+                this->Gradient_DDI(*spins[img], *gradients[img]);
+        }
+
+        // Quadruplets
+        for( int img = 0; img < n_img; ++img )
+            this->Gradient_Quadruplet(*spins[img], *gradients[img]);
+    }
+
+    bool Hamiltonian_Heisenberg::Equivalent(const Hamiltonian & other)
+    {
+        if( this == &other )
+            return true;
+
+        auto ham = dynamic_cast<const Hamiltonian_Heisenberg *>(&other);
+        if( !ham )
+            return false;
+
+        // Equal neighbour tables and DDI kernels are shared, so that the pairs can be compared by address
+        if( boundary_conditions     != ham->boundary_conditions     ||
+            exchange_table          != ham->exchange_table          ||
+            dmi_table               != ham->dmi_table               ||
+            ddi_table               != ham->ddi_table               ||
+            ddi_kernel              != ham->ddi_kernel              ||
+            ddi_method              != ham->ddi_method              ||
+            ddi_cutoff_radius       != ham->ddi_cutoff_radius       ||
+            ddi_theta               != ham->ddi_theta               ||
+            ddi_n_periodic_images   != ham->ddi_n_periodic_images   ||
+            external_field_magnitude != ham->external_field_magnitude ||
+            external_field_normal   != ham->external_field_normal   ||
+            anisotropy_indices      != ham->anisotropy_indices      ||
+            anisotropy_magnitudes   != ham->anisotropy_magnitudes   ||
+            anisotropy_normals      != ham->anisotropy_normals      ||
+            exchange_magnitudes     != ham->exchange_magnitudes     ||
+            dmi_magnitudes          != ham->dmi_magnitudes          ||
+            dmi_normals             != ham->dmi_normals             ||
+            ddi_magnitudes          != ham->ddi_magnitudes          ||
+            ddi_normals             != ham->ddi_normals             ||
+            quadruplet_magnitudes   != ham->quadruplet_magnitudes   ||
+            quadruplets.size()      != ham->quadruplets.size() )
+            return false;
+
+        for( unsigned int iquad = 0; iquad < quadruplets.size(); ++iquad )
+        {
+            auto& q1 = quadruplets[iquad];
+            auto& q2 = ham->quadruplets[iquad];
+            if( q1.i != q2.i || q1.j != q2.j || q1.k != q2.k || q1.l != q2.l ||
+                q1.d_j != q2.d_j || q1.d_k != q2.d_k || q1.d_l != q2.d_l )
+                return false;
+        }
+
+        if( geometry == ham->geometry )
+            return true;
+
+        return geometry->n_cells      == ham->geometry->n_cells      &&
+               geometry->n_cell_atoms == ham->geometry->n_cell_atoms &&
+               geometry->atom_types   == ham->geometry->atom_types   &&
+               geometry->mu_s         == ham->geometry->mu_s         &&
+               geometry->positions    == ham->geometry->positions;
+    }
+
+    Vector3 Hamiltonian_Heisenberg::Gradient_Local_Single_Spin(int ispin, const vectorfield & spins)
+    {
+        Vector3 gradient{0,0,0};
+        if( !check_atom_type(this->geometry->atom_types[ispin]) )
+            return gradient;
+
+        // External field
+        gradient -= this->geometry->mu_s[ispin] * this->external_field_magnitude * this->external_field_normal;
+
+        // Anisotropy
+        const int ibasis = ispin % geometry->n_cell_atoms;
+        for( unsigned int iani = 0; iani < anisotropy_indices.size(); ++iani )
+        {
+            if( anisotropy_indices[iani] == ibasis )
+                gradient -= 2.0 * this->anisotropy_magnitudes[iani] * this->anisotropy_normals[iani] * anisotropy_normals[iani].dot(spins[ispin]);
+        }
+
+        // Exchange
+        const auto& ex = *this->exchange_table;
+        for( int idx = ex.row_ptr[ispin]; idx < ex.row_ptr[ispin + 1]; ++idx )
+            gradient -= exchange_magnitudes[ex.ipair[idx]] * spins[ex.jspin[idx]];
+
+        // DMI
+        const auto& dm = *this->dmi_table;
+        for( int idx = dm.row_ptr[ispin]; idx < dm.row_ptr[ispin + 1]; ++idx )
+        {
+            int i_pair = dm.ipair[idx];
+            gradient -= dm.orientation[idx] * dmi_magnitudes[i_pair] * spins[dm.jspin[idx]].cross(dmi_normals[i_pair]);
+        }
+
+        return gradient;
+    }
+
 
     void Hamiltonian_Heisenberg::Gradient_Zeeman(vectorfield & gradient)
     {
@@ -625,40 +1005,27 @@ namespace Engine
 
     void Hamiltonian_Heisenberg::Gradient_Exchange(const vectorfield & spins, vectorfield & gradient)
     {
+        const auto& table = *this->exchange_table;
+
         #pragma omp parallel for
-        for( int icell = 0; icell < geometry->n_cells_total; ++icell )
+        for( int ispin = 0; ispin < geometry->nos; ++ispin )
         {
-            for( unsigned int i_pair = 0; i_pair < exchange_pairs.size(); ++i_pair )
-            {
-                int ispin = exchange_pairs[i_pair].i + icell*geometry->n_cell_atoms;
-                int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, exchange_pairs[i_pair]);
-                if( jspin >= 0 )
-                {
-                    gradient[ispin] -= exchange_magnitudes[i_pair] * spins[jspin];
-                    #ifndef SPIRIT_USE_OPENMP
-                    gradient[jspin] -= exchange_magnitudes[i_pair] * spins[ispin];
-                    #endif
-                }
-            }
+            for( int idx = table.row_ptr[ispin]; idx < table.row_ptr[ispin + 1]; ++idx )
+                gradient[ispin] -= exchange_magnitudes[table.ipair[idx]] * spins[table.jspin[idx]];
         }
     }
 
     void Hamiltonian_Heisenberg::Gradient_DMI(const vectorfield & spins, vectorfield & gradient)
     {
+        const auto& table = *this->dmi_table;
+
         #pragma omp parallel for
-        for( int icell = 0; icell < geometry->n_cells_total; ++icell )
+        for( int ispin = 0; ispin < geometry->nos; ++ispin )
         {
-            for( unsigned int i_pair = 0; i_pair < dmi_pairs.size(); ++i_pair )
+            for( int idx = table.row_ptr[ispin]; idx < table.row_ptr[ispin + 1]; ++idx )
             {
-                int ispin = dmi_pairs[i_pair].i + icell*geometry->n_cell_atoms;
-                int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, dmi_pairs[i_pair]);
-                if( jspin >= 0 )
-                {
-                    gradient[ispin] -= dmi_magnitudes[i_pair] * spins[jspin].cross(dmi_normals[i_pair]);
-                    #ifndef SPIRIT_USE_OPENMP
-                    gradient[jspin] += dmi_magnitudes[i_pair] * spins[ispin].cross(dmi_normals[i_pair]);
-                    #endif
-                }
+                int i_pair = table.ipair[idx];
+                gradient[ispin] -= table.orientation[idx] * dmi_magnitudes[i_pair] * spins[table.jspin[idx]].cross(dmi_normals[i_pair]);
             }
         }
     }
@@ -667,6 +1034,8 @@ namespace Engine
     {
         if( this->ddi_method == DDI_Method::FFT )
             this->Gradient_DDI_FFT(spins, gradient);
+        else if( this->ddi_method == DDI_Method::FMM )
+            this->Gradient_DDI_Tree(spins, gradient);
         else if( this->ddi_method == DDI_Method::Cutoff )
         {
             // TODO: Merge these implementations in the future
@@ -679,118 +1048,147 @@ namespace Engine
 
     void Hamiltonian_Heisenberg::Gradient_DDI_Cutoff(const vectorfield & spins, vectorfield & gradient)
     {
-        auto& mu_s = this->geometry->mu_s;
-        // The translations are in angstr�m, so the |r|[m] becomes |r|[m]*10^-10
-        const scalar mult = C::mu_0 * C::mu_B * C::mu_B / ( 4*C::Pi * 1e-30 );
+        const auto& mu_s  = this->geometry->mu_s;
+        const auto& table = *this->ddi_table;
 
-        for( unsigned int i_pair = 0; i_pair < ddi_pairs.size(); ++i_pair )
+        #pragma omp parallel for
+        for( int ispin = 0; ispin < geometry->nos; ++ispin )
         {
-            if( ddi_magnitudes[i_pair] > 0.0 )
+            Vector3 field = Vector3::Zero();
+            for( int idx = table.row_ptr[ispin]; idx < table.row_ptr[ispin + 1]; ++idx )
             {
-                for( int da = 0; da < geometry->n_cells[0]; ++da )
-                {
-                    for( int db = 0; db < geometry->n_cells[1]; ++db )
-                    {
-                        for( int dc = 0; dc < geometry->n_cells[2]; ++dc )
-                        {
-                            scalar skalar_contrib = mult / std::pow(ddi_magnitudes[i_pair], 3.0);
-                            std::array<int, 3 > translations = { da, db, dc };
-
-                            int i = ddi_pairs[i_pair].i;
-                            int j = ddi_pairs[i_pair].j;
-                            int ispin = i + Vectormath::idx_from_translations(geometry->n_cells, geometry->n_cell_atoms, translations);
-                            int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, ddi_pairs[i_pair]);
-                            if( jspin >= 0 )
-                            {
-                                gradient[ispin] -= mu_s[jspin] * mu_s[ispin] * skalar_contrib * (3 * ddi_normals[i_pair] * spins[jspin].dot(ddi_normals[i_pair]) - spins[jspin]);
-                            }
-                        }
-                    }
-                }
+                int jspin = table.jspin[idx];
+                field += mu_s[jspin] * (ddi_tensors[table.ipair[idx]] * spins[jspin]);
             }
+            gradient[ispin] -= mu_s[ispin] * field;
         }
     }//end Field_DipoleDipole
 
     void Hamiltonian_Heisenberg::Gradient_DDI_FFT(const vectorfield & spins, vectorfield & gradient)
     {
+        this->Gradient_DDI_FFT({&spins}, {&gradient}, fft_plan_spins, fft_plan_reverse, spin_stride, 0);
+    }
+
+    void Hamiltonian_Heisenberg::Gradient_DDI_FFT(const std::vector<const vectorfield*> & spins, const std::vector<vectorfield*> & gradients,
+        FFT::FFT_Plan & plan_spins, FFT::FFT_Plan & plan_reverse, const FFT::StrideContainer & stride, int stride_img)
+    {
+        const int n_img = spins.size();
+
         // Size of original geometry
         int Na = geometry->n_cells[0];
         int Nb = geometry->n_cells[1];
         int Nc = geometry->n_cells[2];
 
-        FFT_Spins(spins);
-
-        auto& ft_D_matrices = transformed_dipole_matrices;
-        auto& ft_spins = fft_plan_spins.cpx_ptr;
-
-        auto& res_iFFT = fft_plan_reverse.real_ptr;
-        auto& res_mult = fft_plan_reverse.cpx_ptr;
+        FFT_Spins(spins, plan_spins, stride, stride_img);
 
-        int idx_b1, idx_b2, idx_d;
+        // The complex numbers are stored as interleaved pairs of real and imaginary part
+        const scalar * ft_D_matrices = reinterpret_cast<const scalar *>(ddi_kernel->transformed_dipole_matrices.data());
+        const scalar * ft_spins      = reinterpret_cast<const scalar *>(plan_spins.cpx_ptr.data());
+        scalar * res_mult            = reinterpret_cast<scalar *>(plan_reverse.cpx_ptr.data());
+        auto& res_iFFT = plan_reverse.real_ptr;
 
         // Workaround for compability with intel compiler
         const int c_n_cell_atoms = geometry->n_cell_atoms;
-        const int * c_it_bounds_pointwise_mult = it_bounds_pointwise_mult.data();
-
-        // Loop over basis atoms (i.e sublattices)
-        #pragma omp parallel for collapse(5)
-        for( int i_b1 = 0; i_b1 <c_n_cell_atoms; ++i_b1 )
+        const int c_n_frequencies = n_frequencies;
+        const int * c_inter_sublattice_lookup = ddi_kernel->inter_sublattice_lookup.data();
+        const FFT::StrideContainer s_stride = stride;
+        const FFT::StrideContainer d_stride = dipole_stride;
+
+        // Pointwise multiplication of the transformed dipole matrices and spins.
+        //      Every component of every sublattice is contiguous over the frequency points. The frequency points
+        //      are processed in blocks, small enough that the spins of all sublattices and the sums of one
+        //      sublattice stay in the L1 cache. Every block of every image is handled by one thread, which writes
+        //      each result component exactly once. The innermost loop runs over the frequency points of a block.
+        const int block_size = 64;
+        const int n_blocks = (c_n_frequencies + block_size - 1) / block_size;
+        #pragma omp parallel for collapse(2)
+        for( int img = 0; img < n_img; ++img )
         {
-            for( int c = 0; c < c_it_bounds_pointwise_mult[2]; ++c )
+            for( int block = 0; block < n_blocks; ++block )
             {
-                for( int b = 0; b < c_it_bounds_pointwise_mult[1]; ++b )
+                const int k_begin = block * block_size;
+                const int n_k = std::min(block_size, c_n_frequencies - k_begin);
+                const int idx_s = 2 * (img * stride_img + k_begin);
+                const int idx_D = 2 * k_begin;
+
+                // Loop over basis atoms (i.e sublattices)
+                for( int i_b1 = 0; i_b1 < c_n_cell_atoms; ++i_b1 )
                 {
-                    for( int a = 0; a < c_it_bounds_pointwise_mult[0]; ++a )
+                    scalar res_x[2 * block_size] = {0}, res_y[2 * block_size] = {0}, res_z[2 * block_size] = {0};
+                    for( int i_b2 = 0; i_b2 < c_n_cell_atoms; ++i_b2 )
                     {
-                        for( int i_b2 = 0; i_b2 < c_n_cell_atoms; ++i_b2 )
+                        // Look up at which position the correct D-matrices are saved
+                        int b_inter = c_inter_sublattice_lookup[i_b1 + i_b2 * c_n_cell_atoms];
+
+                        const scalar * fs_x = ft_spins + idx_s + 2 * (i_b2 * s_stride.basis);
+                        const scalar * fs_y = fs_x + 2 * s_stride.comp;
+                        const scalar * fs_z = fs_x + 4 * s_stride.comp;
+
+                        const scalar * fD_xx = ft_D_matrices + idx_D + 2 * (b_inter * d_stride.basis);
+                        const scalar * fD_xy = fD_xx + 2 * d_stride.comp;
+                        const scalar * fD_xz = fD_xx + 4 * d_stride.comp;
+                        const scalar * fD_yy = fD_xx + 6 * d_stride.comp;
+                        const scalar * fD_yz = fD_xx + 8 * d_stride.comp;
+                        const scalar * fD_zz = fD_xx + 10 * d_stride.comp;
+
+                        #pragma omp simd
+                        for( int k = 0; k < n_k; ++k )
                         {
-                            // Look up at which position the correct D-matrices are saved
-                            int& b_inter = inter_sublattice_lookup[i_b1 + i_b2 * geometry->n_cell_atoms];
-
-                            idx_b2 = i_b2 * spin_stride.basis + a * spin_stride.a + b * spin_stride.b + c * spin_stride.c;
-                            idx_b1 = i_b1 * spin_stride.basis + a * spin_stride.a + b * spin_stride.b + c * spin_stride.c;
-                            idx_d  = b_inter * dipole_stride.basis + a * dipole_stride.a + b * dipole_stride.b + c * dipole_stride.c;
-
-                            auto& fs_x = ft_spins[idx_b2                       ];
-                            auto& fs_y = ft_spins[idx_b2 + 1 * spin_stride.comp];
-                            auto& fs_z = ft_spins[idx_b2 + 2 * spin_stride.comp];
-
-                            auto& fD_xx = ft_D_matrices[idx_d                    ];
-                            auto& fD_xy = ft_D_matrices[idx_d + 1 * dipole_stride.comp];
-                            auto& fD_xz = ft_D_matrices[idx_d + 2 * dipole_stride.comp];
-                            auto& fD_yy = ft_D_matrices[idx_d + 3 * dipole_stride.comp];
-                            auto& fD_yz = ft_D_matrices[idx_d + 4 * dipole_stride.comp];
-                            auto& fD_zz = ft_D_matrices[idx_d + 5 * dipole_stride.comp];
-
-                            FFT::addTo(res_mult[idx_b1 + 0 * spin_stride.comp], FFT::mult3D(fD_xx, fD_xy, fD_xz, fs_x, fs_y, fs_z), i_b2 == 0);
-                            FFT::addTo(res_mult[idx_b1 + 1 * spin_stride.comp], FFT::mult3D(fD_xy, fD_yy, fD_yz, fs_x, fs_y, fs_z), i_b2 == 0);
-                            FFT::addTo(res_mult[idx_b1 + 2 * spin_stride.comp], FFT::mult3D(fD_xz, fD_yz, fD_zz, fs_x, fs_y, fs_z), i_b2 == 0);
+                            const int re = 2 * k, im = 2 * k + 1;
+                            res_x[re] += fD_xx[re] * fs_x[re] + fD_xy[re] * fs_y[re] + fD_xz[re] * fs_z[re]
+                                       - fD_xx[im] * fs_x[im] - fD_xy[im] * fs_y[im] - fD_xz[im] * fs_z[im];
+                            res_x[im] += fD_xx[re] * fs_x[im] + fD_xy[re] * fs_y[im] + fD_xz[re] * fs_z[im]
+                                       + fD_xx[im] * fs_x[re] + fD_xy[im] * fs_y[re] + fD_xz[im] * fs_z[re];
+                            res_y[re] += fD_xy[re] * fs_x[re] + fD_yy[re] * fs_y[re] + fD_yz[re] * fs_z[re]
+                                       - fD_xy[im] * fs_x[im] - fD_yy[im] * fs_y[im] - fD_yz[im] * fs_z[im];
+                            res_y[im] += fD_xy[re] * fs_x[im] + fD_yy[re] * fs_y[im] + fD_yz[re] * fs_z[im]
+                                       + fD_xy[im] * fs_x[re] + fD_yy[im] * fs_y[re] + fD_yz[im] * fs_z[re];
+                            res_z[re] += fD_xz[re] * fs_x[re] + fD_yz[re] * fs_y[re] + fD_zz[re] * fs_z[re]
+                                       - fD_xz[im] * fs_x[im] - fD_yz[im] * fs_y[im] - fD_zz[im] * fs_z[im];
+                            res_z[im] += fD_xz[re] * fs_x[im] + fD_yz[re] * fs_y[im] + fD_zz[re] * fs_z[im]
+                                       + fD_xz[im] * fs_x[re] + fD_yz[im] * fs_y[re] + fD_zz[im] * fs_z[re];
                         }
                     }
-                }// end iteration over padded lattice cells
-            }// end iteration over second sublattice
-        }
+
+                    scalar * r_x = res_mult + idx_s + 2 * (i_b1 * s_stride.basis);
+                    scalar * r_y = r_x + 2 * s_stride.comp;
+                    scalar * r_z = r_x + 4 * s_stride.comp;
+                    for( int k = 0; k < 2 * n_k; ++k )
+                    {
+                        r_x[k] = res_x[k];
+                        r_y[k] = res_y[k];
+                        r_z[k] = res_z[k];
+                    }
+                }
+            }
+        }// end iteration over blocks of frequency points
 
         // Inverse Fourier Transform
-        FFT::batch_iFour_3D(fft_plan_reverse);
+        FFT::batch_iFour_3D(plan_reverse);
 
         // Workaround for compability with intel compiler
         const int * c_n_cells = geometry->n_cells.data();
+        const scalar * c_mu_s = geometry->mu_s.data();
 
         // Place the gradients at the correct positions and mult with correct mu
-        for( int c = 0; c < c_n_cells[2]; ++c )
+        #pragma omp parallel for collapse(4)
+        for( int img = 0; img < n_img; ++img )
         {
-            for( int b = 0; b < c_n_cells[1]; ++b )
+            for( int c = 0; c < c_n_cells[2]; ++c )
             {
-                for( int a = 0; a < c_n_cells[0]; ++a )
+                for( int b = 0; b < c_n_cells[1]; ++b )
                 {
-                    for( int i_b1 = 0; i_b1 < c_n_cell_atoms; ++i_b1 )
+                    for( int a = 0; a < c_n_cells[0]; ++a )
                     {
-                        int idx_orig = i_b1 + geometry->n_cell_atoms * (a + Na * (b + Nb * c));
-                        int idx = i_b1 * spin_stride.basis + a * spin_stride.a + b * spin_stride.b + c * spin_stride.c;
-                        gradient[idx_orig][0] -= geometry->mu_s[idx_orig] * res_iFFT[idx                       ] / sublattice_size;
-                        gradient[idx_orig][1] -= geometry->mu_s[idx_orig] * res_iFFT[idx + 1 * spin_stride.comp] / sublattice_size;
-                        gradient[idx_orig][2] -= geometry->mu_s[idx_orig] * res_iFFT[idx + 2 * spin_stride.comp] / sublattice_size;
+                        auto& gradient = *gradients[img];
+                        for( int i_b1 = 0; i_b1 < c_n_cell_atoms; ++i_b1 )
+                        {
+                            int idx_orig = i_b1 + c_n_cell_atoms * (a + Na * (b + Nb * c));
+                            int idx = img * stride_img + i_b1 * s_stride.basis + a * s_stride.a + b * s_stride.b + c * s_stride.c;
+                            gradient[idx_orig][0] -= c_mu_s[idx_orig] * res_iFFT[idx                    ] / sublattice_size;
+                            gradient[idx_orig][1] -= c_mu_s[idx_orig] * res_iFFT[idx + 1 * s_stride.comp] / sublattice_size;
+                            gradient[idx_orig][2] -= c_mu_s[idx_orig] * res_iFFT[idx + 2 * s_stride.comp] / sublattice_size;
+                        }
                     }
                 }
             }
@@ -799,52 +1197,298 @@ namespace Engine
 
     void Hamiltonian_Heisenberg::Gradient_DDI_Direct(const vectorfield & spins, vectorfield & gradient)
     {
-        scalar mult = C::mu_0 * C::mu_B * C::mu_B / ( 4*C::Pi * 1e-30 );
-        scalar d, d3, d5;
-        Vector3 diff;
-        Vector3 diff_img;
+        const scalar mult = C::mu_0 * C::mu_B * C::mu_B / ( 4*C::Pi * 1e-30 );
+        const int nos = geometry->nos;
+        const auto& positions = this->geometry->positions;
+        const auto& mu_s      = this->geometry->mu_s;
 
         int img_a = boundary_conditions[0] == 0 ? 0 : ddi_n_periodic_images[0];
         int img_b = boundary_conditions[1] == 0 ? 0 : ddi_n_periodic_images[1];
         int img_c = boundary_conditions[2] == 0 ? 0 : ddi_n_periodic_images[2];
 
-        for( int idx1 = 0; idx1 < geometry->nos; idx1++ )
+        // Translations of the periodic images
+        vectorfield shifts(0);
+        for( int a_pb = - img_a; a_pb <= img_a; a_pb++ )
+        {
+            for( int b_pb = - img_b; b_pb <= img_b; b_pb++ )
+            {
+                for( int c_pb = -img_c; c_pb <= img_c; c_pb++ )
+                {
+                    shifts.push_back( a_pb * geometry->n_cells[0] * geometry->bravais_vectors[0] * geometry->lattice_constant
+                                    + b_pb * geometry->n_cells[1] * geometry->bravais_vectors[1] * geometry->lattice_constant
+                                    + c_pb * geometry->n_cells[2] * geometry->bravais_vectors[2] * geometry->lattice_constant );
+                }
+            }
+        }
+        const int n_shifts = shifts.size();
+
+        int n_threads = 1;
+        #ifdef SPIRIT_USE_OPENMP
+        n_threads = omp_get_max_threads();
+        #endif
+
+        // As the images are placed symmetrically, the summed dipole tensor of (idx1, idx2) is the same as that
+        //      of (idx2, idx1). Each pair is therefore evaluated once and acts on both spins, which are
+        //      accumulated in one field per thread and summed up afterwards.
+        field<vectorfield> thread_fields(n_threads);
+
+        #pragma omp parallel
         {
-            for( int idx2 = 0; idx2 < geometry->nos; idx2++ )
+            int thread = 0;
+            #ifdef SPIRIT_USE_OPENMP
+            thread = omp_get_thread_num();
+            #endif
+            auto& fields = thread_fields[thread];
+            fields = vectorfield(nos, Vector3::Zero());
+
+            #pragma omp for schedule(dynamic, 16)
+            for( int idx1 = 0; idx1 < nos; idx1++ )
+            {
+                const Vector3 & m1 = spins[idx1];
+                for( int idx2 = idx1; idx2 < nos; idx2++ )
+                {
+                    const Vector3 & m2 = spins[idx2];
+                    Vector3 diff = positions[idx2] - positions[idx1];
+
+                    // The six independent components of the symmetric tensor
+                    scalar Dxx = 0, Dxy = 0, Dxz = 0, Dyy = 0, Dyz = 0, Dzz = 0;
+                    #pragma omp simd reduction(+:Dxx,Dxy,Dxz,Dyy,Dyz,Dzz)
+                    for( int ishift = 0; ishift < n_shifts; ++ishift )
+                    {
+                        scalar x = diff[0] + shifts[ishift][0];
+                        scalar y = diff[1] + shifts[ishift][1];
+                        scalar z = diff[2] + shifts[ishift][2];
+                        scalar d2 = x*x + y*y + z*z;
+                        if( d2 > 1e-20 )
+                        {
+                            scalar d3_inv = 1 / (d2 * std::sqrt(d2));
+                            scalar d5_inv = 3 * d3_inv / d2;
+                            Dxx += x*x * d5_inv - d3_inv;
+                            Dxy += x*y * d5_inv;
+                            Dxz += x*z * d5_inv;
+                            Dyy += y*y * d5_inv - d3_inv;
+                            Dyz += y*z * d5_inv;
+                            Dzz += z*z * d5_inv - d3_inv;
+                        }
+                    }
+
+                    scalar prefactor = mult * mu_s[idx1] * mu_s[idx2];
+                    fields[idx1][0] += prefactor * (Dxx * m2[0] + Dxy * m2[1] + Dxz * m2[2]);
+                    fields[idx1][1] += prefactor * (Dxy * m2[0] + Dyy * m2[1] + Dyz * m2[2]);
+                    fields[idx1][2] += prefactor * (Dxz * m2[0] + Dyz * m2[1] + Dzz * m2[2]);
+                    if( idx2 != idx1 )
+                    {
+                        fields[idx2][0] += prefactor * (Dxx * m1[0] + Dxy * m1[1] + Dxz * m1[2]);
+                        fields[idx2][1] += prefactor * (Dxy * m1[0] + Dyy * m1[1] + Dyz * m1[2]);
+                        fields[idx2][2] += prefactor * (Dxz * m1[0] + Dyz * m1[1] + Dzz * m1[2]);
+                    }
+                }
+            }
+
+            // Sum up the fields of all threads
+            #pragma omp for
+            for( int ispin = 0; ispin < nos; ++ispin )
             {
-                auto& m2 = spins[idx2];
+                for( int t = 0; t < n_threads; ++t )
+                {
+                    // The team may be smaller than the maximum number of threads
+                    if( thread_fields[t].size() > 0 )
+                        gradient[ispin] -= thread_fields[t][ispin];
+                }
+            }
+        }
+    }
+
 
-                diff = this->geometry->positions[idx2] - this->geometry->positions[idx1];
-                scalar Dxx = 0, Dxy = 0, Dxz = 0, Dyy = 0, Dyz = 0, Dzz = 0;
+    // Maximum depth of the Barnes-Hut tree, which limits the subdivision of (nearly) coinciding positions
+    static const int ddi_tree_max_depth = 32;
+    // Maximum number of spins in a leaf of the Barnes-Hut tree
+    static const int ddi_tree_leaf_size = 8;
+
+    void Hamiltonian_Heisenberg::Gradient_DDI_Tree(const vectorfield & spins, vectorfield & gradient)
+    {
+        const auto& tree = this->ddi_tree;
+        const int n_nodes = tree.begin.size();
+        if( n_nodes == 0 )
+            return;
+
+        const auto& positions = this->geometry->positions;
+        const auto& mu_s      = this->geometry->mu_s;
+        // The translations are in Angstrom, so the |r|[m] becomes |r|[m]*10^-10
+        const scalar mult  = C::mu_0 * C::mu_B * C::mu_B / ( 4*C::Pi * 1e-30 );
+        const scalar theta = this->ddi_theta;
+
+        // Total dipole moment M = sum_j mu_j m_j of every node and its first moment Q = sum_j mu_j m_j (r_j - centre)^T.
+        //      Children are stored after their parents, so that running backwards over the nodes visits the children first.
+        vectorfield moment(n_nodes);
+        field<Matrix3> moment_1(n_nodes);
+        #pragma omp parallel for
+        for( int inode = 0; inode < n_nodes; ++inode )
+        {
+            moment[inode]   = Vector3::Zero();
+            moment_1[inode] = Matrix3::Zero();
+            if( tree.first_child[inode] < 0 )
+            {
+                for( int idx = tree.begin[inode]; idx < tree.end[inode]; ++idx )
+                {
+                    int jspin = tree.spin_index[idx];
+                    Vector3 m = mu_s[jspin] * spins[jspin];
+                    moment[inode]   += m;
+                    moment_1[inode] += m * (positions[jspin] - tree.centre[inode]).transpose();
+                }
+            }
+        }
+        for( int inode = n_nodes - 1; inode >= 0; --inode )
+        {
+            for( int ichild = tree.first_child[inode]; ichild >= 0 && ichild < tree.first_child[inode] + tree.n_children[inode]; ++ichild )
+            {
+                moment[inode]   += moment[ichild];
+                moment_1[inode] += moment_1[ichild] + moment[ichild] * (tree.centre[ichild] - tree.centre[inode]).transpose();
+            }
+        }
 
+        // Translations of the periodic images
+        int img_a = boundary_conditions[0] == 0 ? 0 : ddi_n_periodic_images[0];
+        int img_b = boundary_conditions[1] == 0 ? 0 : ddi_n_periodic_images[1];
+        int img_c = boundary_conditions[2] == 0 ? 0 : ddi_n_periodic_images[2];
+        vectorfield shifts(0);
+        for( int a_pb = - img_a; a_pb <= img_a; a_pb++ )
+        {
+            for( int b_pb = - img_b; b_pb <= img_b; b_pb++ )
+            {
+                for( int c_pb = -img_c; c_pb <= img_c; c_pb++ )
+                {
+                    shifts.push_back( a_pb * geometry->n_cells[0] * geometry->bravais_vectors[0] * geometry->lattice_constant
+                                    + b_pb * geometry->n_cells[1] * geometry->bravais_vectors[1] * geometry->lattice_constant
+                                    + c_pb * geometry->n_cells[2] * geometry->bravais_vectors[2] * geometry->lattice_constant );
+                }
+            }
+        }
+
+        // Field of a point dipole m at distance diff
+        auto dipole_field = [mult]( const Vector3 & diff, const Vector3 & m ) -> Vector3
+        {
+            scalar d = diff.norm();
+            if( d <= 1e-10 )
+                return Vector3::Zero();
+            scalar d3 = d * d * d;
+            scalar d5 = d3 * d * d;
+            return mult * (3 * diff * diff.dot(m) / d5 - m / d3);
+        };
+        // Field of a node at distance diff, expanded to first order in the positions of its spins relative to the centre
+        auto node_field = [mult]( const Vector3 & diff, const Vector3 & m, const Matrix3 & q ) -> Vector3
+        {
+            scalar d  = diff.norm();
+            scalar d3 = d * d * d;
+            scalar d5 = d3 * d * d;
+            scalar d7 = d5 * d * d;
+            return mult * ( 3 * diff * diff.dot(m) / d5 - m / d3
+                          + 3 * ( q.transpose() * diff + q * diff + q.trace() * diff ) / d5
+                          - 15 * diff * diff.dot(q * diff) / d7 );
+        };
+
+        // Every spin traverses the tree once per periodic image
+        const int n_spins = tree.spin_index.size();
+        #pragma omp parallel for schedule(dynamic, 64)
+        for( int i = 0; i < n_spins; ++i )
+        {
+            int ispin = tree.spin_index[i];
+            Vector3 field = Vector3::Zero();
+            int stack[8 * ddi_tree_max_depth];
+
+            for( auto& shift : shifts )
+            {
+                Vector3 position = positions[ispin] - shift;
+                int n_stack = 0;
+                stack[n_stack++] = 0;
+                while( n_stack > 0 )
+                {
+                    int inode = stack[--n_stack];
+                    Vector3 diff = tree.centre[inode] - position;
+                    if( tree.first_child[inode] < 0 )
+                    {
+                        // A leaf has few spins, so that the direct sum is as cheap as the expansion
+                        for( int idx = tree.begin[inode]; idx < tree.end[inode]; ++idx )
+                        {
+                            int jspin = tree.spin_index[idx];
+                            field += dipole_field(positions[jspin] - position, mu_s[jspin] * spins[jspin]);
+                        }
+                    }
+                    else if( tree.radius[inode] < theta * diff.norm() )
+                    {
+                        // Far enough away to be treated as a single dipole with a first order correction
+                        field += node_field(diff, moment[inode], moment_1[inode]);
+                    }
+                    else
+                    {
+                        for( int ichild = 0; ichild < tree.n_children[inode]; ++ichild )
+                            stack[n_stack++] = tree.first_child[inode] + ichild;
+                    }
+                }
+            }
+
+            gradient[ispin] -= mu_s[ispin] * field;
+        }
+    }
+
+    void Hamiltonian_Heisenberg::Field_DDI_Single_Spin(int ispin, const vectorfield & spins, Vector3 & field, Matrix3 & tensor_self)
+    {
+        auto& mu_s = this->geometry->mu_s;
+        // The translations are in Angstrom, so the |r|[m] becomes |r|[m]*10^-10
+        const scalar mult = C::mu_0 * C::mu_B * C::mu_B / ( 4*C::Pi * 1e-30 );
+
+        field       = Vector3::Zero();
+        tensor_self = Matrix3::Zero();
+
+        if( this->ddi_method == DDI_Method::Cutoff && this->ddi_cutoff_radius >= 0 )
+        {
+            // Only the pairs inside the cutoff radius
+            const auto& table = *this->ddi_table;
+            for( int idx = table.row_ptr[ispin]; idx < table.row_ptr[ispin + 1]; ++idx )
+            {
+                int jspin = table.jspin[idx];
+                const Matrix3 & D = ddi_tensors[table.ipair[idx]];
+                if( jspin != ispin )
+                    field += mu_s[jspin] * D * spins[jspin];
+                else
+                    tensor_self += D;
+            }
+        }
+        else if( this->ddi_method != DDI_Method::None )
+        {
+            // Direct summation over all spins and their periodic images
+            int img_a = boundary_conditions[0] == 0 ? 0 : ddi_n_periodic_images[0];
+            int img_b = boundary_conditions[1] == 0 ? 0 : ddi_n_periodic_images[1];
+            int img_c = boundary_conditions[2] == 0 ? 0 : ddi_n_periodic_images[2];
+
+            for( int jspin = 0; jspin < geometry->nos; ++jspin )
+            {
+                Vector3 diff = this->geometry->positions[jspin] - this->geometry->positions[ispin];
+                Matrix3 D    = Matrix3::Zero();
                 for( int a_pb = - img_a; a_pb <= img_a; a_pb++ )
                 {
                     for( int b_pb = - img_b; b_pb <= img_b; b_pb++ )
                     {
                         for( int c_pb = -img_c; c_pb <= img_c; c_pb++ )
                         {
-                            diff_img = diff + a_pb * geometry->n_cells[0] * geometry->bravais_vectors[0] * geometry->lattice_constant
-                                            + b_pb * geometry->n_cells[1] * geometry->bravais_vectors[1] * geometry->lattice_constant
-                                            + c_pb * geometry->n_cells[2] * geometry->bravais_vectors[2] * geometry->lattice_constant;
-                            d = diff_img.norm();
+                            Vector3 diff_img = diff + a_pb * geometry->n_cells[0] * geometry->bravais_vectors[0] * geometry->lattice_constant
+                                                    + b_pb * geometry->n_cells[1] * geometry->bravais_vectors[1] * geometry->lattice_constant
+                                                    + c_pb * geometry->n_cells[2] * geometry->bravais_vectors[2] * geometry->lattice_constant;
+                            scalar d = diff_img.norm();
                             if( d > 1e-10 )
                             {
-                                d3 = d * d * d;
-                                d5 = d * d * d * d * d;
-                                Dxx += mult * (3 * diff_img[0]*diff_img[0] / d5 - 1/d3);
-                                Dxy += mult *  3 * diff_img[0]*diff_img[1] / d5;          //same as Dyx
-                                Dxz += mult *  3 * diff_img[0]*diff_img[2] / d5;          //same as Dzx
-                                Dyy += mult * (3 * diff_img[1]*diff_img[1] / d5 - 1/d3);
-                                Dyz += mult *  3 * diff_img[1]*diff_img[2] / d5;          //same as Dzy
-                                Dzz += mult * (3 * diff_img[2]*diff_img[2] / d5 - 1/d3);
+                                scalar d3 = d * d * d;
+                                scalar d5 = d * d * d * d * d;
+                                D += mult * (3 * diff_img * diff_img.transpose() / d5 - Matrix3::Identity() / d3);
                             }
                         }
                     }
                 }
 
-                gradient[idx1][0] -= (Dxx * m2[0] + Dxy * m2[1] + Dxz * m2[2]) * geometry->mu_s[idx1] * geometry->mu_s[idx2];
-                gradient[idx1][1] -= (Dxy * m2[0] + Dyy * m2[1] + Dyz * m2[2]) * geometry->mu_s[idx1] * geometry->mu_s[idx2];
-                gradient[idx1][2] -= (Dxz * m2[0] + Dyz * m2[1] + Dzz * m2[2]) * geometry->mu_s[idx1] * geometry->mu_s[idx2];
+                if( jspin != ispin )
+                    field += mu_s[jspin] * D * spins[jspin];
+                else
+                    tensor_self += D;
             }
         }
     }
@@ -885,94 +1529,78 @@ namespace Engine
     }
 
 
-    void Hamiltonian_Heisenberg::Hessian(const vectorfield & spins, MatrixX & hessian)
+    template<typename Callback>
+    void Hamiltonian_Heisenberg::Hessian_Row_Blocks(int ispin, Callback && add_block)
     {
-        int nos = spins.size();
         const int N = geometry->n_cell_atoms;
 
-        // --- Set to zero
-        hessian.setZero();
-
         // --- Single Spin elements
-        #pragma omp parallel for
-        for( int icell = 0; icell < geometry->n_cells_total; ++icell )
+        if( check_atom_type(this->geometry->atom_types[ispin]) )
         {
             for( int iani = 0; iani < anisotropy_indices.size(); ++iani )
             {
-                int ispin = icell*N + anisotropy_indices[iani];
-                if( check_atom_type(this->geometry->atom_types[ispin]) )
+                if( anisotropy_indices[iani] == ispin % N )
                 {
-                    for( int alpha = 0; alpha < 3; ++alpha )
-                    {
-                        for ( int beta = 0; beta < 3; ++beta )
-                        {
-                            int i = 3 * ispin + alpha;
-                            int j = 3 * ispin + alpha;
-                            hessian(i, j) += -2.0 * this->anisotropy_magnitudes[iani] *
-                                                    this->anisotropy_normals[iani][alpha] *
-                                                    this->anisotropy_normals[iani][beta];
-                        }
-                    }
+                    const Vector3 & n = this->anisotropy_normals[iani];
+                    add_block(ispin, Matrix3(-2.0 * this->anisotropy_magnitudes[iani] * n * n.transpose()));
                 }
             }
         }
 
         // --- Spin Pair elements
         // Exchange
-        #pragma omp parallel for
-        for( int icell = 0; icell < geometry->n_cells_total; ++icell )
+        for( int idx = exchange_table->row_ptr[ispin]; idx < exchange_table->row_ptr[ispin + 1]; ++idx )
         {
-            for( unsigned int i_pair = 0; i_pair < exchange_pairs.size(); ++i_pair )
-            {
-                int ispin = exchange_pairs[i_pair].i + icell*geometry->n_cell_atoms;
-                int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, exchange_pairs[i_pair]);
-                if( jspin >= 0 )
-                {
-                    for( int alpha = 0; alpha < 3; ++alpha )
-                    {
-                        int i = 3 * ispin + alpha;
-                        int j = 3 * jspin + alpha;
-
-                        hessian(i, j) += -exchange_magnitudes[i_pair];
-                        #ifndef SPIRIT_USE_OPENMP
-                        hessian(j, i) += -exchange_magnitudes[i_pair];
-                        #endif
-                    }
-                }
-            }
+            int jspin = exchange_table->jspin[idx];
+            add_block(jspin, Matrix3(-exchange_magnitudes[exchange_table->ipair[idx]] * Matrix3::Identity()));
         }
 
         // DMI
-        #pragma omp parallel for
-        for( int icell = 0; icell < geometry->n_cells_total; ++icell )
+        for( int idx = dmi_table->row_ptr[ispin]; idx < dmi_table->row_ptr[ispin + 1]; ++idx )
         {
-            for( unsigned int i_pair = 0; i_pair < dmi_pairs.size(); ++i_pair )
-            {
-                int ispin = dmi_pairs[i_pair].i + icell*geometry->n_cell_atoms;
-                int jspin = idx_from_pair(ispin, boundary_conditions, geometry->n_cells, geometry->n_cell_atoms, geometry->atom_types, dmi_pairs[i_pair]);
-                if( jspin >= 0 )
-                {
-                    int i = 3*ispin;
-                    int j = 3*jspin;
+            int jspin  = dmi_table->jspin[idx];
+            int i_pair = dmi_table->ipair[idx];
+            // The DMI block is antisymmetric, so the inverted pair contributes its transpose
+            Vector3 D  = dmi_table->orientation[idx] * dmi_magnitudes[i_pair] * dmi_normals[i_pair];
+            Matrix3 block;
+            block <<     0, -D[2],  D[1],
+                      D[2],     0, -D[0],
+                     -D[1],  D[0],     0;
+            add_block(jspin, block);
+        }
 
-                    hessian(i+2, j+1) +=  dmi_magnitudes[i_pair] * dmi_normals[i_pair][0];
-                    hessian(i+1, j+2) += -dmi_magnitudes[i_pair] * dmi_normals[i_pair][0];
-                    hessian(i, j+2)   +=  dmi_magnitudes[i_pair] * dmi_normals[i_pair][1];
-                    hessian(i+2, j)   += -dmi_magnitudes[i_pair] * dmi_normals[i_pair][1];
-                    hessian(i+1, j)   +=  dmi_magnitudes[i_pair] * dmi_normals[i_pair][2];
-                    hessian(i, j+1)   += -dmi_magnitudes[i_pair] * dmi_normals[i_pair][2];
+        // Dipole-Dipole within the cutoff radius
+        //      Note: FFT and direct summation would produce a dense matrix and are not included
+        if( this->ddi_method == DDI_Method::Cutoff && this->ddi_cutoff_radius >= 0 )
+        {
+            auto& mu_s = this->geometry->mu_s;
 
-                    #ifndef SPIRIT_USE_OPENMP
-                    hessian(j+1, i+2) +=  dmi_magnitudes[i_pair] * dmi_normals[i_pair][0];
-                    hessian(j+2, i+1) += -dmi_magnitudes[i_pair] * dmi_normals[i_pair][0];
-                    hessian(j+2, i)   +=  dmi_magnitudes[i_pair] * dmi_normals[i_pair][1];
-                    hessian(j, i+2)   += -dmi_magnitudes[i_pair] * dmi_normals[i_pair][1];
-                    hessian(j, i+1)   +=  dmi_magnitudes[i_pair] * dmi_normals[i_pair][2];
-                    hessian(j+1, i)   += -dmi_magnitudes[i_pair] * dmi_normals[i_pair][2];
-                    #endif
-                }
+            for( int idx = ddi_table->row_ptr[ispin]; idx < ddi_table->row_ptr[ispin + 1]; ++idx )
+            {
+                int jspin  = ddi_table->jspin[idx];
+                int i_pair = ddi_table->ipair[idx];
+                if( ddi_magnitudes[i_pair] > 0.0 )
+                    add_block(jspin, Matrix3(-mu_s[ispin] * mu_s[jspin] * ddi_tensors[i_pair]));
             }
         }
+    }
+
+    void Hamiltonian_Heisenberg::Hessian(const vectorfield & spins, MatrixX & hessian)
+    {
+        int nos = spins.size();
+
+        // --- Set to zero
+        hessian.setZero();
+
+        // Each row of the Hessian is owned by one spin, so there are no concurrent writes
+        #pragma omp parallel for
+        for( int ispin = 0; ispin < nos; ++ispin )
+        {
+            this->Hessian_Row_Blocks(ispin, [&](int jspin, const Matrix3 & block)
+            {
+                hessian.block<3,3>(3*ispin, 3*jspin) += block;
+            });
+        }
 
         // Tentative Dipole-Dipole (Note: this is very tentative and could be wrong)
         field<int> tupel1 = field<int>(4);
@@ -987,11 +1615,11 @@ namespace Engine
                 for( int idx2 = 0; idx2 < geometry->nos; idx2++ )
                 {
                     Engine::Vectormath::tupel_from_idx(idx2, tupel2, maxVal); // tupel2 now is {ib2, a2, b2, c2}
-                    int& b_inter = inter_sublattice_lookup[tupel1[0] + geometry->n_cell_atoms * tupel2[0]];
+                    int& b_inter = ddi_kernel->inter_sublattice_lookup[tupel1[0] + geometry->n_cell_atoms * tupel2[0]];
                     int da = tupel2[1] - tupel1[1];
                     int db = tupel2[2] - tupel1[2];
                     int dc = tupel2[3] - tupel1[3];
-                    Matrix3 & D = dipole_matrices[b_inter + n_inter_sublattice * (da + geometry->n_cells[0] * (db + geometry->n_cells[1] * dc))];
+                    Matrix3 & D = ddi_kernel->dipole_matrices[b_inter + n_inter_sublattice * (da + geometry->n_cells[0] * (db + geometry->n_cells[1] * dc))];
 
                     int i = 3 * idx1;
                     int j = 3 * idx2;
@@ -1034,37 +1662,128 @@ namespace Engine
         // Quadruplets
     }
 
+    void Hamiltonian_Heisenberg::Sparse_Hessian(const vectorfield & spins, SpMatrixX & hessian)
+    {
+        int nos = spins.size();
+
+        // The same contributions as in the dense Hessian are collected as triplets in one buffer
+        // per thread, duplicate entries are summed up when the matrix is assembled
+        int n_threads = 1;
+        #ifdef SPIRIT_USE_OPENMP
+        n_threads = omp_get_max_threads();
+        #endif
+        std::vector<std::vector<SpTriplet>> thread_triplets(n_threads);
+
+        #pragma omp parallel
+        {
+            int ithread = 0;
+            #ifdef SPIRIT_USE_OPENMP
+            ithread = omp_get_thread_num();
+            #endif
+            auto & triplets = thread_triplets[ithread];
+
+            #pragma omp for
+            for( int ispin = 0; ispin < nos; ++ispin )
+            {
+                this->Hessian_Row_Blocks(ispin, [&](int jspin, const Matrix3 & block)
+                {
+                    for( int alpha = 0; alpha < 3; ++alpha )
+                    {
+                        for( int beta = 0; beta < 3; ++beta )
+                        {
+                            if( block(alpha, beta) != 0 )
+                                triplets.push_back( SpTriplet(3*ispin + alpha, 3*jspin + beta, block(alpha, beta)) );
+                        }
+                    }
+                });
+            }
+        }
+
+        // Merge the buffers
+        std::vector<SpTriplet> triplets;
+        std::size_t n_triplets = 0;
+        for( auto & t : thread_triplets )
+            n_triplets += t.size();
+        triplets.reserve(n_triplets);
+        for( auto & t : thread_triplets )
+            triplets.insert(triplets.end(), t.begin(), t.end());
+
+        hessian.resize(3*nos, 3*nos);
+        hessian.setFromTriplets(triplets.begin(), triplets.end());
+    }
+
+    void Hamiltonian_Heisenberg::Hessian_Vector_Product(const vectorfield & spins, const vectorfield & vec, vectorfield & result)
+    {
+        // Apart from the quadruplets, the energy is a quadratic form in the spins plus the Zeeman term,
+        // so the product of the Hessian with vec is the gradient of vec without the Zeeman term.
+        // This includes the dipolar interactions for all methods, e.g. via the FFT convolution.
+        Vectormath::fill(result, {0,0,0});
+        this->Gradient_Anisotropy(vec, result);
+        this->Gradient_Exchange(vec, result);
+        this->Gradient_DMI(vec, result);
+        this->Gradient_DDI(vec, result);
+
+        // The quadruplet gradient is cubic in the spins, so its derivative along vec is calculated
+        // using central finite differences
+        if( this->quadruplets.size() > 0 )
+        {
+            int nos = spins.size();
+            vectorfield spins_displaced = spins;
+            vectorfield gradient_minus(nos, {0,0,0});
+            vectorfield gradient_plus(nos, {0,0,0});
+
+            Vectormath::add_c_a(-this->delta, vec, spins_displaced);
+            this->Gradient_Quadruplet(spins_displaced, gradient_minus);
+
+            Vectormath::add_c_a(2*this->delta, vec, spins_displaced);
+            this->Gradient_Quadruplet(spins_displaced, gradient_plus);
+
+            Vectormath::add_c_a( 1/(2*this->delta), gradient_plus,  result);
+            Vectormath::add_c_a(-1/(2*this->delta), gradient_minus, result);
+        }
+    }
+
     void Hamiltonian_Heisenberg::FFT_Spins(const vectorfield & spins)
+    {
+        this->FFT_Spins({&spins}, fft_plan_spins, spin_stride, 0);
+    }
+
+    void Hamiltonian_Heisenberg::FFT_Spins(const std::vector<const vectorfield*> & spins, FFT::FFT_Plan & plan, const FFT::StrideContainer & stride, int stride_img)
     {
         //size of original geometry
+        int n_img = spins.size();
         int Na = geometry->n_cells[0];
         int Nb = geometry->n_cells[1];
         int Nc = geometry->n_cells[2];
         int n_cell_atoms = geometry->n_cell_atoms;
 
-        auto& fft_spin_inputs = fft_plan_spins.real_ptr;
+        auto& fft_spin_inputs = plan.real_ptr;
 
-        //iterate over the **original** system
-        #pragma omp parallel for collapse(4)
-        for( int c = 0; c < Nc; ++c )
+        //iterate over the **original** system of every image
+        #pragma omp parallel for collapse(5)
+        for( int img = 0; img < n_img; ++img )
         {
-            for( int b = 0; b < Nb; ++b )
+            for( int c = 0; c < Nc; ++c )
             {
-                for( int a = 0; a < Na; ++a )
+                for( int b = 0; b < Nb; ++b )
                 {
-                    for( int bi = 0; bi < n_cell_atoms; ++bi )
+                    for( int a = 0; a < Na; ++a )
                     {
-                        int idx_orig = bi + n_cell_atoms * (a + Na * (b + Nb * c));
-                        int idx      = bi * spin_stride.basis + a * spin_stride.a + b * spin_stride.b + c * spin_stride.c;
+                        for( int bi = 0; bi < n_cell_atoms; ++bi )
+                        {
+                            auto& image = *spins[img];
+                            int idx_orig = bi + n_cell_atoms * (a + Na * (b + Nb * c));
+                            int idx      = img * stride_img + bi * stride.basis + a * stride.a + b * stride.b + c * stride.c;
 
-                        fft_spin_inputs[idx                        ] = spins[idx_orig][0] * geometry->mu_s[idx_orig];
-                        fft_spin_inputs[idx + 1 * spin_stride.comp ] = spins[idx_orig][1] * geometry->mu_s[idx_orig];
-                        fft_spin_inputs[idx + 2 * spin_stride.comp ] = spins[idx_orig][2] * geometry->mu_s[idx_orig];
+                            fft_spin_inputs[idx                   ] = image[idx_orig][0] * geometry->mu_s[idx_orig];
+                            fft_spin_inputs[idx + 1 * stride.comp ] = image[idx_orig][1] * geometry->mu_s[idx_orig];
+                            fft_spin_inputs[idx + 2 * stride.comp ] = image[idx_orig][2] * geometry->mu_s[idx_orig];
+                        }
                     }
                 }
             }
         }//end iteration over basis
-        FFT::batch_Four_3D(fft_plan_spins);
+        FFT::batch_Four_3D(plan);
     }
 
     void Hamiltonian_Heisenberg::FFT_Dipole_Matrices(FFT::FFT_Plan & fft_plan_dipole, int img_a, int img_b, int img_c)
@@ -1078,6 +1797,7 @@ namespace Engine
         int Nc = geometry->n_cells[2];
 
         auto& fft_dipole_inputs = fft_plan_dipole.real_ptr;
+        auto& inter_sublattice_lookup = ddi_kernel->inter_sublattice_lookup;
 
         int b_inter = -1;
         for( int i_b1 = 0; i_b1 < geometry->n_cell_atoms; ++i_b1 )
@@ -1146,7 +1866,7 @@ namespace Engine
                             // We explicitly ignore the different strides etc. here
                             if( save_dipole_matrices && a < Na && b < Nb && c < Nc )
                             {
-                                dipole_matrices[b_inter + n_inter_sublattice * (a + Na * (b + Nb * c))] <<  Dxx, Dxy, Dxz,
+                                ddi_kernel->dipole_matrices[b_inter + n_inter_sublattice * (a + Na * (b + Nb * c))] <<  Dxx, Dxy, Dxz,
                                                                                                             Dxy, Dyy, Dyz,
                                                                                                             Dxz, Dyz, Dzz;
                             }
@@ -1158,12 +1878,36 @@ namespace Engine
         FFT::batch_Four_3D(fft_plan_dipole);
     }
 
+    // Cache of the DDI kernels which are currently in use
+    static std::vector<std::weak_ptr<DDI_Kernel>> ddi_kernel_cache;
+    static std::mutex ddi_kernel_cache_mutex;
+
     void Hamiltonian_Heisenberg::Prepare_DDI()
     {
-        Clean_DDI();
-
         if( ddi_method != DDI_Method::FFT )
+        {
+            Clean_DDI();
             return;
+        }
+
+        int img_a = boundary_conditions[0] == 0 ? 0 : ddi_n_periodic_images[0];
+        int img_b = boundary_conditions[1] == 0 ? 0 : ddi_n_periodic_images[1];
+        int img_c = boundary_conditions[2] == 0 ? 0 : ddi_n_periodic_images[2];
+
+        // Everything the dipole matrices depend on
+        std::vector<scalar> signature = { scalar(img_a), scalar(img_b), scalar(img_c), scalar(save_dipole_matrices),
+            scalar(geometry->n_cells[0]), scalar(geometry->n_cells[1]), scalar(geometry->n_cells[2]),
+            scalar(geometry->n_cell_atoms), geometry->lattice_constant };
+        for( auto& v : geometry->bravais_vectors )
+            signature.insert(signature.end(), { v[0], v[1], v[2] });
+        for( auto& v : geometry->cell_atoms )
+            signature.insert(signature.end(), { v[0], v[1], v[2] });
+
+        // Nothing to do if the kernel is still up to date
+        if( ddi_kernel && ddi_kernel->signature == signature )
+            return;
+
+        Clean_DDI();
 
         n_cells_padded.resize(3);
         n_cells_padded[0] = (geometry->n_cells[0] > 1) ? 2 * geometry->n_cells[0] : 1;
@@ -1183,8 +1927,6 @@ namespace Engine
 
         sublattice_size = n_cells_padded[0] * n_cells_padded[1] * n_cells_padded[2];
 
-        inter_sublattice_lookup.resize(geometry->n_cell_atoms * geometry->n_cell_atoms);
-
         //we dont need to transform over length 1 dims
         std::vector<int> fft_dims;
         for( int i = 2; i >= 0; i-- ) //notice that reverse order is important!
@@ -1205,47 +1947,177 @@ namespace Engine
         }
 
         //Create fft plans.
-        FFT::FFT_Plan fft_plan_dipole  = FFT::FFT_Plan(fft_dims, false, 6 * n_inter_sublattice, sublattice_size);
         fft_plan_spins   = FFT::FFT_Plan(fft_dims, false, 3 * geometry->n_cell_atoms, sublattice_size);
         fft_plan_reverse = FFT::FFT_Plan(fft_dims, true, 3 * geometry->n_cell_atoms, sublattice_size);
 
-        #ifdef SPIRIT_USE_FFTW
-            field<int*> temp_s = {&spin_stride.comp, &spin_stride.basis, &spin_stride.a, &spin_stride.b, &spin_stride.c};
-            field<int*> temp_d = {&dipole_stride.comp, &dipole_stride.basis, &dipole_stride.a, &dipole_stride.b, &dipole_stride.c};;
-            FFT::get_strides(temp_s, {3, this->geometry->n_cell_atoms, n_cells_padded[0], n_cells_padded[1], n_cells_padded[2]});
-            FFT::get_strides(temp_d, {6, n_inter_sublattice, n_cells_padded[0], n_cells_padded[1], n_cells_padded[2]});
-            it_bounds_pointwise_mult  = {   (n_cells_padded[0]/2 + 1), // due to redundancy in real fft
-                                            n_cells_padded[1],
-                                            n_cells_padded[2]
-                                        };
-        #else
-            field<int*> temp_s = {&spin_stride.a, &spin_stride.b, &spin_stride.c, &spin_stride.comp, &spin_stride.basis};
-            field<int*> temp_d = {&dipole_stride.a, &dipole_stride.b, &dipole_stride.c, &dipole_stride.comp, &dipole_stride.basis};;
-            FFT::get_strides(temp_s, {n_cells_padded[0], n_cells_padded[1], n_cells_padded[2], 3, this->geometry->n_cell_atoms});
-            FFT::get_strides(temp_d, {n_cells_padded[0], n_cells_padded[1], n_cells_padded[2], 6, n_inter_sublattice});
-            it_bounds_pointwise_mult  = {   n_cells_padded[0],
-                                            n_cells_padded[1],
-                                            n_cells_padded[2]
-                                        };
-            (it_bounds_pointwise_mult[fft_dims.size() - 1] /= 2 )++;
-        #endif
+        // Every transform is stored contiguously, so that each component of each sublattice is a separate array
+        //      over the lattice (or the frequency points). The real FFT only stores half of the last dimension.
+        field<int*> temp_s = {&spin_stride.a, &spin_stride.b, &spin_stride.c, &spin_stride.comp, &spin_stride.basis};
+        field<int*> temp_d = {&dipole_stride.a, &dipole_stride.b, &dipole_stride.c, &dipole_stride.comp, &dipole_stride.basis};
+        FFT::get_strides(temp_s, {n_cells_padded[0], n_cells_padded[1], n_cells_padded[2], 3, this->geometry->n_cell_atoms});
+        FFT::get_strides(temp_d, {n_cells_padded[0], n_cells_padded[1], n_cells_padded[2], 6, n_inter_sublattice});
+        int n_last = fft_dims.empty() ? 1 : fft_dims.back();
+        n_frequencies = sublattice_size / n_last * (n_last / 2 + 1);
 
-        //perform FFT of dipole matrices
-        int img_a = boundary_conditions[0] == 0 ? 0 : ddi_n_periodic_images[0];
-        int img_b = boundary_conditions[1] == 0 ? 0 : ddi_n_periodic_images[1];
-        int img_c = boundary_conditions[2] == 0 ? 0 : ddi_n_periodic_images[2];
+        std::lock_guard<std::mutex> guard(ddi_kernel_cache_mutex);
 
+        // Re-use a kernel of another Hamiltonian with the same geometry, if there is one
+        auto cached = Find_Cached(ddi_kernel_cache, signature);
+        if( cached )
+        {
+            ddi_kernel = cached;
+            return;
+        }
+
+        //perform FFT of dipole matrices
+        FFT::FFT_Plan fft_plan_dipole = FFT::FFT_Plan(fft_dims, false, 6 * n_inter_sublattice, sublattice_size);
+        ddi_kernel = std::make_shared<DDI_Kernel>();
+        ddi_kernel->signature = signature;
+        ddi_kernel->inter_sublattice_lookup = field<int>(geometry->n_cell_atoms * geometry->n_cell_atoms);
         if(save_dipole_matrices)
-            dipole_matrices = field<Matrix3>(n_inter_sublattice * geometry->n_cells_total);
+            ddi_kernel->dipole_matrices = field<Matrix3>(n_inter_sublattice * geometry->n_cells_total);
 
         FFT_Dipole_Matrices(fft_plan_dipole, img_a, img_b, img_c);
-        transformed_dipole_matrices = std::move(fft_plan_dipole.cpx_ptr);
+        ddi_kernel->transformed_dipole_matrices = std::move(fft_plan_dipole.cpx_ptr);
+        ddi_kernel_cache.push_back(ddi_kernel);
+    }
+
+    void Hamiltonian_Heisenberg::Prepare_DDI_Batch(int n_img)
+    {
+        if( n_img == n_img_batch )
+            return;
+
+        std::vector<int> fft_dims = fft_plan_spins.dims;
+        int n_transforms = 3 * geometry->n_cell_atoms * n_img;
+        fft_plan_spins_batch   = FFT::FFT_Plan(fft_dims, false, n_transforms, sublattice_size);
+        fft_plan_reverse_batch = FFT::FFT_Plan(fft_dims, true, n_transforms, sublattice_size);
+
+        // The images are the slowest index of the transforms, so that a single image has the layout of spin_stride
+        auto& s = spin_stride_batch;
+        field<int*> temp_s = {&s.a, &s.b, &s.c, &s.comp, &s.basis, &spin_stride_batch_img};
+        FFT::get_strides(temp_s, {n_cells_padded[0], n_cells_padded[1], n_cells_padded[2], 3, this->geometry->n_cell_atoms, n_img});
+
+        n_img_batch = n_img;
+    }
+
+    void Hamiltonian_Heisenberg::Prepare_DDI_Tree()
+    {
+        auto& tree = this->ddi_tree;
+        tree = DDI_Tree();
+        if( ddi_method != DDI_Method::FMM )
+            return;
+
+        const auto& positions = this->geometry->positions;
+        const auto& mu_s      = this->geometry->mu_s;
+
+        for( int ispin = 0; ispin < geometry->nos; ++ispin )
+        {
+            if( check_atom_type(this->geometry->atom_types[ispin]) )
+                tree.spin_index.push_back(ispin);
+        }
+        if( tree.spin_index.size() == 0 )
+            return;
+
+        // The root is the bounding cube of all spins
+        Vector3 lower = positions[tree.spin_index[0]];
+        Vector3 upper = lower;
+        for( int ispin : tree.spin_index )
+        {
+            lower = lower.cwiseMin(positions[ispin]);
+            upper = upper.cwiseMax(positions[ispin]);
+        }
+        // Centres, half edge lengths and depths of the cubes of the nodes, which are only needed during the construction
+        vectorfield cube_centre{ (lower + upper) / 2 };
+        scalarfield cube_half{ (upper - lower).maxCoeff() / 2 };
+        intfield    depth{ 0 };
+        tree.begin.push_back(0);
+        tree.end.push_back(tree.spin_index.size());
+
+        // The nodes are subdivided in the order in which they are created, which places children after their parents
+        intfield octant_spins(0);
+        for( unsigned int inode = 0; inode < tree.begin.size(); ++inode )
+        {
+            int begin = tree.begin[inode];
+            int end   = tree.end[inode];
+
+            // Weighted centre and radius
+            Vector3 centre = Vector3::Zero();
+            scalar weight  = 0;
+            for( int idx = begin; idx < end; ++idx )
+            {
+                centre += std::abs(mu_s[tree.spin_index[idx]]) * positions[tree.spin_index[idx]];
+                weight += std::abs(mu_s[tree.spin_index[idx]]);
+            }
+            if( weight > 0 )
+                centre /= weight;
+            else
+            {
+                centre = Vector3::Zero();
+                for( int idx = begin; idx < end; ++idx )
+                    centre += positions[tree.spin_index[idx]];
+                centre /= scalar(end - begin);
+            }
+            scalar radius = 0;
+            for( int idx = begin; idx < end; ++idx )
+                radius = std::max(radius, (positions[tree.spin_index[idx]] - centre).norm());
+            tree.centre.push_back(centre);
+            tree.radius.push_back(radius);
+            tree.first_child.push_back(-1);
+            tree.n_children.push_back(0);
+
+            if( end - begin <= ddi_tree_leaf_size || depth[inode] >= ddi_tree_max_depth || cube_half[inode] <= 1e-10 )
+                continue;
+
+            // Sort the spins of the node into the octants of its cube
+            Vector3 cc = cube_centre[inode];
+            auto octant = [&]( int ispin ) -> int
+            {
+                const Vector3 & r = positions[ispin];
+                return (r[0] > cc[0] ? 1 : 0) + (r[1] > cc[1] ? 2 : 0) + (r[2] > cc[2] ? 4 : 0);
+            };
+            int count[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+            for( int idx = begin; idx < end; ++idx )
+                ++count[octant(tree.spin_index[idx])];
+            int offset[8];
+            offset[0] = begin;
+            for( int o = 1; o < 8; ++o )
+                offset[o] = offset[o-1] + count[o-1];
+            octant_spins.resize(end - begin);
+            int position[8];
+            std::copy(offset, offset + 8, position);
+            for( int idx = begin; idx < end; ++idx )
+            {
+                int ispin = tree.spin_index[idx];
+                octant_spins[position[octant(ispin)]++ - begin] = ispin;
+            }
+            std::copy(octant_spins.begin(), octant_spins.end(), tree.spin_index.begin() + begin);
+
+            // One child per non-empty octant
+            tree.first_child[inode] = tree.begin.size();
+            scalar half = cube_half[inode] / 2;
+            for( int o = 0; o < 8; ++o )
+            {
+                if( count[o] == 0 )
+                    continue;
+                Vector3 sign{ scalar((o & 1) ? 1 : -1), scalar((o & 2) ? 1 : -1), scalar((o & 4) ? 1 : -1) };
+                cube_centre.push_back(cc + half * sign);
+                cube_half.push_back(half);
+                depth.push_back(depth[inode] + 1);
+                tree.begin.push_back(offset[o]);
+                tree.end.push_back(offset[o] + count[o]);
+                ++tree.n_children[inode];
+            }
+        }
     }
 
     void Hamiltonian_Heisenberg::Clean_DDI()
     {
         fft_plan_spins   = FFT::FFT_Plan();
         fft_plan_reverse = FFT::FFT_Plan();
+        fft_plan_spins_batch   = FFT::FFT_Plan();
+        fft_plan_reverse_batch = FFT::FFT_Plan();
+        n_img_batch = 0;
+        ddi_kernel.reset();
     }
 
     // Hamiltonian name as string
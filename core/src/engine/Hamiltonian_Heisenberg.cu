@@ -28,7 +28,7 @@ namespace Engine
         intfield anisotropy_indices, scalarfield anisotropy_magnitudes, vectorfield anisotropy_normals,
         pairfield exchange_pairs, scalarfield exchange_magnitudes,
         pairfield dmi_pairs, scalarfield dmi_magnitudes, vectorfield dmi_normals,
-        DDI_Method ddi_method, intfield ddi_n_periodic_images, scalar ddi_radius,
+        DDI_Method ddi_method, intfield ddi_n_periodic_images, scalar ddi_radius, scalar ddi_theta,
         quadrupletfield quadruplets, scalarfield quadruplet_magnitudes,
         std::shared_ptr<Data::Geometry> geometry,
         intfield boundary_conditions
@@ -40,7 +40,7 @@ namespace Engine
         exchange_pairs_in(exchange_pairs), exchange_magnitudes_in(exchange_magnitudes), exchange_shell_magnitudes(0),
         dmi_pairs_in(dmi_pairs), dmi_magnitudes_in(dmi_magnitudes), dmi_normals_in(dmi_normals), dmi_shell_magnitudes(0), dmi_shell_chirality(0),
         quadruplets(quadruplets), quadruplet_magnitudes(quadruplet_magnitudes),
-        ddi_method(ddi_method), ddi_n_periodic_images(ddi_n_periodic_images), ddi_cutoff_radius(ddi_radius),
+        ddi_method(ddi_method), ddi_n_periodic_images(ddi_n_periodic_images), ddi_cutoff_radius(ddi_radius), ddi_theta(ddi_theta),
         fft_plan_reverse(FFT::FFT_Plan()), fft_plan_spins(FFT::FFT_Plan())
     {
         // Generate interaction pairs, constants etc.
@@ -53,7 +53,7 @@ namespace Engine
         intfield anisotropy_indices, scalarfield anisotropy_magnitudes, vectorfield anisotropy_normals,
         scalarfield exchange_shell_magnitudes,
         scalarfield dmi_shell_magnitudes, int dmi_shell_chirality,
-        DDI_Method ddi_method, intfield ddi_n_periodic_images, scalar ddi_radius,
+        DDI_Method ddi_method, intfield ddi_n_periodic_images, scalar ddi_radius, scalar ddi_theta,
         quadrupletfield quadruplets, scalarfield quadruplet_magnitudes,
         std::shared_ptr<Data::Geometry> geometry,
         intfield boundary_conditions
@@ -65,7 +65,7 @@ namespace Engine
         exchange_pairs_in(0), exchange_magnitudes_in(0), exchange_shell_magnitudes(exchange_shell_magnitudes),
         dmi_pairs_in(0), dmi_magnitudes_in(0), dmi_normals_in(0), dmi_shell_magnitudes(dmi_shell_magnitudes), dmi_shell_chirality(dmi_shell_chirality),
         quadruplets(quadruplets), quadruplet_magnitudes(quadruplet_magnitudes),
-        ddi_method(ddi_method), ddi_n_periodic_images(ddi_n_periodic_images), ddi_cutoff_radius(ddi_radius),
+        ddi_method(ddi_method), ddi_n_periodic_images(ddi_n_periodic_images), ddi_cutoff_radius(ddi_radius), ddi_theta(ddi_theta),
         fft_plan_reverse(FFT::FFT_Plan()), fft_plan_spins(FFT::FFT_Plan())
     {
         // Generate interaction pairs, constants etc.
@@ -614,6 +614,18 @@ namespace Engine
         return Energy;
     }
 
+    scalar Hamiltonian_Heisenberg::Energy_Single_Spin_Difference(int ispin, const Vector3 & spin_old, const Vector3 & spin_new, const vectorfield & spins)
+    {
+        // The neighbour tables are not built in the CUDA version, so we use the generic implementation
+        return Hamiltonian::Energy_Single_Spin_Difference(ispin, spin_old, spin_new, spins);
+    }
+
+    bool Hamiltonian_Heisenberg::Interaction_Neighbours(field<intfield> & neighbours)
+    {
+        // The neighbour tables are not built in the CUDA version
+        return false;
+    }
+
 
     void Hamiltonian_Heisenberg::Gradient(const vectorfield & spins, vectorfield & gradient)
     {
@@ -637,6 +649,17 @@ namespace Engine
         this->Gradient_Quadruplet(spins, gradient);
     }
 
+    void Hamiltonian_Heisenberg::Gradient_Batch(const std::vector<const vectorfield*> & spins, std::vector<vectorfield*> & gradients)
+    {
+        // The kernels already fill the device for a single image
+        Hamiltonian::Gradient_Batch(spins, gradients);
+    }
+
+    bool Hamiltonian_Heisenberg::Equivalent(const Hamiltonian & other)
+    {
+        return Hamiltonian::Equivalent(other);
+    }
+
 
     __global__ void CU_Gradient_Zeeman( const int * atom_types, const int n_cell_atoms, const scalar * mu_s, const scalar external_field_magnitude, const Vector3 external_field_normal, Vector3 * gradient, size_t n_cells_total)
     {
@@ -827,7 +850,7 @@ namespace Engine
 
     void Hamiltonian_Heisenberg::Gradient_DDI_FFT(const vectorfield & spins, vectorfield & gradient)
     {
-        auto& ft_D_matrices = transformed_dipole_matrices;
+        auto& ft_D_matrices = ddi_kernel->transformed_dipole_matrices;
 
         auto& ft_spins = fft_plan_spins.cpx_ptr;
 
@@ -841,7 +864,7 @@ namespace Engine
         // TODO: also parallelize over i_b1
         // Loop over basis atoms (i.e sublattices) and add contribution of each sublattice
         for(int i_b1 = 0; i_b1 < geometry->n_cell_atoms; ++i_b1)
-            CU_FFT_Pointwise_Mult<<<(number_of_mults + 1023) / 1024, 1024>>>(ft_D_matrices.data(), ft_spins.data(), res_mult.data(), it_bounds_pointwise_mult.data(), i_b1, inter_sublattice_lookup.data(), dipole_stride, spin_stride);
+            CU_FFT_Pointwise_Mult<<<(number_of_mults + 1023) / 1024, 1024>>>(ft_D_matrices.data(), ft_spins.data(), res_mult.data(), it_bounds_pointwise_mult.data(), i_b1, ddi_kernel->inter_sublattice_lookup.data(), dipole_stride, spin_stride);
 
         FFT::batch_iFour_3D(fft_plan_reverse);
 
@@ -900,7 +923,7 @@ namespace Engine
                         for ( int beta = 0; beta < 3; ++beta )
                         {
                             int i = 3 * ispin + alpha;
-                            int j = 3 * ispin + alpha;
+                            int j = 3 * ispin + beta;
                             hessian(i, j) += -2.0 * this->anisotropy_magnitudes[iani] *
                                                     this->anisotropy_normals[iani][alpha] *
                                                     this->anisotropy_normals[iani][beta];
@@ -966,11 +989,11 @@ namespace Engine
                 for( int idx2 = 0; idx2 < geometry->nos; idx2++ )
                 {
                     Engine::Vectormath::tupel_from_idx(idx2, tupel2, maxVal); // tupel2 now is {ib2, a2, b2, c2}
-                    int& b_inter = inter_sublattice_lookup[tupel1[0] + geometry->n_cell_atoms * tupel2[0]];
+                    int& b_inter = ddi_kernel->inter_sublattice_lookup[tupel1[0] + geometry->n_cell_atoms * tupel2[0]];
                     int da = tupel2[1] - tupel1[1];
                     int db = tupel2[2] - tupel1[2];
                     int dc = tupel2[3] - tupel1[3];
-                    Matrix3 & D = dipole_matrices[b_inter + n_inter_sublattice * (da + geometry->n_cells[0] * (db + geometry->n_cells[1] * dc))];
+                    Matrix3 & D = ddi_kernel->dipole_matrices[b_inter + n_inter_sublattice * (da + geometry->n_cells[0] * (db + geometry->n_cells[1] * dc))];
 
                     int i = 3 * idx1;
                     int j = 3 * idx2;
@@ -1028,6 +1051,17 @@ namespace Engine
         }
     }
 
+    void Hamiltonian_Heisenberg::Sparse_Hessian(const vectorfield & spins, SpMatrixX & hessian)
+    {
+        // The neighbour tables are not built in the CUDA version, so we use the generic implementation
+        Hamiltonian::Sparse_Hessian(spins, hessian);
+    }
+
+    void Hamiltonian_Heisenberg::Hessian_Vector_Product(const vectorfield & spins, const vectorfield & vec, vectorfield & result)
+    {
+        Hamiltonian::Hessian_Vector_Product(spins, vec, result);
+    }
+
     void Hamiltonian_Heisenberg::FFT_Spins(const vectorfield & spins)
     {
         CU_Write_FFT_Spin_Input<<<(geometry->nos + 1023) / 1024, 1024>>>(fft_plan_spins.real_ptr.data(), spins.data(), it_bounds_write_spins.data(), spin_stride, geometry->mu_s.data());
@@ -1132,7 +1166,7 @@ namespace Engine
         CU_Write_FFT_Dipole_Input<<<(sublattice_size + 1023)/1024, 1024>>>
         (   fft_dipole_inputs.data(), it_bounds_write_dipole.data(), translation_vectors.data(),
             geometry->n_cell_atoms, cell_atom_translations.data(), geometry->n_cells.data(),
-            inter_sublattice_lookup.data(), img.data(), dipole_stride
+            ddi_kernel->inter_sublattice_lookup.data(), img.data(), dipole_stride
         );
         FFT::batch_Four_3D(fft_plan_dipole);
     }
@@ -1150,8 +1184,6 @@ namespace Engine
         n_cells_padded[2] = (geometry->n_cells[2] > 1) ? 2 * geometry->n_cells[2] : 1;
         sublattice_size = n_cells_padded[0] * n_cells_padded[1] * n_cells_padded[2];
 
-        inter_sublattice_lookup.resize(geometry->n_cell_atoms * geometry->n_cell_atoms);
-
         //we dont need to transform over length 1 dims
         std::vector<int> fft_dims;
         for(int i = 2; i >= 0; i--) //notice that reverse order is important!
@@ -1205,14 +1237,17 @@ namespace Engine
         int img_b = boundary_conditions[1] == 0 ? 0 : ddi_n_periodic_images[1];
         int img_c = boundary_conditions[2] == 0 ? 0 : ddi_n_periodic_images[2];
 
+        ddi_kernel = std::make_shared<DDI_Kernel>();
+        ddi_kernel->inter_sublattice_lookup = field<int>(geometry->n_cell_atoms * geometry->n_cell_atoms);
         FFT_Dipole_Matrices(fft_plan_dipole, img_a, img_b, img_c);
-        transformed_dipole_matrices = std::move(fft_plan_dipole.cpx_ptr);
+        ddi_kernel->transformed_dipole_matrices = std::move(fft_plan_dipole.cpx_ptr);
     }//end prepare
 
     void Hamiltonian_Heisenberg::Clean_DDI()
     {
         fft_plan_spins   = FFT::FFT_Plan();
         fft_plan_reverse = FFT::FFT_Plan();
+        ddi_kernel.reset();
     }
 
     // Hamiltonian name as string
@@ -207,6 +207,39 @@ namespace Engine
             return proj;
         }
 
+        // The two spherical tangent vectors of a single unit vector.
+        //      At the poles, the (projected) euclidean x and y (or -y) directions are used instead.
+        void tangent_basis_spherical(const Vector3 & v, Vector3 & e1, Vector3 & e2)
+        {
+            Vector3 tmp, etheta, ephi;
+            if (v[2] > 1-1e-8)
+            {
+                tmp = Vector3{1, 0, 0};
+                e1  = (tmp - tmp.dot(v)*v).normalized();
+                tmp = Vector3{0, 1, 0};
+                e2  = (tmp - tmp.dot(v)*v).normalized();
+            }
+            else if (v[2] < -1+1e-8)
+            {
+                tmp = Vector3{1, 0, 0};
+                e1  = (tmp - tmp.dot(v)*v).normalized();
+                tmp = Vector3{0, -1, 0};
+                e2  = (tmp - tmp.dot(v)*v).normalized();
+            }
+            else
+            {
+                scalar rxy = std::sqrt( 1 - v[2]*v[2] );
+                scalar z_rxy = v[2] / rxy;
+
+                // Note: these are not unit vectors, but derivatives!
+                etheta = Vector3{  v[0]*z_rxy, v[1]*z_rxy, -rxy };
+                ephi   = Vector3{ -v[1]/rxy,   v[0]/rxy,    0   };
+
+                e1 = (etheta - etheta.dot(v)*v).normalized();
+                e2 = (ephi   - ephi.dot(v)*v).normalized();
+            }
+        }
+
         // This gives an orthogonal matrix of shape (3N, 2N), meaning M^T=M^-1 or M^T*M=1.
         // This assumes that the vectors of vf are normalized and that basis is 3N x 2N
         // It can be used to transform a vector into or back from the tangent space of a
@@ -217,37 +250,36 @@ namespace Engine
         //      of a unit sphere, represented in 3N, as the two columns of the matrix.
         void tangent_basis_spherical(const vectorfield & vf, MatrixX & basis)
         {
-            Vector3 tmp, etheta, ephi;
+            Vector3 e1, e2;
             basis.setZero();
             for (unsigned int i=0; i < vf.size(); ++i)
             {
-                if (vf[i][2] > 1-1e-8)
-                {
-                    tmp = Vector3{1, 0, 0};
-                    basis.block<3,1>(3*i,2*i)   = (tmp - tmp.dot(vf[i])*vf[i]).normalized();
-                    tmp = Vector3{0, 1, 0};
-                    basis.block<3,1>(3*i,2*i+1) = (tmp - tmp.dot(vf[i])*vf[i]).normalized();
-                }
-                else if (vf[i][2] < -1+1e-8)
-                {
-                    tmp = Vector3{1, 0, 0};
-                    basis.block<3,1>(3*i,2*i)   = (tmp - tmp.dot(vf[i])*vf[i]).normalized();
-                    tmp = Vector3{0, -1, 0};
-                    basis.block<3,1>(3*i,2*i+1) = (tmp - tmp.dot(vf[i])*vf[i]).normalized();
-                }
-                else
-                {
-                    scalar rxy = std::sqrt( 1 - vf[i][2]*vf[i][2] );
-                    scalar z_rxy = vf[i][2] / rxy;
+                tangent_basis_spherical(vf[i], e1, e2);
+                basis.block<3,1>(3*i,2*i)   = e1;
+                basis.block<3,1>(3*i,2*i+1) = e2;
+            }
+        }
 
-                    // Note: these are not unit vectors, but derivatives!
-                    etheta = Vector3{  vf[i][0]*z_rxy, vf[i][1]*z_rxy, -rxy };
-                    ephi   = Vector3{ -vf[i][1]/rxy,   vf[i][0]/rxy,    0   };
+        // The same basis as above, stored as a sparse 3N x 2N matrix with 6N non-zero entries
+        void tangent_basis_spherical(const vectorfield & vf, SpMatrixX & basis)
+        {
+            int nos = vf.size();
+            std::vector<SpTriplet> triplets;
+            triplets.reserve(6*nos);
 
-                    basis.block<3,1>(3*i,2*i)   = (etheta - etheta.dot(vf[i])*vf[i]).normalized();
-                    basis.block<3,1>(3*i,2*i+1) = (ephi   - ephi.dot(vf[i])*vf[i]).normalized();
+            Vector3 e1, e2;
+            for (int i=0; i < nos; ++i)
+            {
+                tangent_basis_spherical(vf[i], e1, e2);
+                for (int alpha=0; alpha < 3; ++alpha)
+                {
+                    triplets.push_back( SpTriplet(3*i+alpha, 2*i,   e1[alpha]) );
+                    triplets.push_back( SpTriplet(3*i+alpha, 2*i+1, e2[alpha]) );
                 }
             }
+
+            basis.resize(3*nos, 2*nos);
+            basis.setFromTriplets(triplets.begin(), triplets.end());
         }
 
         // This calculates the basis via calculation of cross products
@@ -444,6 +476,33 @@ namespace Engine
         }
 
 
+        void hessian_bordered(const vectorfield & image, const vectorfield & gradient, const SpMatrixX & hessian, SpMatrixX & tangent_basis, SpMatrixX & hessian_out)
+        {
+            // Same as above, but the sparsity of the Hessian is retained, so that no
+            // dense 3Nx3N or 2Nx2N matrices need to be allocated.
+
+            int nos = image.size();
+
+            // The Lagrange multipliers are subtracted on the diagonal
+            std::vector<SpTriplet> triplets;
+            triplets.reserve(3*nos);
+            for (int i=0; i<nos; ++i)
+            {
+                scalar lambda = image[i].dot(gradient[i]);
+                for (int j=0; j<3; ++j)
+                    triplets.push_back( SpTriplet(3*i+j, 3*i+j, -lambda) );
+            }
+            SpMatrixX tmp_3N(3*nos, 3*nos);
+            tmp_3N.setFromTriplets(triplets.begin(), triplets.end());
+            tmp_3N += hessian;
+
+            // Calculate the basis transformation matrix
+            tangent_basis_spherical(image, tangent_basis);
+
+            // Result is a sparse 2Nx2N matrix
+            hessian_out = tangent_basis.transpose() * tmp_3N * tangent_basis;
+        }
+
         void hessian_projected(const vectorfield & image, const vectorfield & gradient, const MatrixX & hessian, MatrixX & tangent_basis, MatrixX & hessian_out)
         {
             // Calculates a 3Nx3N matrix in the projector approach and transforms it into the tangent basis,
@@ -236,6 +236,28 @@ namespace Engine
     }
 
 
+    void Method::Calculate_Gradients(const std::vector<std::shared_ptr<vectorfield>> & configurations, std::vector<vectorfield*> & gradients)
+    {
+        auto& hamiltonian = this->systems[0]->hamiltonian;
+
+        bool batch = true;
+        for( unsigned int img = 1; img < this->systems.size() && batch; ++img )
+            batch = hamiltonian->Equivalent(*this->systems[img]->hamiltonian);
+
+        if( batch )
+        {
+            std::vector<const vectorfield*> spins(configurations.size());
+            for( unsigned int img = 0; img < configurations.size(); ++img )
+                spins[img] = configurations[img].get();
+            hamiltonian->Gradient_Batch(spins, gradients);
+        }
+        else
+        {
+            for( unsigned int img = 0; img < configurations.size(); ++img )
+                this->systems[img]->hamiltonian->Gradient(*configurations[img], *gradients[img]);
+        }
+    }
+
     void Method::Lock()
     {
         for (auto& system : this->systems) system->Lock();
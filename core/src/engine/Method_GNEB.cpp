@@ -77,7 +77,13 @@ namespace Engine
 
         // We assume here that we receive a vector of configurations that corresponds to the vector of systems we gave the Solver.
         //      The Solver shuld respect this, but there is no way to enforce it.
-        // Get Energy and Gradient of configurations
+        // Gradients of all images, stored in the effective fields
+        std::vector<vectorfield*> gradients(chain->noi);
+        for (int img = 0; img < chain->noi; ++img)
+            gradients[img] = &this->chain->images[img]->effective_field;
+        this->Calculate_Gradients(configurations, gradients);
+
+        // Get Energy and effective field of configurations
         for (int img = 0; img < chain->noi; ++img)
         {
             auto& image = *configurations[img];
@@ -97,7 +103,7 @@ namespace Engine
 
             // We do it the following way so that the effective field can be e.g. displayed,
             //      while the gradient force is manipulated (e.g. projected)
-            this->chain->images[img]->UpdateEffectiveField();
+            Vectormath::scale(this->chain->images[img]->effective_field, -1);
             // F_gradient[img] = this->chain->images[img]->effective_field;
             Vectormath::set_c_a(1, this->chain->images[img]->effective_field, F_gradient[img]);
             // // this->chain->images[img]->hamiltonian->Effective_Field(image, this->chain->images[img]->effective_field);
@@ -484,5 +490,6 @@ namespace Engine
     template class Method_GNEB<Solver::Depondt>;
     template class Method_GNEB<Solver::RungeKutta4>;
     template class Method_GNEB<Solver::NCG>;
+    template class Method_GNEB<Solver::BFGS>;
     template class Method_GNEB<Solver::VP>;
 }
\ No newline at end of file
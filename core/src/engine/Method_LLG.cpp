@@ -1,6 +1,7 @@
 #include <Spirit_Defines.h>
 #include <engine/Method_LLG.hpp>
 #include <engine/Vectormath.hpp>
+#include <engine/Philox.hpp>
 #include <data/Spin_System.hpp>
 #include <data/Spin_System_Chain.hpp>
 #include <io/IO.hpp>
@@ -78,11 +79,9 @@ namespace Engine
                 std::sqrt( 2 * damping * parameters.dt * Constants::gamma / Constants::mu_B * Constants::k_B )
                     / (1 + damping*damping);
 
-            // PRNG gives Gaussian RN with width 1 -> scale by epsilon and sqrt(T/mu_s)
-            auto distribution = std::normal_distribution<scalar>{0,1};
-
             // If we have a temperature gradient, we use the distribution (scalarfield)
-            if( parameters.temperature_gradient_inclination != 0 )
+            bool use_distribution = parameters.temperature_gradient_inclination != 0;
+            if( use_distribution )
             {
                 // Calculate distribution
                 Vectormath::get_gradient_distribution(
@@ -91,25 +90,23 @@ namespace Engine
                     parameters.temperature,
                     parameters.temperature_gradient_inclination,
                     this->temperature_distribution, 0, 1e30);
-
-                // TODO: parallelization of this is actually not quite so trivial
-                // #pragma omp parallel for
-                for( unsigned int i = 0; i < this->xi.size(); ++i )
-                {
-                    for( int dim=0; dim<3; ++dim)
-                        this->xi[i][dim] = epsilon * std::sqrt(this->temperature_distribution[i] / geometry.mu_s[i]) * distribution(parameters.prng);
-                }
             }
-            // If we only have homogeneous temperature we do it more efficiently
-            else if( parameters.temperature > 0 )
+
+            // The Gaussian random numbers of width 1 are keyed by the seed and indexed by the number of the thermal field
+            //      and the spin, so that they can be drawn in parallel and do not depend on the number of threads
+            const Philox::Key key{ { std::uint32_t(parameters.rng_seed), 0 } };
+            const std::uint64_t counter = parameters.thermal_field_counter++;
+            const std::uint32_t counter_lo = std::uint32_t(counter);
+            const std::uint32_t counter_hi = std::uint32_t(counter >> 32);
+
+            // The random numbers are scaled by epsilon and sqrt(T/mu_s)
+            #pragma omp parallel for
+            for( int i = 0; i < int(this->xi.size()); ++i )
             {
-                // TODO: parallelization of this is actually not quite so trivial
-                // #pragma omp parallel for
-                for (unsigned int i = 0; i < this->xi.size(); ++i)
-                {
-                    for( int dim=0; dim<3; ++dim)
-                        this->xi[i][dim] = epsilon * std::sqrt(parameters.temperature / geometry.mu_s[i]) * distribution(parameters.prng);
-                }
+                scalar temperature = use_distribution ? this->temperature_distribution[i] : parameters.temperature;
+                scalar amplitude   = epsilon * std::sqrt(temperature / geometry.mu_s[i]);
+                auto n = Philox::normal4(Philox::Counter{ { std::uint32_t(i), counter_lo, counter_hi, 0 } }, key);
+                this->xi[i] = amplitude * Vector3{ n[0], n[1], n[2] };
             }
 
         }
@@ -119,11 +116,16 @@ namespace Engine
     template <Solver solver>
     void Method_LLG<solver>::Calculate_Force(const std::vector<std::shared_ptr<vectorfield>> & configurations, std::vector<vectorfield> & forces)
     {
+        // Gradients of all images
+        std::vector<vectorfield*> gradients(this->systems.size());
+        for (unsigned int img = 0; img < this->systems.size(); ++img)
+            gradients[img] = &Gradient[img];
+        this->Calculate_Gradients(configurations, gradients);
+
         // Loop over images to calculate the total force on each Image
         for (unsigned int img = 0; img < this->systems.size(); ++img)
         {
             // Minus the gradient is the total Force here
-            this->systems[img]->hamiltonian->Gradient(*configurations[img], Gradient[img]);
             #ifdef SPIRIT_ENABLE_PINNING
                 Vectormath::set_c_a(1, Gradient[img], Gradient[img], this->systems[img]->geometry->mask_unpinned);
             #endif // SPIRIT_ENABLE_PINNING
@@ -162,51 +164,46 @@ namespace Engine
             //////////
 
             // Direct minimisation
-            if (parameters.direct_minimization || solver == Solver::VP)
+            if (parameters.direct_minimization || solver == Solver::VP || solver == Solver::NCG || solver == Solver::BFGS)
             {
                 dtg = parameters.dt * Constants::gamma / Constants::mu_B;
                 Vectormath::set_c_cross( dtg, image, force, force_virtual);
+
+                // Apply Pinning
+                #ifdef SPIRIT_ENABLE_PINNING
+                    Vectormath::set_c_a(1, force_virtual, force_virtual, this->systems[0]->geometry->mask_unpinned);
+                #endif // SPIRIT_ENABLE_PINNING
             }
             // Dynamics simulation
             else
             {
                 auto& geometry = *this->systems[0]->geometry;
-
-                Vectormath::set_c_a(dtg, force, force_virtual);
-                Vectormath::add_c_cross(dtg * damping, image, force, force_virtual);
-                Vectormath::scale(force_virtual, geometry.mu_s, true);
+                bool temperature = parameters.temperature > 0 || parameters.temperature_gradient_inclination != 0;
 
                 // STT
-                if (a_j > 0)
+                bool stt_gradient  = a_j > 0 && parameters.stt_use_gradient;
+                bool stt_monolayer = a_j > 0 && !parameters.stt_use_gradient;
+                scalar stt_c_a = 0, stt_c_cross = 0;
+                if( stt_gradient )
                 {
-                    if (parameters.stt_use_gradient)
-                    {
-                        auto& boundary_conditions = this->systems[0]->hamiltonian->boundary_conditions;
-                        // Gradient approximation for in-plane currents
-                        Vectormath::directional_gradient(image, geometry, boundary_conditions, je, s_c_grad); // s_c_grad = (j_e*grad)*S
-                        Vectormath::add_c_a    ( dtg * a_j * ( damping - beta ), s_c_grad, force_virtual); // TODO: a_j durch b_j ersetzen
-                        Vectormath::add_c_cross( dtg * a_j * ( 1 + beta * damping ), s_c_grad, image, force_virtual); // TODO: a_j durch b_j ersetzen
-                        // Gradient in current richtung, daher => *(-1)
-                    }
-                    else
-                    {
-                        // Monolayer approximation
-                        Vectormath::add_c_a    (-dtg * a_j * ( damping - beta ), s_c_vec, force_virtual);
-                        Vectormath::add_c_cross(-dtg * a_j * ( 1 + beta * damping ), s_c_vec, image, force_virtual);
-                    }
+                    auto& boundary_conditions = this->systems[0]->hamiltonian->boundary_conditions;
+                    // Gradient approximation for in-plane currents
+                    Vectormath::directional_gradient(image, geometry, boundary_conditions, je, s_c_grad); // s_c_grad = (j_e*grad)*S
+                    // TODO: a_j durch b_j ersetzen
+                    // Gradient in current richtung, daher => *(-1)
+                    stt_c_a     = dtg * a_j * ( damping - beta );
+                    stt_c_cross = dtg * a_j * ( 1 + beta * damping );
                 }
-
-                // Temperature
-                if( parameters.temperature > 0 || parameters.temperature_gradient_inclination != 0 )
+                else if( stt_monolayer )
                 {
-                    Vectormath::add_c_a    (1, this->xi, force_virtual);
-                    Vectormath::add_c_cross(damping, image, this->xi, force_virtual);
+                    // Monolayer approximation
+                    stt_c_a     = -dtg * a_j * ( damping - beta );
+                    stt_c_cross = -dtg * a_j * ( 1 + beta * damping );
                 }
+
+                Vectormath::llg_force_virtual(image, force, geometry.mu_s, geometry.mask_unpinned, dtg, damping,
+                    stt_gradient, s_c_grad, stt_monolayer, s_c_vec, stt_c_a, stt_c_cross, temperature, this->xi, force_virtual);
             }
-            // Apply Pinning
-            #ifdef SPIRIT_ENABLE_PINNING
-                Vectormath::set_c_a(1, force_virtual, force_virtual, this->systems[0]->geometry->mask_unpinned);
-            #endif // SPIRIT_ENABLE_PINNING
         }
     }
 
@@ -235,7 +232,10 @@ namespace Engine
     void Method_LLG<solver>::Hook_Post_Iteration()
     {
         // Increment the time counter (picoseconds)
-        this->picoseconds_passed += this->systems[0]->llg_parameters->dt;
+        if( solver == Solver::RungeKutta23 )
+            this->picoseconds_passed += this->rk23_dt_accepted;
+        else
+            this->picoseconds_passed += this->systems[0]->llg_parameters->dt;
 
         // --- Convergence Parameter Update
         // Loop over images to calculate the maximum force components
@@ -478,6 +478,8 @@ namespace Engine
     template class Method_LLG<Solver::Heun>;
     template class Method_LLG<Solver::Depondt>;
     template class Method_LLG<Solver::RungeKutta4>;
+    template class Method_LLG<Solver::RungeKutta23>;
     template class Method_LLG<Solver::NCG>;
+    template class Method_LLG<Solver::BFGS>;
     template class Method_LLG<Solver::VP>;
 }
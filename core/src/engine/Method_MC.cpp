@@ -12,12 +12,21 @@
 #include <ctime>
 #include <math.h>
 
+#ifdef SPIRIT_USE_OPENMP
+#include <omp.h>
+#endif
+
 using namespace Utility;
 
 namespace Engine
 {
     Method_MC::Method_MC(std::shared_ptr<Data::Spin_System> system, int idx_img, int idx_chain) :
-        Method(system->mc_parameters, idx_img, idx_chain)
+        Method_MC(system, idx_img, idx_chain, system->mc_parameters->prng)
+    {
+    }
+
+    Method_MC::Method_MC(std::shared_ptr<Data::Spin_System> system, int idx_img, int idx_chain, std::mt19937 & prng) :
+        Method(system->mc_parameters, idx_img, idx_chain), prng(prng)
     {
         // Currently we only support a single image being iterated at once:
         this->systems = std::vector<std::shared_ptr<Data::Spin_System>>(1, system);
@@ -27,8 +36,6 @@ namespace Engine
         this->nos = this->systems[0]->geometry->nos;
         this->nos_nonvacant = this->systems[0]->geometry->nos_nonvacant;
 
-        this->xi = vectorfield(this->nos, {0,0,0});
-
         // We assume it is not converged before the first iteration
         // this->force_max_abs_component = system->mc_parameters->force_convergence + 1.0;
 
@@ -44,32 +51,69 @@ namespace Engine
         this->cone_angle = Constants::Pi * this->parameters_mc->metropolis_cone_angle / 180.0;
         this->n_rejected = 0;
         this->acceptance_ratio_current = this->parameters_mc->acceptance_ratio_target;
+
+        // Random number distributions
+        this->distribution     = std::uniform_real_distribution<scalar>(0, 1);
+        this->distribution_idx = std::uniform_int_distribution<int>(0, this->nos-1);
+
+        // The interaction partners of each spin, if the interactions are short-ranged
+        field<intfield> neighbours;
+        this->short_ranged = this->systems[0]->hamiltonian->Interaction_Neighbours(neighbours);
+
+        // The heat bath and over-relaxation moves calculate the local field of a spin from its energy,
+        //      which needs all other spins for long-ranged interactions
+        if( !this->short_ranged && (this->parameters_mc->heat_bath || this->parameters_mc->n_overrelaxation > 0) )
+        {
+            Log(Log_Level::Warning, this->SenderName, "The Hamiltonian does not provide short-ranged interaction neighbours, "
+                "falling back to Metropolis sweeps without over-relaxation", this->idx_image, this->idx_chain);
+        }
+
+        // Colouring of the lattice for the parallel sweep
+        if( this->parameters_mc->metropolis_parallel )
+        {
+            if( this->short_ranged )
+            {
+                this->Build_Colouring(neighbours);
+
+                // One PRNG stream per thread, seeded from the PRNG of the method
+                int n_threads = 1;
+                #ifdef SPIRIT_USE_OPENMP
+                n_threads = omp_get_max_threads();
+                #endif
+                for( int ithread = 0; ithread < n_threads; ++ithread )
+                    this->prngs.push_back(std::mt19937(this->prng()));
+
+                Log(Log_Level::Info, this->SenderName, fmt::format("Parallel MC sweep with {} colours and {} thread(s)",
+                    this->colours.size(), n_threads), this->idx_image, this->idx_chain);
+            }
+            else
+            {
+                Log(Log_Level::Warning, this->SenderName, "The Hamiltonian does not provide short-ranged interaction neighbours, "
+                    "falling back to the serial MC sweep", this->idx_image, this->idx_chain);
+            }
+        }
     }
 
-    // This implementation is mostly serial as parallelization is nontrivial
-    //      if the range of neighbours for each atom is not pre-defined.
+    // Iterates the spins sequentially or, if a colouring of the lattice is available,
+    //      the colours sequentially and the spins of each colour in parallel.
     void Method_MC::Iteration()
     {
-        // Temporaries
-        auto& spins_old       = *this->systems[0]->spins;
-        auto  spins_new       = spins_old;
+        auto& spins = *this->systems[0]->spins;
 
-        // Generate randomly displaced spin configuration according to cone radius
-        // Vectormath::get_random_vectorfield_unitsphere(this->parameters_mc->prng, random_unit_vectors);
+        // One stochastic sweep, updating the spins in-place
+        if( this->Heat_Bath() )
+            this->n_rejected = Sweep(spins, Move::Heat_Bath);
+        else
+            Metropolis(spins);
 
-        // TODO: add switch between Metropolis and heat bath
-        // One Metropolis step
-        Metropolis(spins_old, spins_new);
-        Vectormath::set_c_a(1, spins_new, spins_old);
+        // Microcanonical sweeps to decorrelate the configuration at no cost in acceptance
+        for( int i = 0; i < this->N_Overrelaxation(); ++i )
+            Sweep(spins, Move::Overrelaxation);
     }
 
     // Simple metropolis step
-    void Method_MC::Metropolis(const vectorfield & spins_old, vectorfield & spins_new)
+    void Method_MC::Metropolis(vectorfield & spins)
     {
-        auto distribution = std::uniform_real_distribution<scalar>(0, 1);
-        auto distribution_idx = std::uniform_int_distribution<>(0, this->nos-1);
-        scalar kB_T = Constants::k_B * this->parameters_mc->temperature;
-
         scalar diff = 0.01;
 
         // Cone angle feedback algorithm
@@ -85,116 +129,265 @@ namespace Engine
 
             this->parameters_mc->metropolis_cone_angle = this->cone_angle * 180.0 / Constants::Pi;
         }
-        this->n_rejected = 0;
 
-        // One Metropolis step for each spin
-        Vector3 e_z{0, 0, 1};
-        scalar costheta, sintheta, phi;
-        Matrix3 local_basis;
-        scalar cos_cone_angle = std::cos(cone_angle);
+        this->n_rejected = Sweep(spins, Move::Metropolis);
+    }
 
-        // Loop over NOS samples (on average every spin should be hit once per Metropolis step)
-        for (int idx=0; idx < this->nos; ++idx)
-        {
-            int ispin;
-            if( this->parameters_mc->metropolis_random_sample )
-                // Better statistics, but additional calculation of random number
-                ispin = distribution_idx(this->parameters_mc->prng);
-            else
-                // Faster, but worse statistics
-                ispin = idx;
+    int Method_MC::Sweep(vectorfield & spins, Move move)
+    {
+        int n_rejected = 0;
 
-            if( Vectormath::check_atom_type(this->systems[0]->geometry->atom_types[ispin]) )
+        if( this->colours.size() > 0 )
+        {
+            // Spins of the same colour do not interact, so they can be updated concurrently.
+            //      Each thread uses its own PRNG stream and the static schedule assigns the spins to
+            //      the threads deterministically, so the result is reproducible for a given thread count.
+            for( auto& colour : this->colours )
             {
-                // Sample a cone
-                if( this->parameters_mc->metropolis_step_cone )
+                int n_colour = colour.size();
+                #pragma omp parallel num_threads(this->prngs.size()) reduction(+:n_rejected)
                 {
-                    // Calculate local basis for the spin
-                    if( spins_old[ispin].z() < 1-1e-10 )
+                    #ifdef SPIRIT_USE_OPENMP
+                    auto& prng = this->prngs[omp_get_thread_num()];
+                    #else
+                    auto& prng = this->prngs[0];
+                    #endif
+                    auto distribution = this->distribution;
+
+                    #pragma omp for schedule(static)
+                    for( int idx = 0; idx < n_colour; ++idx )
                     {
-                        local_basis.col(2) = spins_old[ispin];
-                        local_basis.col(0) = (local_basis.col(2).cross(e_z)).normalized();
-                        local_basis.col(1) = local_basis.col(2).cross(local_basis.col(0));
-                    }
-                    else
-                    {
-                        local_basis = Matrix3::Identity();
+                        if( !Trial(colour[idx], spins, move, prng, distribution) )
+                            ++n_rejected;
                     }
+                }
+            }
+        }
+        else
+        {
+            auto& prng = this->prng;
 
-                    // Rotation angle between 0 and cone_angle degrees
-                    costheta = 1 - (1 - cos_cone_angle) * distribution(this->parameters_mc->prng);
+            // Loop over NOS samples (on average every spin should be hit once per Metropolis step)
+            for( int idx=0; idx < this->nos; ++idx )
+            {
+                int ispin;
+                if( this->parameters_mc->metropolis_random_sample )
+                    // Better statistics, but additional calculation of random number
+                    ispin = this->distribution_idx(prng);
+                else
+                    // Faster, but worse statistics
+                    ispin = idx;
 
-                    sintheta = std::sqrt(1 - costheta*costheta);
+                if( !Trial(ispin, spins, move, prng, this->distribution) )
+                    ++n_rejected;
+            }
+        }
 
-                    // Random distribution of phi between 0 and 360 degrees
-                    phi = 2*Constants::Pi * distribution(this->parameters_mc->prng);
+        return n_rejected;
+    }
 
-                    // New spin orientation in local basis
-                    Vector3 local_spin_new{ sintheta * std::cos(phi),
-                                            sintheta * std::sin(phi),
-                                            costheta };
+    bool Method_MC::Heat_Bath()
+    {
+        return this->parameters_mc->heat_bath && this->short_ranged;
+    }
 
-                    // New spin orientation in regular basis
-                    spins_new[ispin] = local_basis * local_spin_new;
-                }
-                // Sample the entire unit sphere
+    int Method_MC::N_Overrelaxation()
+    {
+        if( this->short_ranged )
+            return this->parameters_mc->n_overrelaxation;
+        return 0;
+    }
+
+    // Orthonormal basis with the given unit vector as third column
+    static Matrix3 Local_Basis(const Vector3 & axis)
+    {
+        const Vector3 e_z{0, 0, 1};
+        Matrix3 local_basis;
+        if( std::abs(axis.z()) < 1-1e-10 )
+        {
+            local_basis.col(2) = axis;
+            local_basis.col(0) = (local_basis.col(2).cross(e_z)).normalized();
+            local_basis.col(1) = local_basis.col(2).cross(local_basis.col(0));
+        }
+        else
+        {
+            local_basis = Matrix3::Identity();
+            local_basis.col(2) = axis;
+            local_basis.col(1) = local_basis.col(2).cross(local_basis.col(0));
+        }
+        return local_basis;
+    }
+
+    // The energy of a spin is written as E(s) = -h*s + E_nl(s), where only anisotropy, quadruplets
+    //      containing the spin more than once and DDI self-interaction contribute to the non-linear part.
+    //      As E_nl is symmetric under s -> -s for all of these, h is given by the energy difference
+    //      between the spin pointing along and against each of the Cartesian axes.
+    //      This needs three single spin energy differences, which are only cheap for short-ranged interactions.
+    Vector3 Method_MC::Local_Field(int ispin, const vectorfield & spins)
+    {
+        auto& hamiltonian = this->systems[0]->hamiltonian;
+        Vector3 field;
+        for( int dim = 0; dim < 3; ++dim )
+        {
+            Vector3 e = Vector3::Zero();
+            e[dim] = 1;
+            field[dim] = -0.5 * hamiltonian->Energy_Single_Spin_Difference(ispin, -e, e, spins);
+        }
+        return field;
+    }
+
+    // Propose a new orientation for a single spin and accept or reject it by the Metropolis criterion
+    bool Method_MC::Trial(int ispin, vectorfield & spins, Move move, std::mt19937 & prng, std::uniform_real_distribution<scalar> & distribution)
+    {
+        // Vacancies are never updated, but also not counted as rejections
+        if( !Vectormath::check_atom_type(this->systems[0]->geometry->atom_types[ispin]) )
+            return true;
+
+        scalar kB_T = Constants::k_B * this->parameters_mc->temperature;
+        scalar costheta, sintheta, phi;
+        // The trial spin orientation
+        Vector3 spin_new;
+        // The local field, which the heat bath and over-relaxation moves take into account exactly
+        Vector3 field = Vector3::Zero();
+
+        if( move == Move::Metropolis )
+        {
+            // Sample a cone
+            if( this->parameters_mc->metropolis_step_cone )
+            {
+                // Rotation angle between 0 and cone_angle degrees
+                costheta = 1 - (1 - std::cos(this->cone_angle)) * distribution(prng);
+
+                sintheta = std::sqrt(1 - costheta*costheta);
+
+                // Random distribution of phi between 0 and 360 degrees
+                phi = 2*Constants::Pi * distribution(prng);
+
+                // New spin orientation in local basis
+                Vector3 local_spin_new{ sintheta * std::cos(phi),
+                                        sintheta * std::sin(phi),
+                                        costheta };
+
+                // New spin orientation in regular basis
+                spin_new = Local_Basis(spins[ispin]) * local_spin_new;
+            }
+            // Sample the entire unit sphere
+            else
+            {
+                // Rotation angle between 0 and 180 degrees
+                costheta = 2*distribution(prng) - 1;
+
+                sintheta = std::sqrt(1 - costheta*costheta);
+
+                // Random distribution of phi between 0 and 360 degrees
+                phi = 2*Constants::Pi * distribution(prng);
+
+                // New spin orientation in local basis
+                spin_new = Vector3{ sintheta * std::cos(phi),
+                                    sintheta * std::sin(phi),
+                                    costheta };
+            }
+        }
+        else
+        {
+            field = Local_Field(ispin, spins);
+            scalar field_norm = field.norm();
+
+            // Without a local field neither move is defined
+            if( field_norm < 1e-12 )
+                return true;
+
+            if( move == Move::Heat_Bath )
+            {
+                // Sample cos(theta) relative to the field from the Boltzmann distribution exp(field_norm*cos(theta)/kB_T),
+                //      see Y. Miyatake et al, J Phys C: Solid State Phys 19, 2539 (1986)
+                scalar x = field_norm / kB_T;
+                if( this->parameters_mc->temperature < 1e-12 )
+                    costheta = 1;
+                else if( x < 1e-8 )
+                    costheta = 2 * distribution(prng) - 1;
                 else
-                {
-                    // Rotation angle between 0 and 180 degrees
-                    costheta = distribution(this->parameters_mc->prng);
+                    costheta = std::max(scalar(-1), 1 + std::log1p(distribution(prng) * std::expm1(-2*x)) / x);
 
-                    sintheta = std::sqrt(1 - costheta*costheta);
+                sintheta = std::sqrt(1 - costheta*costheta);
 
-                    // Random distribution of phi between 0 and 360 degrees
-                    phi = 2*Constants::Pi * distribution(this->parameters_mc->prng);
+                // Random distribution of phi between 0 and 360 degrees
+                phi = 2*Constants::Pi * distribution(prng);
 
-                    // New spin orientation in local basis
-                    spins_new[ispin] = Vector3{ sintheta * std::cos(phi),
-                                                sintheta * std::sin(phi),
-                                                costheta };
-                }
+                Vector3 local_spin_new{ sintheta * std::cos(phi),
+                                        sintheta * std::sin(phi),
+                                        costheta };
 
-                // Energy difference of configurations with and without displacement
-                scalar Eold  = this->systems[0]->hamiltonian->Energy_Single_Spin(ispin, spins_old);
-                scalar Enew  = this->systems[0]->hamiltonian->Energy_Single_Spin(ispin, spins_new);
-                scalar Ediff = Enew-Eold;
+                spin_new = Local_Basis(field / field_norm) * local_spin_new;
+            }
+            else
+            {
+                // Rotation by pi around the local field, which conserves the energy of the linear part
+                Vector3 axis = field / field_norm;
+                spin_new = 2 * spins[ispin].dot(axis) * axis - spins[ispin];
+                spin_new.normalize();
+            }
+        }
 
-                // Metropolis criterion: reject the step if energy rose
-                if( Ediff > 1e-14 )
-                {
-                    if( this->parameters_mc->temperature < 1e-12 )
-                    {
-                        // Restore the spin
-                        spins_new[ispin] = spins_old[ispin];
-                        // Counter for the number of rejections
-                        ++this->n_rejected;
-                    }
-                    else
-                    {
-                        // Exponential factor
-                        scalar exp_ediff    = std::exp( -Ediff/kB_T );
-                        // Metropolis random number
-                        scalar x_metropolis = distribution(this->parameters_mc->prng);
-
-                        // Only reject if random number is larger than exponential
-                        if( exp_ediff < x_metropolis )
-                        {
-                            // Restore the spin
-                            spins_new[ispin] = spins_old[ispin];
-                            // Counter for the number of rejections
-                            ++this->n_rejected;
-                        }
-                    }
-                }
+        // Energy difference of configurations with and without displacement.
+        //      The linear part is already contained exactly in the heat bath and over-relaxation
+        //      moves, so only the remaining non-linear part enters the acceptance criterion.
+        scalar Ediff = this->systems[0]->hamiltonian->Energy_Single_Spin_Difference(ispin, spins[ispin], spin_new, spins)
+                     + field.dot(spin_new - spins[ispin]);
+
+        // Metropolis criterion: reject the step if energy rose
+        bool accept = true;
+        if( Ediff > 1e-14 )
+        {
+            if( this->parameters_mc->temperature < 1e-12 )
+            {
+                accept = false;
+            }
+            else
+            {
+                // Exponential factor
+                scalar exp_ediff    = std::exp( -Ediff/kB_T );
+                // Metropolis random number
+                scalar x_metropolis = distribution(prng);
+
+                // Only reject if random number is larger than exponential
+                accept = exp_ediff >= x_metropolis;
             }
         }
+
+        // Only an accepted step is written into the configuration
+        if( accept )
+            spins[ispin] = spin_new;
+
+        return accept;
     }
 
-    // TODO:
-    // Implement heat bath algorithm, see Y. Miyatake et al, J Phys C: Solid State Phys 19, 2539 (1986)
-    // void Method_MC::HeatBath(const vectorfield & spins_old, vectorfield & spins_new)
-    // {
-    // }
+    // Greedy colouring of the interaction graph: each spin gets the lowest colour not taken by any of its
+    //      already coloured neighbours. On regular lattices this typically yields a small number of colours.
+    void Method_MC::Build_Colouring(const field<intfield> & neighbours)
+    {
+        intfield colour_of(this->nos, -1);
+        std::vector<bool> taken;
+        int n_colours = 0;
+        for( int ispin = 0; ispin < this->nos; ++ispin )
+        {
+            taken.assign(n_colours + 1, false);
+            for( int jspin : neighbours[ispin] )
+            {
+                if( colour_of[jspin] >= 0 )
+                    taken[colour_of[jspin]] = true;
+            }
+            int c = 0;
+            while( taken[c] )
+                ++c;
+            colour_of[ispin] = c;
+            n_colours = std::max(n_colours, c + 1);
+        }
+
+        this->colours = field<intfield>(n_colours);
+        for( int ispin = 0; ispin < this->nos; ++ispin )
+            this->colours[colour_of[ispin]].push_back(ispin);
+    }
 
     void Method_MC::Hook_Pre_Iteration()
     {
@@ -220,7 +413,13 @@ namespace Engine
         block.push_back(fmt::format("------------  Started  {} Calculation  ------------", this->Name()));
         block.push_back(fmt::format("    Going to iterate {} step(s)", this->n_log));
         block.push_back(fmt::format("                with {} iterations per step", this->n_iterations_log));
-        if( this->parameters_mc->metropolis_step_cone )
+        if( this->Heat_Bath() )
+            block.push_back("    Update move: heat bath");
+        else
+            block.push_back("    Update move: Metropolis");
+        if( this->N_Overrelaxation() > 0 )
+            block.push_back(fmt::format("                 + {} over-relaxation sweep(s)", this->N_Overrelaxation()));
+        if( !this->Heat_Bath() && this->parameters_mc->metropolis_step_cone )
         {
             if( this->parameters_mc->metropolis_cone_adaptive )
             {
@@ -252,7 +451,7 @@ namespace Engine
         block.push_back(fmt::format("    Iteration                 {} / {}", this->iteration, this->n_iterations));
         block.push_back(fmt::format("    Time since last step:     {}", Timing::DateTimePassed(t_current - this->t_last)));
         block.push_back(fmt::format("    Iterations / sec:         {}", this->n_iterations_log / Timing::SecondsPassed(t_current - this->t_last)));
-        if( this->parameters_mc->metropolis_step_cone )
+        if( !this->Heat_Bath() && this->parameters_mc->metropolis_step_cone )
         {
             if( this->parameters_mc->metropolis_cone_adaptive )
             {
@@ -296,7 +495,7 @@ namespace Engine
         block.push_back(fmt::format("    Completed         {} / {} step(s)", this->step, this->n_log));
         block.push_back(fmt::format("    Iteration         {} / {}", this->iteration, this->n_iterations));
         block.push_back(fmt::format("    Iterations / sec: {}", this->iteration / Timing::SecondsPassed(t_end - this->t_start)));
-        if( this->parameters_mc->metropolis_step_cone )
+        if( !this->Heat_Bath() && this->parameters_mc->metropolis_step_cone )
         {
             if( this->parameters_mc->metropolis_cone_adaptive )
             {
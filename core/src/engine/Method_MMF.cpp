@@ -41,7 +41,9 @@ namespace Engine
         // We assume that the systems are not converged before the first iteration
         this->force_max_abs_component = system->mmf_parameters->force_convergence + 1.0;
 
-        this->hessian = MatrixX(3*this->nos, 3*this->nos);
+        // The dense Hessian is only needed if the sparse representation is not used
+        if( !system->mmf_parameters->sparse && !system->mmf_parameters->matrix_free )
+            this->hessian = MatrixX(3*this->nos, 3*this->nos);
         // Forces
         this->gradient     = vectorfield(this->nos, {0,0,0});
         this->minimum_mode = vectorfield(this->nos, {0,0,0});
@@ -83,7 +85,9 @@ namespace Engine
     }
 
 
-    void check_modes(const vectorfield & image, const vectorfield & gradient, const MatrixX & tangent_basis, const VectorX & eigenvalues, const MatrixX & eigenvectors_2N, const vectorfield & minimum_mode)
+    // The tangent basis may be a dense or a sparse matrix
+    template<typename Basis>
+    void check_modes(const vectorfield & image, const vectorfield & gradient, const Basis & tangent_basis, const VectorX & eigenvalues, const MatrixX & eigenvectors_2N, const vectorfield & minimum_mode)
     {
         int nos = image.size();
 
@@ -198,9 +202,6 @@ namespace Engine
         this->systems[0]->hamiltonian->Gradient(image, gradient);
         Vectormath::set_c_a(1, gradient, gradient, this->systems[0]->geometry->mask_unpinned);
 
-        // The Hessian (unprojected)
-        this->systems[0]->hamiltonian->Hessian(image, hessian);
-
         Eigen::Ref<VectorX> image_3N = Eigen::Map<VectorX>(image[0].data(), 3*nos);
         Eigen::Ref<VectorX> gradient_3N  = Eigen::Map<VectorX>(gradient[0].data(), 3*nos);
 
@@ -208,14 +209,42 @@ namespace Engine
         ////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
         // Get the eigenspectrum
-        MatrixX hessian_final = MatrixX::Zero(2*nos, 2*nos);
-        MatrixX basis_3Nx2N = MatrixX::Zero(3*nos, 2*nos);
+        MatrixX basis_3Nx2N;
+        SpMatrixX basis_3Nx2N_sparse;
         VectorX eigenvalues;
         MatrixX eigenvectors;
-        bool successful = Eigenmodes::Hessian_Partial_Spectrum(this->parameters, image, gradient, hessian, n_modes, basis_3Nx2N, hessian_final, eigenvalues, eigenvectors);
+        bool successful;
+        bool sparse_basis = parameters.sparse || parameters.matrix_free;
+        if (parameters.matrix_free)
+        {
+            successful = Eigenmodes::Hessian_Partial_Spectrum_Matrix_Free(this->parameters, image, gradient, this->systems[0]->geometry->mask_unpinned, this->systems[0]->hamiltonian, n_modes, basis_3Nx2N_sparse, eigenvalues, eigenvectors, modes_3N_previous);
+        }
+        else if (parameters.sparse)
+        {
+            // The Hessian (unprojected)
+            SpMatrixX hessian_sparse, hessian_final;
+            this->systems[0]->hamiltonian->Sparse_Hessian(image, hessian_sparse);
+            successful = Eigenmodes::Hessian_Partial_Spectrum(this->parameters, image, gradient, this->systems[0]->geometry->mask_unpinned, hessian_sparse, n_modes, basis_3Nx2N_sparse, hessian_final, eigenvalues, eigenvectors, modes_3N_previous);
+        }
+        else
+        {
+            // The Hessian (unprojected)
+            if (hessian.rows() != 3*nos)
+                hessian = MatrixX(3*nos, 3*nos);
+            this->systems[0]->hamiltonian->Hessian(image, hessian);
+            MatrixX hessian_final = MatrixX::Zero(2*nos, 2*nos);
+            basis_3Nx2N = MatrixX::Zero(3*nos, 2*nos);
+            successful = Eigenmodes::Hessian_Partial_Spectrum(this->parameters, image, gradient, this->systems[0]->geometry->mask_unpinned, hessian, n_modes, basis_3Nx2N, hessian_final, eigenvalues, eigenvectors, modes_3N_previous);
+        }
 
         if (successful)
         {
+            // The modes change little between iterations, so they are used as initial guess in the next one
+            if (sparse_basis)
+                modes_3N_previous = basis_3Nx2N_sparse * eigenvectors;
+            else
+                modes_3N_previous = basis_3Nx2N * eigenvectors;
+
             // TODO: if the mode that is followed in the positive region is not no. 0,
             //       the following won't work!!
             //       Need to save the mode_follow as a local variable and update it as necessary.
@@ -274,7 +303,7 @@ namespace Engine
 
 
             // Retrieve the chosen mode as vectorfield
-            VectorX mode_3N = basis_3Nx2N * mode_2N;
+            VectorX mode_3N = sparse_basis ? VectorX(basis_3Nx2N_sparse * mode_2N) : VectorX(basis_3Nx2N * mode_2N);
             for (int n=0; n<nos; ++n)
                 this->minimum_mode[n] = {mode_3N[3*n], mode_3N[3*n+1], mode_3N[3*n+2]};
 
@@ -285,7 +314,10 @@ namespace Engine
             scalar mode_grad_angle = std::abs( mode_grad / (mode_3N.norm()*gradient_3N.norm()) );
 
             // Make sure there is nothing wrong
-            check_modes(image, gradient, basis_3Nx2N, eigenvalues, eigenvectors, minimum_mode);
+            if (sparse_basis)
+                check_modes(image, gradient, basis_3Nx2N_sparse, eigenvalues, eigenvectors, minimum_mode);
+            else
+                check_modes(image, gradient, basis_3Nx2N, eigenvalues, eigenvectors, minimum_mode);
 
             Manifoldmath::project_tangential(gradient, image);
 
@@ -0,0 +1,384 @@
+#include <Spirit_Defines.h>
+#include <engine/Method_PT.hpp>
+#include <engine/Method_MC.hpp>
+#include <data/Spin_System.hpp>
+#include <data/Spin_System_Chain.hpp>
+#include <io/IO.hpp>
+#include <io/OVF_File.hpp>
+#include <utility/Constants.hpp>
+#include <utility/Logging.hpp>
+#include <utility/Version.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+
+#include <fmt/format.h>
+
+using namespace Utility;
+
+namespace Engine
+{
+    Method_PT::Method_PT(std::shared_ptr<Data::Spin_System_Chain> chain, int idx_chain) :
+        Method(chain->images[0]->mc_parameters, -1, idx_chain), chain(chain)
+    {
+        this->systems = chain->images;
+        this->SenderName = Log_Sender::MC;
+
+        this->noi = chain->noi;
+        this->nos = chain->images[0]->nos;
+
+        // History
+        this->history = std::map<std::string, std::vector<scalar>>{
+            {"max_torque_component", {this->force_max_abs_component}} };
+
+        // The iteration and exchange parameters are taken from the first image
+        this->parameters_mc = chain->images[0]->mc_parameters;
+
+        // Each replica is sampled with its own PRNG, owned by this method. Images created by copying
+        //      another image have identical PRNG states, so the index in the chain is added to the seed
+        this->replica_prngs = std::vector<std::mt19937>(this->noi);
+        for( int img = 0; img < this->noi; ++img )
+        {
+            std::seed_seq seed{ (unsigned int)chain->images[img]->mc_parameters->prng(), (unsigned int)img };
+            this->replica_prngs[img].seed(seed);
+        }
+
+        // One MC method per replica
+        for( int img = 0; img < this->noi; ++img )
+            this->replicas.push_back(std::shared_ptr<Method>(
+                new Method_MC(chain->images[img], img, idx_chain, this->replica_prngs[img])));
+
+        this->prng         = std::mt19937(this->parameters_mc->prng());
+        this->distribution = std::uniform_real_distribution<scalar>(0, 1);
+
+        this->energies              = scalarfield(this->noi, 0);
+        this->exchange_offset       = 0;
+        this->n_exchanges_attempted = intfield(std::max(this->noi-1, 0), 0);
+        this->n_exchanges_accepted  = intfield(std::max(this->noi-1, 0), 0);
+    }
+
+    void Method_PT::Iteration()
+    {
+        // The replicas are independent between exchanges
+        #pragma omp parallel for schedule(dynamic)
+        for( int img = 0; img < this->noi; ++img )
+            this->replicas[img]->Iteration();
+
+        int interval = this->parameters_mc->replica_exchange_interval;
+        if( interval > 0 && (this->iteration + 1) % interval == 0 )
+            this->Replica_Exchange();
+    }
+
+    // Standard exchange criterion: the configurations of replicas i and j are swapped with
+    //      probability min(1, exp[(1/kB_T_i - 1/kB_T_j) * (E_i - E_j)]).
+    scalar Method_PT::Exchange_Probability(scalar T_i, scalar T_j, scalar E_i, scalar E_j)
+    {
+        // Replicas at zero temperature do not take part in exchanges
+        if( T_i < 1e-12 || T_j < 1e-12 )
+            return 0;
+
+        scalar exponent = ( 1/(Constants::k_B*T_i) - 1/(Constants::k_B*T_j) ) * ( E_i - E_j );
+        if( exponent >= 0 )
+            return 1;
+        return std::exp(exponent);
+    }
+
+    // Alternating between even and odd pairs, every replica takes part in at most one exchange per step.
+    void Method_PT::Replica_Exchange()
+    {
+        #pragma omp parallel for
+        for( int img = 0; img < this->noi; ++img )
+            this->energies[img] = this->systems[img]->hamiltonian->Energy(*this->systems[img]->spins);
+
+        for( int img = this->exchange_offset; img < this->noi - 1; img += 2 )
+        {
+            scalar T_i = this->systems[img]->mc_parameters->temperature;
+            scalar T_j = this->systems[img+1]->mc_parameters->temperature;
+
+            // Replicas at zero temperature are not counted as exchange attempts
+            if( T_i < 1e-12 || T_j < 1e-12 )
+                continue;
+
+            scalar probability = Exchange_Probability(T_i, T_j, this->energies[img], this->energies[img+1]);
+
+            ++this->n_exchanges_attempted[img];
+            if( probability >= 1 || probability >= this->distribution(this->prng) )
+            {
+                std::swap(*this->systems[img]->spins, *this->systems[img+1]->spins);
+                std::swap(this->energies[img], this->energies[img+1]);
+                ++this->n_exchanges_accepted[img];
+            }
+        }
+
+        this->exchange_offset = 1 - this->exchange_offset;
+    }
+
+    void Method_PT::Hook_Pre_Iteration()
+    {
+    }
+
+    void Method_PT::Hook_Post_Iteration()
+    {
+    }
+
+    void Method_PT::Initialize()
+    {
+    }
+
+    void Method_PT::Finalize()
+    {
+        this->chain->iteration_allowed = false;
+    }
+
+    void Method_PT::Message_Start()
+    {
+        //---- Log messages
+        std::vector<std::string> block(0);
+        block.push_back(fmt::format("------------  Started  {} Calculation  ------------", this->Name()));
+        block.push_back(fmt::format("    Going to iterate {} step(s)", this->n_log));
+        block.push_back(fmt::format("                with {} iterations per step", this->n_iterations_log));
+        block.push_back(fmt::format("    Number of replicas:      {}", this->noi));
+        block.push_back(fmt::format("    Exchange attempted every {} iteration(s)", this->parameters_mc->replica_exchange_interval));
+        for( int img = 0; img < this->noi; ++img )
+            block.push_back(fmt::format("    Replica {:>3}: T = {}", img, this->systems[img]->mc_parameters->temperature));
+        block.push_back("-----------------------------------------------------");
+        Log.SendBlock(Log_Level::All, this->SenderName, block, this->idx_image, this->idx_chain);
+    }
+
+    void Method_PT::Message_Step()
+    {
+        // Update time of current step
+        auto t_current = system_clock::now();
+
+        // Update the systems' energies
+        for( auto& system : this->systems )
+            system->UpdateEnergy();
+
+        // Send log message
+        std::vector<std::string> block(0);
+        block.push_back(fmt::format("----- {} Calculation: {}", this->Name(), Timing::DateTimePassed(t_current - this->t_start)));
+        block.push_back(fmt::format("    Completed                 {} / {} step(s) (step size {})", this->step, this->n_log, this->n_iterations_log));
+        block.push_back(fmt::format("    Iteration                 {} / {}", this->iteration, this->n_iterations));
+        block.push_back(fmt::format("    Time since last step:     {}", Timing::DateTimePassed(t_current - this->t_last)));
+        block.push_back(fmt::format("    Iterations / sec:         {}", this->n_iterations_log / Timing::SecondsPassed(t_current - this->t_last)));
+        for( int img = 0; img < this->noi; ++img )
+        {
+            std::string exchange = "";
+            if( img < this->noi - 1 && this->n_exchanges_attempted[img] > 0 )
+                exchange = fmt::format("  exchange ratio with next: {:>6.3f}",
+                    (scalar)this->n_exchanges_accepted[img] / (scalar)this->n_exchanges_attempted[img]);
+            block.push_back(fmt::format("    Replica {:>3}: T = {:<10} E = {:20.10f}{}", img,
+                this->systems[img]->mc_parameters->temperature, this->systems[img]->E, exchange));
+        }
+        Log.SendBlock(Log_Level::All, this->SenderName, block, this->idx_image, this->idx_chain);
+
+        // Update time of last step
+        this->t_last = t_current;
+    }
+
+    void Method_PT::Message_End()
+    {
+        //---- End timings
+        auto t_end = system_clock::now();
+
+        //---- Termination reason
+        std::string reason = "";
+        if( this->StopFile_Present() )
+            reason = "A STOP file has been found";
+        else if( this->Walltime_Expired(t_end - this->t_start) )
+            reason = "The maximum walltime has been reached";
+
+        // Update the systems' energies
+        for( auto& system : this->systems )
+            system->UpdateEnergy();
+
+        //---- Log messages
+        std::vector<std::string> block;
+        block.push_back(fmt::format("------------ Terminated {} Calculation ------------", this->Name()));
+        if( reason.length() > 0 )
+            block.push_back(fmt::format("----- Reason:   {}", reason));
+        block.push_back(fmt::format("----- Duration:       {}", Timing::DateTimePassed(t_end - this->t_start)));
+        block.push_back(fmt::format("    Completed         {} / {} step(s)", this->step, this->n_log));
+        block.push_back(fmt::format("    Iteration         {} / {}", this->iteration, this->n_iterations));
+        block.push_back(fmt::format("    Iterations / sec: {}", this->iteration / Timing::SecondsPassed(t_end - this->t_start)));
+        for( int img = 0; img < this->noi; ++img )
+        {
+            std::string exchange = "";
+            if( img < this->noi - 1 && this->n_exchanges_attempted[img] > 0 )
+                exchange = fmt::format("  exchange ratio with next: {:>6.3f}",
+                    (scalar)this->n_exchanges_accepted[img] / (scalar)this->n_exchanges_attempted[img]);
+            block.push_back(fmt::format("    Replica {:>3}: T = {:<10} E = {:20.10f}{}", img,
+                this->systems[img]->mc_parameters->temperature, this->systems[img]->E, exchange));
+        }
+        block.push_back("-----------------------------------------------------");
+        Log.SendBlock(Log_Level::All, this->SenderName, block, this->idx_image, this->idx_chain);
+    }
+
+    void Method_PT::Save_Current(std::string starttime, int iteration, bool initial, bool final)
+    {
+        // History save
+        this->history["max_torque_component"].push_back(this->force_max_abs_component);
+
+        // File save
+        if (this->parameters_mc->output_any)
+        {
+            // Convert indices to formatted strings
+            int base = (int)log10(this->parameters_mc->n_iterations);
+            std::string s_iter = fmt::format("{:0>"+fmt::format("{}",base)+"}", iteration);
+
+            std::string preSpinsFile;
+            std::string preEnergiesFile;
+            std::string fileTag;
+
+            if (this->parameters_mc->output_file_tag == "<time>")
+                fileTag = starttime + "_";
+            else if (this->parameters_mc->output_file_tag != "")
+                fileTag = this->parameters_mc->output_file_tag + "_";
+            else
+                fileTag = "";
+
+            preSpinsFile = this->parameters_mc->output_folder + "/" + fileTag + "PT_Spins";
+            preEnergiesFile = this->parameters_mc->output_folder + "/" + fileTag + "PT_Energies";
+
+            // Update the systems' energies
+            for( auto& system : this->systems )
+                system->UpdateEnergy();
+
+            // Function to write or append the spins of all replicas, one segment per replica
+            auto writeOutputConfigurations = [this, preSpinsFile, iteration](std::string suffix, bool append)
+            {
+                try
+                {
+                    // File name
+                    std::string spinsFile = preSpinsFile + suffix + ".ovf";
+
+                    // File format
+                    IO::VF_FileFormat format = this->parameters_mc->output_vf_filetype;
+
+                    std::string output_comment_base = fmt::format(
+                        "{} simulation\n"
+                        "# Desc:      Iteration: {}",
+                        this->Name(), iteration );
+
+                    auto segment = IO::OVF_Segment(*this->systems[0]);
+                    std::string title = fmt::format( "SPIRIT Version {}", Utility::version_full );
+                    segment.title = strdup(title.c_str());
+                    segment.valuedim = 3;
+                    segment.valuelabels = strdup("spin_x spin_y spin_z");
+                    segment.valueunits  = strdup("none none none");
+                    for( int img = 0; img < this->noi; ++img )
+                    {
+                        auto& spins = *this->systems[img]->spins;
+                        std::string output_comment = fmt::format("{}\n# Desc: Replica {} of {} at T = {}",
+                            output_comment_base, img, this->noi, this->systems[img]->mc_parameters->temperature);
+                        segment.comment = strdup(output_comment.c_str());
+                        if( img == 0 && !append )
+                            IO::OVF_File(spinsFile).write_segment(segment, spins[0].data(), int(format));
+                        else
+                            IO::OVF_File(spinsFile).append_segment(segment, spins[0].data(), int(format));
+                    }
+                }
+                catch( ... )
+                {
+                   spirit_handle_exception_core( "PT output failed" );
+                }
+            };
+
+            // Function to write or append the energies and exchange ratios of all replicas
+            auto writeOutputEnergies = [this, preEnergiesFile, iteration](std::string suffix, bool append)
+            {
+                bool normalize = this->parameters_mc->output_energy_divide_by_nspins;
+                bool readability = this->parameters_mc->output_energy_add_readability_lines;
+
+                // File name
+                std::string energiesFile = preEnergiesFile + suffix + ".txt";
+
+                // Write the header if the file is not appended to or does not exist yet
+                std::vector<std::string> columns{"iteration", "replica", "T", "exchange_ratio", "E_tot"};
+                if (append)
+                {
+                    std::ifstream f(energiesFile);
+                    if (!f.good()) IO::Write_Energy_Header(*this->systems[0], energiesFile, columns, true, normalize, readability);
+                }
+                else
+                    IO::Write_Energy_Header(*this->systems[0], energiesFile, columns, true, normalize, readability);
+
+                scalar nd = 1.0; // nos divide
+                if (normalize) nd = 1.0 / this->nos;
+
+                // The exchange ratio of a replica is that with the next replica in the chain
+                for( int img = 0; img < this->noi; ++img )
+                {
+                    auto& system = *this->systems[img];
+                    scalar ratio = 0;
+                    if( img < this->noi - 1 && this->n_exchanges_attempted[img] > 0 )
+                        ratio = (scalar)this->n_exchanges_accepted[img] / (scalar)this->n_exchanges_attempted[img];
+
+                    std::string line = fmt::format(" {:^20} || {:^20} || {:^20.10f} || {:^20.10f} || {:^20.10f} |",
+                        iteration, img, system.mc_parameters->temperature, ratio, system.E * nd);
+                    for (auto pair : system.E_array)
+                        line += fmt::format("| {:^20.10f} ", pair.second * nd);
+                    line += "\n";
+
+                    if (!readability) std::replace( line.begin(), line.end(), '|', ' ');
+                    IO::Append_String_to_File(line, energiesFile);
+                }
+            };
+
+            // Initial replicas before simulation
+            if (initial && this->parameters_mc->output_initial)
+            {
+                writeOutputConfigurations("-initial", false);
+                writeOutputEnergies("-initial", false);
+            }
+            // Final replicas after simulation
+            else if (final && this->parameters_mc->output_final)
+            {
+                writeOutputConfigurations("-final", false);
+                writeOutputEnergies("-final", false);
+            }
+
+            // Single file output
+            if (this->parameters_mc->output_configuration_step)
+            {
+                writeOutputConfigurations("_" + s_iter, false);
+            }
+            if (this->parameters_mc->output_energy_step)
+            {
+                writeOutputEnergies("_" + s_iter, false);
+            }
+
+            // Archive file output (appending)
+            if (this->parameters_mc->output_configuration_archive)
+            {
+                writeOutputConfigurations("-archive", true);
+            }
+            if (this->parameters_mc->output_energy_archive)
+            {
+                writeOutputEnergies("-archive", true);
+            }
+
+            // Save Log
+            Log.Append_to_File();
+        }
+    }
+
+    void Method_PT::Lock()
+    {
+        this->chain->Lock();
+    }
+
+    void Method_PT::Unlock()
+    {
+        this->chain->Unlock();
+    }
+
+    bool Method_PT::Iterations_Allowed()
+    {
+        return this->chain->iteration_allowed;
+    }
+
+    // Method name as string
+    std::string Method_PT::Name() { return "PT"; }
+}
@@ -1,5 +1,6 @@
 #include <engine/Vectormath.hpp>
 #include <engine/Manifoldmath.hpp>
+#include <engine/Philox.hpp>
 #include <utility/Constants.hpp>
 #include <utility/Logging.hpp>
 #include <utility/Exception.hpp>
@@ -18,24 +19,205 @@ namespace Engine
 {
 namespace Vectormath
 {
+    // Utility function for the SIB Solver: transform of a single spin
+    inline Vector3 sib_transform(const Vector3 & spin, const Vector3 & force)
+    {
+        Vector3 A = 0.5 * force;
+
+        // 1/determinant(A)
+        scalar detAi = 1.0 / (1 + A.squaredNorm());
+
+        // calculate equation without the predictor?
+        Vector3 a2 = spin - spin.cross(A);
+
+        return Vector3{
+            (a2[0] * (A[0] * A[0] + 1   ) + a2[1] * (A[0] * A[1] - A[2]) + a2[2] * (A[0] * A[2] + A[1])) * detAi,
+            (a2[0] * (A[1] * A[0] + A[2]) + a2[1] * (A[1] * A[1] + 1   ) + a2[2] * (A[1] * A[2] - A[0])) * detAi,
+            (a2[0] * (A[2] * A[0] - A[1]) + a2[1] * (A[2] * A[1] + A[0]) + a2[2] * (A[2] * A[2] + 1   )) * detAi };
+    }
+
     // Utility function for the SIB Solver
     void transform(const vectorfield & spins, const vectorfield & force, vectorfield & out)
     {
         #pragma omp parallel for
-        for (unsigned int i = 0; i < spins.size(); ++i)
+        for( int i = 0; i < int(spins.size()); ++i )
+            out[i] = sib_transform(spins[i], force[i]);
+    }
+
+    void sib_predictor(const vectorfield & spins, const vectorfield & force, vectorfield & out)
+    {
+        #pragma omp parallel for
+        for( int i = 0; i < int(spins.size()); ++i )
+            out[i] = 0.5 * (spins[i] + sib_transform(spins[i], force[i]));
+    }
+
+    void explicit_stage(const vectorfield & spins, const vectorfield & spins_stage, const vectorfield & force, const scalar & c, vectorfield & k, vectorfield & out)
+    {
+        #pragma omp parallel for
+        for( int i = 0; i < int(spins.size()); ++i )
+        {
+            k[i]   = -spins_stage[i].cross(force[i]);
+            out[i] = (spins[i] + c * k[i]).normalized();
+        }
+    }
+
+    void heun_corrector(const vectorfield & spins, const vectorfield & k1, const vectorfield & spins_stage, const vectorfield & force, vectorfield & out)
+    {
+        #pragma omp parallel for
+        for( int i = 0; i < int(spins.size()); ++i )
+        {
+            Vector3 k2 = -spins_stage[i].cross(force[i]);
+            out[i] = (spins[i] + 0.5 * (k1[i] + k2)).normalized();
+        }
+    }
+
+    void rk4_corrector(const vectorfield & spins, const vectorfield & k1, const vectorfield & k2, const vectorfield & k3, const vectorfield & spins_stage, const vectorfield & force, vectorfield & out)
+    {
+        #pragma omp parallel for
+        for( int i = 0; i < int(spins.size()); ++i )
+        {
+            Vector3 k4 = -spins_stage[i].cross(force[i]);
+            out[i] = (spins[i] + (1.0/6.0) * (k1[i] + k4) + (1.0/3.0) * (k2[i] + k3[i])).normalized();
+        }
+    }
+
+    void rk23_stage(const vectorfield & spins, const vectorfield & spins_stage, const scalar & c_u, const vectorfield & u, const vectorfield & force, const scalar & c, const scalar & c_next, vectorfield & k, vectorfield & out)
+    {
+        #pragma omp parallel for
+        for( int i = 0; i < int(spins.size()); ++i )
+        {
+            Vector3 omega = c * ( force[i] - force[i].dot(spins_stage[i]) * spins_stage[i] );
+            k[i] = omega - 0.5 * c_u * u[i].cross(omega);
+            Vector3 axis  = c_next * k[i];
+            scalar  angle = axis.norm();
+            if( angle > 0 )
+                rotate(spins[i], axis / angle, angle, out[i]);
+            else
+                out[i] = spins[i];
+        }
+    }
+
+    void rk23_solution(const vectorfield & spins, const vectorfield & k1, const vectorfield & k2, const vectorfield & spins_stage, const vectorfield & force, const scalar & c, vectorfield & k3, vectorfield & u, vectorfield & out)
+    {
+        #pragma omp parallel for
+        for( int i = 0; i < int(spins.size()); ++i )
+        {
+            Vector3 omega = c * ( force[i] - force[i].dot(spins_stage[i]) * spins_stage[i] );
+            k3[i] = omega - 0.375 * k2[i].cross(omega);
+            u[i]  = (2.0/9.0) * k1[i] + (1.0/3.0) * k2[i] + (4.0/9.0) * k3[i];
+            scalar angle = u[i].norm();
+            if( angle > 0 )
+                rotate(spins[i], u[i] / angle, angle, out[i]);
+            else
+                out[i] = spins[i];
+        }
+    }
+
+    void rk23_error(const vectorfield & k1, const vectorfield & k2, const vectorfield & k3, const vectorfield & u, const vectorfield & spins_new, const vectorfield & force, const scalar & c, vectorfield & error)
+    {
+        #pragma omp parallel for
+        for( int i = 0; i < int(u.size()); ++i )
+        {
+            Vector3 omega = c * ( force[i] - force[i].dot(spins_new[i]) * spins_new[i] );
+            Vector3 k4 = omega - 0.5 * u[i].cross(omega);
+            error[i] = u[i] - ((7.0/24.0) * k1[i] + 0.25 * k2[i] + (1.0/3.0) * k3[i] + 0.125 * k4);
+        }
+    }
+
+    void depondt_rotate(const vectorfield & spins, const vectorfield & force, vectorfield & out)
+    {
+        #pragma omp parallel for
+        for( int i = 0; i < int(spins.size()); ++i )
+        {
+            scalar angle = force[i].norm();
+            if( angle > 0 )
+                rotate(spins[i], force[i] / angle, angle, out[i]);
+            else
+                out[i] = spins[i];
+        }
+    }
+
+    void depondt_rotate(const vectorfield & spins, const scalar & c1, const vectorfield & force_1, const scalar & c2, const vectorfield & force_2, vectorfield & out)
+    {
+        #pragma omp parallel for
+        for( int i = 0; i < int(spins.size()); ++i )
+        {
+            Vector3 axis  = c1 * force_1[i] + c2 * force_2[i];
+            scalar  angle = axis.norm();
+            if( angle > 0 )
+                rotate(spins[i], axis / angle, angle, out[i]);
+            else
+                out[i] = spins[i];
+        }
+    }
+
+    void geodesic_step(vectorfield & spins, vectorfield & step)
+    {
+        #pragma omp parallel for
+        for( int i = 0; i < int(spins.size()); ++i )
+        {
+            scalar angle = step[i].norm();
+            if( angle > 0 )
+            {
+                Vector3 direction = step[i] / angle;
+                Vector3 spin = spins[i];
+                spins[i] = ( spin * std::cos(angle) + direction * std::sin(angle) ).normalized();
+                step[i]  = angle * ( direction * std::cos(angle) - spin * std::sin(angle) );
+            }
+        }
+    }
+
+    namespace
+    {
+        // The active STT and thermal terms are chosen at compile time, so that inactive terms cost nothing
+        template<bool stt_gradient, bool stt_monolayer, bool temperature>
+        void llg_force_virtual(const vectorfield & spins, const vectorfield & force, const scalarfield & mu_s, const intfield & mask_unpinned,
+            const scalar & dtg, const scalar & damping, const vectorfield & s_c_grad, const Vector3 & s_c_vec,
+            const scalar & stt_c_a, const scalar & stt_c_cross, const vectorfield & xi, vectorfield & force_virtual)
         {
-            Vector3 A = 0.5 * force[i];
+            #pragma omp parallel for
+            for( int i = 0; i < int(spins.size()); ++i )
+            {
+                const Vector3 & spin = spins[i];
+                Vector3 f = dtg / mu_s[i] * ( force[i] + damping * spin.cross(force[i]) );
 
-            // 1/determinant(A)
-            scalar detAi = 1.0 / (1 + A.squaredNorm());
+                if( stt_gradient )
+                    f += stt_c_a * s_c_grad[i] + stt_c_cross * s_c_grad[i].cross(spin);
+                if( stt_monolayer )
+                    f += stt_c_a * s_c_vec + stt_c_cross * s_c_vec.cross(spin);
+                if( temperature )
+                    f += xi[i] + damping * spin.cross(xi[i]);
 
-            // calculate equation without the predictor?
-            Vector3 a2 = spins[i] - spins[i].cross(A);
+                #ifdef SPIRIT_ENABLE_PINNING
+                    f *= scalar(mask_unpinned[i]);
+                #endif // SPIRIT_ENABLE_PINNING
 
-            out[i][0] = (a2[0] * (A[0] * A[0] + 1   ) + a2[1] * (A[0] * A[1] - A[2]) + a2[2] * (A[0] * A[2] + A[1])) * detAi;
-            out[i][1] = (a2[0] * (A[1] * A[0] + A[2]) + a2[1] * (A[1] * A[1] + 1   ) + a2[2] * (A[1] * A[2] - A[0])) * detAi;
-            out[i][2] = (a2[0] * (A[2] * A[0] - A[1]) + a2[1] * (A[2] * A[1] + A[0]) + a2[2] * (A[2] * A[2] + 1   )) * detAi;
+                force_virtual[i] = f;
+            }
         }
+
+        template<bool stt_gradient, bool stt_monolayer>
+        void llg_force_virtual(bool temperature, const vectorfield & spins, const vectorfield & force, const scalarfield & mu_s, const intfield & mask_unpinned,
+            const scalar & dtg, const scalar & damping, const vectorfield & s_c_grad, const Vector3 & s_c_vec,
+            const scalar & stt_c_a, const scalar & stt_c_cross, const vectorfield & xi, vectorfield & force_virtual)
+        {
+            if( temperature )
+                llg_force_virtual<stt_gradient, stt_monolayer, true>(spins, force, mu_s, mask_unpinned, dtg, damping, s_c_grad, s_c_vec, stt_c_a, stt_c_cross, xi, force_virtual);
+            else
+                llg_force_virtual<stt_gradient, stt_monolayer, false>(spins, force, mu_s, mask_unpinned, dtg, damping, s_c_grad, s_c_vec, stt_c_a, stt_c_cross, xi, force_virtual);
+        }
+    }
+
+    void llg_force_virtual(const vectorfield & spins, const vectorfield & force, const scalarfield & mu_s, const intfield & mask_unpinned,
+        const scalar & dtg, const scalar & damping, bool stt_gradient, const vectorfield & s_c_grad, bool stt_monolayer, const Vector3 & s_c_vec,
+        const scalar & stt_c_a, const scalar & stt_c_cross, bool temperature, const vectorfield & xi, vectorfield & force_virtual)
+    {
+        if( stt_gradient )
+            llg_force_virtual<true, false>(temperature, spins, force, mu_s, mask_unpinned, dtg, damping, s_c_grad, s_c_vec, stt_c_a, stt_c_cross, xi, force_virtual);
+        else if( stt_monolayer )
+            llg_force_virtual<false, true>(temperature, spins, force, mu_s, mask_unpinned, dtg, damping, s_c_grad, s_c_vec, stt_c_a, stt_c_cross, xi, force_virtual);
+        else
+            llg_force_virtual<false, false>(temperature, spins, force, mu_s, mask_unpinned, dtg, damping, s_c_grad, s_c_vec, stt_c_a, stt_c_cross, xi, force_virtual);
     }
 
     void get_random_vector(std::uniform_real_distribution<scalar> & distribution, std::mt19937 & prng, Vector3 & vec)
@@ -47,13 +229,16 @@ namespace Vectormath
     }
     void get_random_vectorfield(std::mt19937 & prng, vectorfield & xi)
     {
-        // PRNG gives RN [-1,1] -> multiply with epsilon
-        auto distribution = std::uniform_real_distribution<scalar>(-1, 1);
-        // TODO: parallelization of this is actually not quite so trivial
+        // The PRNG only provides the key of a counter-based PRNG, which gives every vector
+        //      its own random numbers, so that the loop can run in parallel
+        const Philox::Key key{ { std::uint32_t(prng()), std::uint32_t(prng()) } };
+        // RN [-1,1] -> multiply with epsilon
         #pragma omp parallel for
-        for (unsigned int i = 0; i < xi.size(); ++i)
+        for( int i = 0; i < int(xi.size()); ++i )
         {
-            get_random_vector(distribution, prng, xi[i]);
+            auto bits = Philox::philox4x32(Philox::Counter{ { std::uint32_t(i), 0, 0, 0 } }, key);
+            for( int dim = 0; dim < 3; ++dim )
+                xi[i][dim] = 2 * Philox::uniform(bits[dim]) - 1;
         }
     }
 
@@ -70,13 +255,21 @@ namespace Vectormath
     }
     void get_random_vectorfield_unitsphere(std::mt19937 & prng, vectorfield & xi)
     {
-        // PRNG gives RN [-1,1] -> multiply with epsilon
-        auto distribution = std::uniform_real_distribution<scalar>(-1, 1);
-        // TODO: parallelization of this is actually not quite so trivial
+        // The PRNG only provides the key of a counter-based PRNG, which gives every vector
+        //      its own random numbers, so that the loop can run in parallel
+        const Philox::Key key{ { std::uint32_t(prng()), std::uint32_t(prng()) } };
         #pragma omp parallel for
-        for (unsigned int i = 0; i < xi.size(); ++i)
+        for( int i = 0; i < int(xi.size()); ++i )
         {
-            get_random_vector_unitsphere(distribution, prng, xi[i]);
+            auto bits = Philox::philox4x32(Philox::Counter{ { std::uint32_t(i), 0, 0, 0 } }, key);
+            scalar v_z = 2 * Philox::uniform(bits[0]) - 1;
+            scalar phi = ( 2 * Philox::uniform(bits[1]) - 1 ) * Pi;
+
+            scalar r_xy = std::sqrt(1 - v_z*v_z);
+
+            xi[i][0] = r_xy * std::cos(phi);
+            xi[i][1] = r_xy * std::sin(phi);
+            xi[i][2] = v_z;
         }
     }
 
@@ -481,105 +674,46 @@ namespace Vectormath
 
     scalar TopologicalCharge(const vectorfield & vf, const Data::Geometry & geometry, const intfield & boundary_conditions)
     {
-        // This implementations assumes
-        // 1. No basis atom lies outside the cell spanned by the basis vectors of the lattice
-        // 2. The geometry is a plane in x and y and spanned by the first 2 basis_vectors of the lattice
-        // 3. The first basis atom lies at (0,0)
+        // The triangles are calculated only once per geometry and oriented counter-clockwise
+        auto spin_triangles = geometry.spin_triangles(boundary_conditions);
+        const auto & triangles = *spin_triangles;
+        const int n_triangles = triangles.size();
 
-        const auto & positions = geometry.positions;
         scalar charge = 0;
-
-        // Compute Delaunay for unitcell + basis with neighbouring lattice sites in directions a, b, and a+b
-        std::vector<Data::vector2_t> basis_cell_points(geometry.n_cell_atoms + 3);
-        for(int i = 0; i < geometry.n_cell_atoms; i++)
+        #pragma omp parallel for reduction(+:charge)
+        for( int itri = 0; itri < n_triangles; ++itri )
         {
-            basis_cell_points[i].x = double(positions[i][0]);
-            basis_cell_points[i].y = double(positions[i][1]);
+            const auto & tri = triangles[itri];
+            charge += solid_angle_2(vf[tri[0]], vf[tri[1]], vf[tri[2]]);
         }
+        return charge / (4*Pi);
+    }
 
-        // To avoid cases where the basis atoms lie on the boundary of the convex hull the corners of the parallelogram
-        // spanned by the lattice sites 0, a, b and a+b are stretched away from the center for the triangulation
-        scalar stretch_factor = 0.1;
-
-        // For the rare case where the first basis atoms does not lie at (0,0,0)
-        Vector3 basis_offset = positions[0];
-
-        Vector3 ta = geometry.lattice_constant * geometry.bravais_vectors[0];
-        Vector3 tb = geometry.lattice_constant * geometry.bravais_vectors[1];
-        Vector3 tc = geometry.lattice_constant * geometry.bravais_vectors[2];
-
-        // basis_cell_points[0] coincides with the '0' lattice site (plus basis_offset)
-        basis_cell_points[0].x -= stretch_factor * (ta + tb)[0];
-        basis_cell_points[0].y -= stretch_factor * (ta + tb)[1];
-
-        // a+b
-        basis_cell_points[geometry.n_cell_atoms].x   = double((ta + tb + positions[0] + stretch_factor * (ta + tb))[0]);
-        basis_cell_points[geometry.n_cell_atoms].y   = double((ta + tb + positions[0] + stretch_factor * (ta + tb))[1]);
-        // b
-        basis_cell_points[geometry.n_cell_atoms+1].x = double((tb + positions[0] - stretch_factor * (ta - tb))[0]);
-        basis_cell_points[geometry.n_cell_atoms+1].y = double((tb + positions[0] - stretch_factor * (ta - tb))[1]);
-        // a
-        basis_cell_points[geometry.n_cell_atoms+2].x = double((ta + positions[0] + stretch_factor * (ta - tb))[0]);
-        basis_cell_points[geometry.n_cell_atoms+2].y = double((ta + positions[0] + stretch_factor * (ta - tb))[1]);
+    scalar TopologicalChargeDensity(const vectorfield & vf, const Data::Geometry & geometry, const intfield & boundary_conditions, scalarfield & charge_density)
+    {
+        auto spin_triangles = geometry.spin_triangles(boundary_conditions);
+        const auto & triangles = *spin_triangles;
+        const int n_triangles = triangles.size();
 
-        std::vector<Data::triangle_t> triangulation;
-        triangulation = Data::compute_delaunay_triangulation_2D(basis_cell_points);
+        // Charge of the individual triangles
+        scalarfield triangle_charge(n_triangles);
+        #pragma omp parallel for
+        for( int itri = 0; itri < n_triangles; ++itri )
+        {
+            const auto & tri = triangles[itri];
+            triangle_charge[itri] = solid_angle_2(vf[tri[0]], vf[tri[1]], vf[tri[2]]) / (4*Pi);
+        }
 
-        for(Data::triangle_t tri : triangulation)
+        // Each spin gets a third of the charge of the triangles it is a corner of
+        charge_density = scalarfield(vf.size(), 0);
+        scalar charge = 0;
+        for( int itri = 0; itri < n_triangles; ++itri )
         {
-            // Compute the sign of this triangle
-            Vector3 triangle_normal;
-            vectorfield tri_positions(3);
-            for(int i=0; i<3; i++)
-                tri_positions[i] = {scalar(basis_cell_points[tri[i]].x), scalar(basis_cell_points[tri[i]].y), scalar(0)};
-            triangle_normal = (tri_positions[0]-tri_positions[1]).cross(tri_positions[0] - tri_positions[2]);
-            triangle_normal.normalize();
-            scalar sign = triangle_normal[2]/std::abs(triangle_normal[2]);
-
-            // We try to apply the Delaunay triangulation at each bravais-lattice point
-            // For each corner of the triangle we check wether it is "allowed" (which means either inside the simulation box or permitted by periodic boundary conditions)
-            // Then we can add the top charge for all trios of spins connected by this triangle
-            for(int b = 0; b < geometry.n_cells[1]; ++b)
-            {
-                for(int a = 0; a < geometry.n_cells[0]; ++a)
-                {
-                    std::array<Vector3, 3> tri_spins;
-                    // bools to check wether it is allowed to take the next lattice site in direction a, b or a+b
-                    bool a_next_allowed = (a+1 < geometry.n_cells[0] || boundary_conditions[0]);
-                    bool b_next_allowed = (b+1 < geometry.n_cells[1] || boundary_conditions[1]);
-                    bool valid_triangle = true;
-                    for(int i = 0; i<3; ++i)
-                    {
-                        int idx;
-                        if(tri[i] < geometry.n_cell_atoms) // tri[i] is an index of a basis atom, no wrap around can occur
-                        {
-                            idx = (tri[i] + a * geometry.n_cell_atoms + b * geometry.n_cell_atoms * geometry.n_cells[0]);
-                        }
-                        else if (tri[i] == geometry.n_cell_atoms + 2 && a_next_allowed) // Translation by a
-                        {
-                            idx = ((a + 1) % geometry.n_cells[0]) * geometry.n_cell_atoms + b * geometry.n_cell_atoms * geometry.n_cells[0];
-                        }
-                        else if (tri[i] == geometry.n_cell_atoms + 1 && b_next_allowed) // Translation by b
-                        {
-                            idx = a * geometry.n_cell_atoms + ((b + 1) % geometry.n_cells[1]) * geometry.n_cell_atoms * geometry.n_cells[0];
-                        }
-                        else if (tri[i] == geometry.n_cell_atoms && a_next_allowed && b_next_allowed) // Translation by a + b
-                        {
-                            idx = ((a + 1) % geometry.n_cells[0]) * geometry.n_cell_atoms + ((b + 1) % geometry.n_cells[1]) * geometry.n_cell_atoms * geometry.n_cells[0];
-                        }
-                        else // Translation not allowed, skip to next triangle
-                        {
-                            valid_triangle = false;
-                            break;
-                        }
-                        tri_spins[i] = vf[idx];
-                    }
-                    if(valid_triangle)
-                        charge += sign * solid_angle_2(tri_spins[0], tri_spins[1], tri_spins[2]);
-                }
-            }
+            for( int i = 0; i < 3; ++i )
+                charge_density[triangles[itri][i]] += triangle_charge[itri] / 3;
+            charge += triangle_charge[itri];
         }
-        return charge / (4*Pi);
+        return charge;
     }
 
     void get_gradient_distribution(const Data::Geometry & geometry, Vector3 gradient_direction, scalar gradient_start, scalar gradient_inclination, scalarfield & distribution, scalar range_min, scalar range_max)
@@ -25,32 +25,241 @@ namespace Engine
 {
     namespace Vectormath
     {
+        // Utility function for the SIB Solver: transform of a single spin
+        __device__ Vector3 cu_sib_transform(const Vector3 & e1, const Vector3 & force)
+        {
+            Vector3 A = 0.5 * force;
+
+            // 1/determinant(A)
+            scalar detAi = 1.0 / (1 + A.squaredNorm());
+
+            // calculate equation without the predictor?
+            Vector3 a2 = e1 - e1.cross(A);
+
+            return Vector3{
+                (a2[0] * (A[0] * A[0] + 1   ) + a2[1] * (A[0] * A[1] - A[2]) + a2[2] * (A[0] * A[2] + A[1])) * detAi,
+                (a2[0] * (A[1] * A[0] + A[2]) + a2[1] * (A[1] * A[1] + 1   ) + a2[2] * (A[1] * A[2] - A[0])) * detAi,
+                (a2[0] * (A[2] * A[0] - A[1]) + a2[1] * (A[2] * A[1] + A[0]) + a2[2] * (A[2] * A[2] + 1   )) * detAi };
+        }
+
         // Utility function for the SIB Solver
         __global__ void cu_transform(const Vector3 * spins, const Vector3 * force, Vector3 * out, size_t N)
         {
             int idx = blockIdx.x * blockDim.x + threadIdx.x;
-            Vector3 e1, a2, A;
-            scalar detAi;
+            if(idx < N)
+                out[idx] = cu_sib_transform(spins[idx], force[idx]);
+        }
+        void transform(const vectorfield & spins, const vectorfield & force, vectorfield & out)
+        {
+            int n = spins.size();
+            cu_transform<<<(n+1023)/1024, 1024>>>(spins.data(), force.data(), out.data(), n);
+            CU_CHECK_AND_SYNC();
+        }
+
+        __global__ void cu_sib_predictor(const Vector3 * spins, const Vector3 * force, Vector3 * out, size_t N)
+        {
+            int idx = blockIdx.x * blockDim.x + threadIdx.x;
+            if(idx < N)
+                out[idx] = 0.5 * ( spins[idx] + cu_sib_transform(spins[idx], force[idx]) );
+        }
+        void sib_predictor(const vectorfield & spins, const vectorfield & force, vectorfield & out)
+        {
+            int n = spins.size();
+            cu_sib_predictor<<<(n+1023)/1024, 1024>>>(spins.data(), force.data(), out.data(), n);
+            CU_CHECK_AND_SYNC();
+        }
+
+        __global__ void cu_explicit_stage(const Vector3 * spins, const Vector3 * spins_stage, const Vector3 * force, const scalar c, Vector3 * k, Vector3 * out, size_t N)
+        {
+            int idx = blockIdx.x * blockDim.x + threadIdx.x;
             if(idx < N)
             {
-                e1 = spins[idx];
-                A = 0.5 * force[idx];
+                Vector3 k_i = -spins_stage[idx].cross(force[idx]);
+                k[idx]   = k_i;
+                out[idx] = (spins[idx] + c * k_i).normalized();
+            }
+        }
+        void explicit_stage(const vectorfield & spins, const vectorfield & spins_stage, const vectorfield & force, const scalar & c, vectorfield & k, vectorfield & out)
+        {
+            int n = spins.size();
+            cu_explicit_stage<<<(n+1023)/1024, 1024>>>(spins.data(), spins_stage.data(), force.data(), c, k.data(), out.data(), n);
+            CU_CHECK_AND_SYNC();
+        }
 
-                // 1/determinant(A)
-                detAi = 1.0 / (1 + pow(A.norm(), 2));
+        __global__ void cu_heun_corrector(const Vector3 * spins, const Vector3 * k1, const Vector3 * spins_stage, const Vector3 * force, Vector3 * out, size_t N)
+        {
+            int idx = blockIdx.x * blockDim.x + threadIdx.x;
+            if(idx < N)
+            {
+                Vector3 k2 = -spins_stage[idx].cross(force[idx]);
+                out[idx] = (spins[idx] + 0.5 * (k1[idx] + k2)).normalized();
+            }
+        }
+        void heun_corrector(const vectorfield & spins, const vectorfield & k1, const vectorfield & spins_stage, const vectorfield & force, vectorfield & out)
+        {
+            int n = spins.size();
+            cu_heun_corrector<<<(n+1023)/1024, 1024>>>(spins.data(), k1.data(), spins_stage.data(), force.data(), out.data(), n);
+            CU_CHECK_AND_SYNC();
+        }
+
+        __global__ void cu_rk4_corrector(const Vector3 * spins, const Vector3 * k1, const Vector3 * k2, const Vector3 * k3, const Vector3 * spins_stage, const Vector3 * force, Vector3 * out, size_t N)
+        {
+            int idx = blockIdx.x * blockDim.x + threadIdx.x;
+            if(idx < N)
+            {
+                Vector3 k4 = -spins_stage[idx].cross(force[idx]);
+                out[idx] = (spins[idx] + (1.0/6.0) * (k1[idx] + k4) + (1.0/3.0) * (k2[idx] + k3[idx])).normalized();
+            }
+        }
+        void rk4_corrector(const vectorfield & spins, const vectorfield & k1, const vectorfield & k2, const vectorfield & k3, const vectorfield & spins_stage, const vectorfield & force, vectorfield & out)
+        {
+            int n = spins.size();
+            cu_rk4_corrector<<<(n+1023)/1024, 1024>>>(spins.data(), k1.data(), k2.data(), k3.data(), spins_stage.data(), force.data(), out.data(), n);
+            CU_CHECK_AND_SYNC();
+        }
 
-                // calculate equation without the predictor?
-                a2 = e1 - e1.cross(A);
+        __device__ Vector3 cu_rotate_by(const Vector3 & v, const Vector3 & rotation)
+        {
+            scalar angle = rotation.norm();
+            if( angle > 0 )
+            {
+                Vector3 axis = rotation / angle;
+                return v * cos(angle) + axis.cross(v) * sin(angle) + axis * axis.dot(v) * (1 - cos(angle));
+            }
+            return v;
+        }
 
-                out[idx][0] = (a2[0] * (A[0] * A[0] + 1   ) + a2[1] * (A[0] * A[1] - A[2]) + a2[2] * (A[0] * A[2] + A[1])) * detAi;
-                out[idx][1] = (a2[0] * (A[1] * A[0] + A[2]) + a2[1] * (A[1] * A[1] + 1   ) + a2[2] * (A[1] * A[2] - A[0])) * detAi;
-                out[idx][2] = (a2[0] * (A[2] * A[0] - A[1]) + a2[1] * (A[2] * A[1] + A[0]) + a2[2] * (A[2] * A[2] + 1   )) * detAi;
+        __global__ void cu_rk23_stage(const Vector3 * spins, const Vector3 * spins_stage, const scalar c_u, const Vector3 * u, const Vector3 * force, const scalar c, const scalar c_next, Vector3 * k, Vector3 * out, size_t N)
+        {
+            int idx = blockIdx.x * blockDim.x + threadIdx.x;
+            if(idx < N)
+            {
+                Vector3 omega = c * ( force[idx] - force[idx].dot(spins_stage[idx]) * spins_stage[idx] );
+                k[idx]   = omega - 0.5 * c_u * u[idx].cross(omega);
+                out[idx] = cu_rotate_by(spins[idx], c_next * k[idx]);
             }
         }
-        void transform(const vectorfield & spins, const vectorfield & force, vectorfield & out)
+        void rk23_stage(const vectorfield & spins, const vectorfield & spins_stage, const scalar & c_u, const vectorfield & u, const vectorfield & force, const scalar & c, const scalar & c_next, vectorfield & k, vectorfield & out)
         {
             int n = spins.size();
-            cu_transform<<<(n+1023)/1024, 1024>>>(spins.data(), force.data(), out.data(), n);
+            cu_rk23_stage<<<(n+1023)/1024, 1024>>>(spins.data(), spins_stage.data(), c_u, u.data(), force.data(), c, c_next, k.data(), out.data(), n);
+            CU_CHECK_AND_SYNC();
+        }
+
+        __global__ void cu_rk23_solution(const Vector3 * spins, const Vector3 * k1, const Vector3 * k2, const Vector3 * spins_stage, const Vector3 * force, const scalar c, Vector3 * k3, Vector3 * u, Vector3 * out, size_t N)
+        {
+            int idx = blockIdx.x * blockDim.x + threadIdx.x;
+            if(idx < N)
+            {
+                Vector3 omega = c * ( force[idx] - force[idx].dot(spins_stage[idx]) * spins_stage[idx] );
+                k3[idx]  = omega - 0.375 * k2[idx].cross(omega);
+                u[idx]   = (2.0/9.0) * k1[idx] + (1.0/3.0) * k2[idx] + (4.0/9.0) * k3[idx];
+                out[idx] = cu_rotate_by(spins[idx], u[idx]);
+            }
+        }
+        void rk23_solution(const vectorfield & spins, const vectorfield & k1, const vectorfield & k2, const vectorfield & spins_stage, const vectorfield & force, const scalar & c, vectorfield & k3, vectorfield & u, vectorfield & out)
+        {
+            int n = spins.size();
+            cu_rk23_solution<<<(n+1023)/1024, 1024>>>(spins.data(), k1.data(), k2.data(), spins_stage.data(), force.data(), c, k3.data(), u.data(), out.data(), n);
+            CU_CHECK_AND_SYNC();
+        }
+
+        __global__ void cu_rk23_error(const Vector3 * k1, const Vector3 * k2, const Vector3 * k3, const Vector3 * u, const Vector3 * spins_new, const Vector3 * force, const scalar c, Vector3 * error, size_t N)
+        {
+            int idx = blockIdx.x * blockDim.x + threadIdx.x;
+            if(idx < N)
+            {
+                Vector3 omega = c * ( force[idx] - force[idx].dot(spins_new[idx]) * spins_new[idx] );
+                Vector3 k4 = omega - 0.5 * u[idx].cross(omega);
+                error[idx] = u[idx] - ((7.0/24.0) * k1[idx] + 0.25 * k2[idx] + (1.0/3.0) * k3[idx] + 0.125 * k4);
+            }
+        }
+        void rk23_error(const vectorfield & k1, const vectorfield & k2, const vectorfield & k3, const vectorfield & u, const vectorfield & spins_new, const vectorfield & force, const scalar & c, vectorfield & error)
+        {
+            int n = u.size();
+            cu_rk23_error<<<(n+1023)/1024, 1024>>>(k1.data(), k2.data(), k3.data(), u.data(), spins_new.data(), force.data(), c, error.data(), n);
+            CU_CHECK_AND_SYNC();
+        }
+
+        __global__ void cu_depondt_rotate(const Vector3 * spins, const Vector3 * force, Vector3 * out, size_t N)
+        {
+            int idx = blockIdx.x * blockDim.x + threadIdx.x;
+            if(idx < N)
+                out[idx] = cu_rotate_by(spins[idx], force[idx]);
+        }
+        void depondt_rotate(const vectorfield & spins, const vectorfield & force, vectorfield & out)
+        {
+            int n = spins.size();
+            cu_depondt_rotate<<<(n+1023)/1024, 1024>>>(spins.data(), force.data(), out.data(), n);
+            CU_CHECK_AND_SYNC();
+        }
+
+        __global__ void cu_depondt_rotate(const Vector3 * spins, const scalar c1, const Vector3 * force_1, const scalar c2, const Vector3 * force_2, Vector3 * out, size_t N)
+        {
+            int idx = blockIdx.x * blockDim.x + threadIdx.x;
+            if(idx < N)
+                out[idx] = cu_rotate_by(spins[idx], c1 * force_1[idx] + c2 * force_2[idx]);
+        }
+        void depondt_rotate(const vectorfield & spins, const scalar & c1, const vectorfield & force_1, const scalar & c2, const vectorfield & force_2, vectorfield & out)
+        {
+            int n = spins.size();
+            cu_depondt_rotate<<<(n+1023)/1024, 1024>>>(spins.data(), c1, force_1.data(), c2, force_2.data(), out.data(), n);
+            CU_CHECK_AND_SYNC();
+        }
+
+        __global__ void cu_geodesic_step(Vector3 * spins, Vector3 * step, size_t N)
+        {
+            int idx = blockIdx.x * blockDim.x + threadIdx.x;
+            if(idx < N)
+            {
+                scalar angle = step[idx].norm();
+                if( angle > 0 )
+                {
+                    Vector3 direction = step[idx] / angle;
+                    Vector3 spin = spins[idx];
+                    spins[idx] = ( spin * cos(angle) + direction * sin(angle) ).normalized();
+                    step[idx]  = angle * ( direction * cos(angle) - spin * sin(angle) );
+                }
+            }
+        }
+        void geodesic_step(vectorfield & spins, vectorfield & step)
+        {
+            int n = spins.size();
+            cu_geodesic_step<<<(n+1023)/1024, 1024>>>(spins.data(), step.data(), n);
+            CU_CHECK_AND_SYNC();
+        }
+
+        __global__ void cu_llg_force_virtual(const Vector3 * spins, const Vector3 * force, const scalar * mu_s, const int * mask_unpinned,
+            const scalar dtg, const scalar damping, bool stt_gradient, const Vector3 * s_c_grad, bool stt_monolayer, const Vector3 s_c_vec,
+            const scalar stt_c_a, const scalar stt_c_cross, bool temperature, const Vector3 * xi, Vector3 * force_virtual, size_t N)
+        {
+            int idx = blockIdx.x * blockDim.x + threadIdx.x;
+            if(idx < N)
+            {
+                Vector3 spin = spins[idx];
+                Vector3 f = dtg / mu_s[idx] * ( force[idx] + damping * spin.cross(force[idx]) );
+
+                if( stt_gradient )
+                    f += stt_c_a * s_c_grad[idx] + stt_c_cross * s_c_grad[idx].cross(spin);
+                if( stt_monolayer )
+                    f += stt_c_a * s_c_vec + stt_c_cross * s_c_vec.cross(spin);
+                if( temperature )
+                    f += xi[idx] + damping * spin.cross(xi[idx]);
+
+                #ifdef SPIRIT_ENABLE_PINNING
+                    f *= scalar(mask_unpinned[idx]);
+                #endif // SPIRIT_ENABLE_PINNING
+
+                force_virtual[idx] = f;
+            }
+        }
+        void llg_force_virtual(const vectorfield & spins, const vectorfield & force, const scalarfield & mu_s, const intfield & mask_unpinned,
+            const scalar & dtg, const scalar & damping, bool stt_gradient, const vectorfield & s_c_grad, bool stt_monolayer, const Vector3 & s_c_vec,
+            const scalar & stt_c_a, const scalar & stt_c_cross, bool temperature, const vectorfield & xi, vectorfield & force_virtual)
+        {
+            int n = spins.size();
+            cu_llg_force_virtual<<<(n+1023)/1024, 1024>>>(spins.data(), force.data(), mu_s.data(), mask_unpinned.data(),
+                dtg, damping, stt_gradient, s_c_grad.data(), stt_monolayer, s_c_vec, stt_c_a, stt_c_cross, temperature, xi.data(), force_virtual.data(), n);
             CU_CHECK_AND_SYNC();
         }
 
@@ -145,6 +145,34 @@ namespace IO
     }// End Log_Levels_from_Config
 
 
+    void FFT_from_Config(const std::string configFile)
+    {
+        // The FFTW wisdom is shared by the whole process, so the file is set once per State
+        std::string fftw_wisdom = "";
+
+        //------------------------------- Parser --------------------------------
+        if( configFile != "" )
+        {
+            try
+            {
+                IO::Filter_File_Handle myfile(configFile);
+
+                // File in which the FFTW wisdom is kept
+                myfile.Read_String(fftw_wisdom, "ddi_fftw_wisdom");
+            }// end try
+            catch( ... )
+            {
+                spirit_rethrow(	fmt::format("Failed to read FFT parameters from file \"{}\". Leaving values at default.", configFile) );
+            }
+        }
+
+        if( !fftw_wisdom.empty() )
+            Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("FFTW wisdom file       = \"{}\"", fftw_wisdom));
+
+        Engine::FFT::Set_Wisdom_File(fftw_wisdom);
+    }// End FFT_from_Config
+
+
     std::unique_ptr<Data::Spin_System> Spin_System_from_Config(std::string configFile)
     {
         // Parse
@@ -691,6 +719,9 @@ namespace IO
                 myfile.Read_Single(parameters->n_iterations, "llg_n_iterations");
                 myfile.Read_Single(parameters->n_iterations_log, "llg_n_iterations_log");
                 myfile.Read_Single(parameters->dt, "llg_dt");
+                myfile.Read_Single(parameters->dt_tolerance, "llg_dt_tolerance");
+                myfile.Read_Single(parameters->dt_min, "llg_dt_min");
+                myfile.Read_Single(parameters->dt_max, "llg_dt_max");
                 myfile.Read_Single(parameters->temperature, "llg_temperature");
                 myfile.Read_Vector3(parameters->temperature_gradient_direction, "llg_temperature_gradient_direction");
                 parameters->temperature_gradient_direction.normalize();
@@ -703,6 +734,8 @@ namespace IO
                 myfile.Read_Vector3(parameters->stt_polarisation_normal, "llg_stt_polarisation_normal");
                 parameters->stt_polarisation_normal.normalize();
                 myfile.Read_Single(parameters->force_convergence, "llg_force_convergence");
+                myfile.Read_Single(parameters->lbfgs_memory, "llg_lbfgs_memory");
+                myfile.Read_Single(parameters->lbfgs_max_rotation, "llg_lbfgs_max_rotation");
             }
             catch( ... )
             {
@@ -717,6 +750,9 @@ namespace IO
         Log(Log_Level::Parameter, Log_Sender::IO, "Parameters LLG:");
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "seed", parameters->rng_seed));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "time step [ps]", parameters->dt));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "time step tolerance", parameters->dt_tolerance));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "min. time step [ps]", parameters->dt_min));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "max. time step [ps]", parameters->dt_max));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "temperature [K]", parameters->temperature));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "temperature gradient direction", parameters->temperature_gradient_direction.transpose()));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "temperature gradient inclination", parameters->temperature_gradient_inclination));
@@ -726,6 +762,8 @@ namespace IO
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "stt magnitude", parameters->stt_magnitude));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "stt normal", parameters->stt_polarisation_normal.transpose()));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {:e}", "force convergence", parameters->force_convergence));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "lbfgs memory", parameters->lbfgs_memory));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "lbfgs max rotation", parameters->lbfgs_max_rotation));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "maximum walltime", str_max_walltime));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "n_iterations", parameters->n_iterations));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "n_iterations_log", parameters->n_iterations_log));
@@ -783,6 +821,8 @@ namespace IO
                 myfile.Read_Single(parameters->n_mode_follow, "ema_n_mode_follow");
                 myfile.Read_Single(parameters->frequency, "ema_frequency");
                 myfile.Read_Single(parameters->amplitude, "ema_amplitude");
+                myfile.Read_Single(parameters->sparse, "ema_sparse");
+                myfile.Read_Single(parameters->matrix_free, "ema_matrix_free");
             }
             catch( ... )
             {
@@ -799,6 +839,8 @@ namespace IO
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "n_mode_follow", parameters->n_mode_follow));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "frequency", parameters->frequency));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "amplitude", parameters->amplitude));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "sparse", parameters->sparse));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "matrix_free", parameters->matrix_free));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "n_iterations_log", parameters->n_iterations_log));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "n_iterations", parameters->n_iterations));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "maximum walltime", str_max_walltime));
@@ -863,6 +905,10 @@ namespace IO
                 myfile.Read_Single(parameters->n_iterations_log, "mc_n_iterations_log");
                 myfile.Read_Single(parameters->temperature, "mc_temperature");
                 myfile.Read_Single(parameters->acceptance_ratio_target, "mc_acceptance_ratio");
+                myfile.Read_Single(parameters->heat_bath, "mc_heat_bath");
+                myfile.Read_Single(parameters->n_overrelaxation, "mc_n_overrelaxation");
+                myfile.Read_Single(parameters->metropolis_parallel, "mc_parallel_sweep");
+                myfile.Read_Single(parameters->replica_exchange_interval, "mc_replica_exchange_interval");
             }
             catch( ... )
             {
@@ -873,11 +919,18 @@ namespace IO
         else
             Log(Log_Level::Parameter, Log_Sender::IO, "Parameters MC: Using default configuration!");
 
+        // The PRNG of the method is seeded with the configured seed
+        parameters->prng = std::mt19937(parameters->rng_seed);
+
         // Return
         Log(Log_Level::Parameter, Log_Sender::IO, "Parameters MC:");
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "seed", parameters->rng_seed));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "temperature", parameters->temperature));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "acceptance_ratio", parameters->acceptance_ratio_target));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "heat_bath", parameters->heat_bath));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "n_overrelaxation", parameters->n_overrelaxation));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "parallel_sweep", parameters->metropolis_parallel));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "replica_exchange_interval", parameters->replica_exchange_interval));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "maximum walltime", str_max_walltime));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "n_iterations", parameters->n_iterations));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "n_iterations_log", parameters->n_iterations_log));
@@ -935,6 +988,8 @@ namespace IO
                 parameters->max_walltime_sec = (long int)Utility::Timing::DurationFromString(str_max_walltime).count();
                 myfile.Read_Single(parameters->spring_constant, "gneb_spring_constant");
                 myfile.Read_Single(parameters->force_convergence, "gneb_force_convergence");
+                myfile.Read_Single(parameters->lbfgs_memory, "gneb_lbfgs_memory");
+                myfile.Read_Single(parameters->lbfgs_max_rotation, "gneb_lbfgs_max_rotation");
                 myfile.Read_Single(parameters->n_iterations, "gneb_n_iterations");
                 myfile.Read_Single(parameters->n_iterations_log, "gneb_n_iterations_log");
                 myfile.Read_Single(parameters->n_E_interpolations, "gneb_n_energy_interpolations");
@@ -953,6 +1008,8 @@ namespace IO
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<18} = {}", "spring_constant", parameters->spring_constant));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<18} = {}", "n_E_interpolations", parameters->n_E_interpolations));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<18} = {:e}", "force convergence", parameters->force_convergence));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<18} = {}", "lbfgs memory", parameters->lbfgs_memory));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<18} = {}", "lbfgs max rotation", parameters->lbfgs_max_rotation));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<18} = {}", "maximum walltime", str_max_walltime));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<18} = {}", "n_iterations", parameters->n_iterations));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<18} = {}", "n_iterations_log", parameters->n_iterations_log));
@@ -1010,6 +1067,8 @@ namespace IO
                 myfile.Read_Single(parameters->n_iterations_log,  "mmf_n_iterations_log");
                 myfile.Read_Single(parameters->n_modes,           "mmf_n_modes");
                 myfile.Read_Single(parameters->n_mode_follow,     "mmf_n_mode_follow");
+                myfile.Read_Single(parameters->sparse,            "mmf_sparse");
+                myfile.Read_Single(parameters->matrix_free,       "mmf_matrix_free");
             }
             catch( ... )
             {
@@ -1026,6 +1085,8 @@ namespace IO
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "maximum walltime", str_max_walltime));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "n_iterations", parameters->n_iterations));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "n_iterations_log", parameters->n_iterations_log));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "sparse", parameters->sparse));
+        Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "matrix_free", parameters->matrix_free));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = \"{}\"", "output_folder", parameters->output_folder));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "output_any", parameters->output_any));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<17} = {}", "output_initial", parameters->output_initial));
@@ -1135,6 +1196,7 @@ namespace IO
         auto ddi_method = Engine::DDI_Method::None;
         intfield ddi_n_periodic_images = { 4, 4, 4 };
         scalar ddi_radius = 0.0;
+        scalar ddi_theta = 0.5;
 
         // ------------ Quadruplet Interactions ------------
         int n_quadruplets = 0;
@@ -1351,6 +1413,15 @@ namespace IO
 
                 // Dipole-dipole cutoff radius
                 myfile.Read_Single(ddi_radius, "ddi_radius");
+
+                // Opening angle of the tree-based summation
+                myfile.Read_Single(ddi_theta, "ddi_theta");
+                if( ddi_theta < 0 || ddi_theta >= 1 )
+                {
+                    Log(Log_Level::Warning, Log_Sender::IO, fmt::format(
+                        "Hamiltonian_Heisenberg: Keyword 'ddi_theta' got passed invalid value {}, which has to be in [0, 1). Setting to 0.5.", ddi_theta));
+                    ddi_theta = 0.5;
+                }
             }// end try
             catch( ... )
             {
@@ -1405,6 +1476,8 @@ namespace IO
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<21} = {}", "ddi_method", ddi_method_str));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<21} = ({} {} {})", "ddi_n_periodic_images", ddi_n_periodic_images[0], ddi_n_periodic_images[1], ddi_n_periodic_images[2]));
         Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<21} = {}", "ddi_radius", ddi_radius));
+        if( ddi_method == Engine::DDI_Method::FMM )
+            Log(Log_Level::Parameter, Log_Sender::IO, fmt::format("        {:<21} = {}", "ddi_theta", ddi_theta));
 
         std::unique_ptr<Engine::Hamiltonian_Heisenberg> hamiltonian;
 
@@ -1415,7 +1488,7 @@ namespace IO
                 anisotropy_index, anisotropy_magnitude, anisotropy_normal,
                 exchange_magnitudes,
                 dmi_magnitudes, dm_chirality,
-                ddi_method, ddi_n_periodic_images, ddi_radius,
+                ddi_method, ddi_n_periodic_images, ddi_radius, ddi_theta,
                 quadruplets, quadruplet_magnitudes,
                 geometry,
                 boundary_conditions
@@ -1428,7 +1501,7 @@ namespace IO
                 anisotropy_index, anisotropy_magnitude, anisotropy_normal,
                 exchange_pairs, exchange_magnitudes,
                 dmi_pairs, dmi_magnitudes, dmi_normals,
-                ddi_method, ddi_n_periodic_images, ddi_radius,
+                ddi_method, ddi_n_periodic_images, ddi_radius, ddi_theta,
                 quadruplets, quadruplet_magnitudes,
                 geometry,
                 boundary_conditions
@@ -52,6 +52,16 @@ namespace IO
     }// End Log_Levels_to_Config
 
 
+    void FFT_to_Config(const std::string configFile)
+    {
+        std::string config = "";
+        config += "################# FFT Parameters #################\n";
+        config += fmt::format("{:<22} {}\n", "ddi_fftw_wisdom", Engine::FFT::Get_Wisdom_File());
+        config += "############### End FFT Parameters ###############";
+        Append_String_to_File(config, configFile);
+    }// End FFT_to_Config
+
+
     void Geometry_to_Config(const std::string configFile, const std::shared_ptr<Data::Geometry> geometry)
     {
         // TODO: this needs to be updated!
@@ -131,10 +141,15 @@ namespace IO
         config += fmt::format("{:<35} {:e}\n", "llg_force_convergence",               parameters->force_convergence);
         config += fmt::format("{:<35} {}\n",   "llg_n_iterations",                    parameters->n_iterations);
         config += fmt::format("{:<35} {}\n",   "llg_n_iterations_log",                parameters->n_iterations_log);
+        config += fmt::format("{:<35} {}\n",   "llg_lbfgs_memory",                    parameters->lbfgs_memory);
+        config += fmt::format("{:<35} {}\n",   "llg_lbfgs_max_rotation",              parameters->lbfgs_max_rotation);
         config += fmt::format("{:<35} {}\n",   "llg_seed",                            parameters->rng_seed);
         config += fmt::format("{:<35} {}\n",   "llg_temperature",                     parameters->temperature);
         config += fmt::format("{:<35} {}\n",   "llg_damping",                         parameters->damping);
         config += fmt::format("{:<35} {}\n",   "llg_dt",                              parameters->dt/std::pow(10, -12) * Constants::mu_B/1.760859644/std::pow(10, 11));
+        config += fmt::format("{:<35} {}\n",   "llg_dt_tolerance",                    parameters->dt_tolerance);
+        config += fmt::format("{:<35} {}\n",   "llg_dt_min",                          parameters->dt_min);
+        config += fmt::format("{:<35} {}\n",   "llg_dt_max",                          parameters->dt_max);
         config += fmt::format("{:<35} {}\n",   "llg_stt_magnitude",                   parameters->stt_magnitude);
         config += fmt::format("{:<35} {}\n",   "llg_stt_polarisation_normal",         parameters->stt_polarisation_normal.transpose());
         config += "############### End LLG Parameters ###############";
@@ -159,6 +174,10 @@ namespace IO
         config += fmt::format("{:<35} {}\n",   "mc_seed",                            parameters->rng_seed);
         config += fmt::format("{:<35} {}\n",   "mc_temperature",                     parameters->temperature);
         config += fmt::format("{:<35} {}\n",   "mc_acceptance_ratio",                parameters->acceptance_ratio_target);
+        config += fmt::format("{:<35} {:d}\n", "mc_heat_bath",                       parameters->heat_bath);
+        config += fmt::format("{:<35} {}\n",   "mc_n_overrelaxation",                parameters->n_overrelaxation);
+        config += fmt::format("{:<35} {:d}\n", "mc_parallel_sweep",                  parameters->metropolis_parallel);
+        config += fmt::format("{:<35} {}\n",   "mc_replica_exchange_interval",       parameters->replica_exchange_interval);
         config += "############### End MC Parameters ################";
         Append_String_to_File(config, configFile);
     }// end Parameters_Method_MC_to_Config
@@ -177,6 +196,8 @@ namespace IO
         config += fmt::format("{:<38} {:e}\n", "gneb_force_convergence",                parameters->force_convergence);
         config += fmt::format("{:<38} {}\n",   "gneb_n_iterations",                     parameters->n_iterations);
         config += fmt::format("{:<38} {}\n",   "gneb_n_iterations_log",                 parameters->n_iterations_log);
+        config += fmt::format("{:<38} {}\n",   "gneb_lbfgs_memory",                     parameters->lbfgs_memory);
+        config += fmt::format("{:<38} {}\n",   "gneb_lbfgs_max_rotation",               parameters->lbfgs_max_rotation);
         config += fmt::format("{:<38} {}\n",   "gneb_spring_constant",                  parameters->spring_constant);
         config += fmt::format("{:<38} {}\n",   "gneb_n_energy_interpolations",          parameters->n_E_interpolations);
         config += "############### End GNEB Parameters ##############";
@@ -198,6 +219,8 @@ namespace IO
         config += fmt::format("{:<38} {:e}\n", "mmf_force_convergence",              parameters->force_convergence);
         config += fmt::format("{:<38} {}\n",   "mmf_n_iterations",                   parameters->n_iterations);
         config += fmt::format("{:<38} {}\n",   "mmf_n_iterations_log",               parameters->n_iterations_log);
+        config += fmt::format("{:<38} {:d}\n", "mmf_sparse",                         parameters->sparse);
+        config += fmt::format("{:<38} {:d}\n", "mmf_matrix_free",                    parameters->matrix_free);
         config += "############### End MMF Parameters ###############";
         Append_String_to_File(config, configFile);
     }// end Parameters_Method_MMF_to_Config
@@ -280,6 +303,8 @@ namespace IO
         config += fmt::format("ddi_n_periodic_images      {} {} {}\n", ham->ddi_n_periodic_images[0], ham->ddi_n_periodic_images[1], ham->ddi_n_periodic_images[2]);
         config += "### DDI cutoff radius (if cutoff is used)";
         config += fmt::format("ddi_radius                 {}\n", ham->ddi_cutoff_radius);
+        config += "### DDI opening angle of the tree (if fmm is used)\n";
+        config += fmt::format("ddi_theta                  {}\n", ham->ddi_theta);
 
         // Quadruplets
         config += "###    Quadruplets:\n";
@@ -164,5 +164,22 @@ TEST_CASE( "Quantities", "[quantities]" )
 			float charge = Quantity_Get_Topological_Charge(state.get());
 			REQUIRE(charge == Approx(1));
 		}
+
+		SECTION("charge density")
+		{
+			Configuration_PlusZ(state.get());
+			Configuration_Skyrmion(state.get(), 6.0, 1.0, -90.0, false, false, false);
+			int nos = System_Get_NOS(state.get());
+			std::vector<float> density(nos);
+			float charge = Quantity_Get_Topological_Charge_Density(state.get(), density.data());
+			REQUIRE(charge == Approx(-1));
+			REQUIRE(charge == Approx(Quantity_Get_Topological_Charge(state.get())));
+
+			// The density sums up to the total charge
+			float sum = 0;
+			for( float d : density )
+				sum += d;
+			REQUIRE(sum == Approx(charge).epsilon(1e-4));
+		}
 	}
 }
\ No newline at end of file
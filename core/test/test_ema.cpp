@@ -3,12 +3,17 @@
 #include <Spirit/System.h>
 #include <Spirit/Simulation.h>
 #include <Spirit/Configurations.h>
+#include <Spirit/Geometry.h>
 #include <Spirit/Hamiltonian.h>
 #include <Spirit/Constants.h>
 #include <Spirit/IO.h>
+#include <Spirit/Parameters_EMA.h>
 #include <data/State.hpp>
+#include <engine/Eigenmodes.hpp>
+#include <engine/Vectormath.hpp>
 #include <Eigen/Dense>
 #include <Eigen/Core>
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -33,4 +38,181 @@ TEST_CASE("Trivial", "[EMA]")
     
     // Configuration_MinusZ( state.get() );
     // IO_Image_Write( state.get(), testfile );
-}
\ No newline at end of file
+}
+
+TEST_CASE("Hessian Representations", "[EMA]")
+{
+    auto state = std::shared_ptr<State>( State_Setup( inputfile ), State_Delete );
+
+    Configuration_PlusZ( state.get() );
+
+    // Dense Hessian
+    Parameters_EMA_Set_Sparse( state.get(), false );
+    System_Update_Eigenmodes( state.get() );
+    // The number of modes may have been reduced to the number of degrees of freedom
+    int n_modes = Parameters_EMA_Get_N_Modes( state.get() );
+    std::vector<float> eigenvalues_dense( n_modes );
+    System_Get_Eigenvalues( state.get(), eigenvalues_dense.data() );
+
+    // Sparse Hessian
+    Parameters_EMA_Set_Sparse( state.get(), true );
+    System_Update_Eigenmodes( state.get() );
+    std::vector<float> eigenvalues_sparse( n_modes );
+    System_Get_Eigenvalues( state.get(), eigenvalues_sparse.data() );
+
+    // Matrix-free Hessian-vector products
+    Parameters_EMA_Set_Matrix_Free( state.get(), true );
+    System_Update_Eigenmodes( state.get() );
+    std::vector<float> eigenvalues_matrix_free( n_modes );
+    System_Get_Eigenvalues( state.get(), eigenvalues_matrix_free.data() );
+
+    for( int i=0; i<n_modes; ++i )
+    {
+        INFO( "Eigenvalue " << i );
+        REQUIRE( Approx(eigenvalues_dense[i]).epsilon(1e-6) == eigenvalues_sparse[i] );
+        REQUIRE( Approx(eigenvalues_dense[i]).epsilon(1e-6) == eigenvalues_matrix_free[i] );
+    }
+}
+
+
+TEST_CASE("Warm-started Eigenmodes", "[EMA]")
+{
+    auto state = std::shared_ptr<State>( State_Setup( inputfile ), State_Delete );
+
+    int n_cells[3] = { 4, 4, 1 };
+    Geometry_Set_N_Cells( state.get(), n_cells );
+    Configuration_Random( state.get() );
+
+    auto system = state->active_image;
+    auto hamiltonian = system->hamiltonian;
+    int nos = system->nos;
+    int n_modes = 6;
+
+    vectorfield spins = *system->spins;
+    vectorfield gradient( nos );
+    SpMatrixX hessian, tangent_basis, hessian_constrained;
+    VectorX eigenvalues_previous;
+    MatrixX eigenvectors_previous;
+
+    // The modes of the initial configuration
+    hamiltonian->Gradient( spins, gradient );
+    Engine::Vectormath::set_c_a( 1, gradient, gradient, system->geometry->mask_unpinned );
+    hamiltonian->Sparse_Hessian( spins, hessian );
+    REQUIRE( Engine::Eigenmodes::Hessian_Partial_Spectrum( system->ema_parameters, spins, gradient, system->geometry->mask_unpinned, hessian,
+        n_modes, tangent_basis, hessian_constrained, eigenvalues_previous, eigenvectors_previous ) );
+    MatrixX modes_previous = tangent_basis * eigenvectors_previous;
+
+    // Slightly rotate the spins, as between two iterations of a minimum mode following
+    for( int i=0; i<nos; ++i )
+        spins[i] = ( spins[i] + 0.02 * Vector3{ std::sin(i), std::cos(i), 0 } ).normalized();
+    hamiltonian->Gradient( spins, gradient );
+    Engine::Vectormath::set_c_a( 1, gradient, gradient, system->geometry->mask_unpinned );
+    hamiltonian->Sparse_Hessian( spins, hessian );
+
+    // Cold start
+    VectorX eigenvalues_cold;
+    MatrixX eigenvectors_cold;
+    REQUIRE( Engine::Eigenmodes::Hessian_Partial_Spectrum( system->ema_parameters, spins, gradient, system->geometry->mask_unpinned, hessian,
+        n_modes, tangent_basis, hessian_constrained, eigenvalues_cold, eigenvectors_cold ) );
+    MatrixX modes_cold = tangent_basis * eigenvectors_cold;
+
+    // Warm start from the modes of the initial configuration
+    VectorX eigenvalues_warm;
+    MatrixX eigenvectors_warm;
+    REQUIRE( Engine::Eigenmodes::Hessian_Partial_Spectrum( system->ema_parameters, spins, gradient, system->geometry->mask_unpinned, hessian,
+        n_modes, tangent_basis, hessian_constrained, eigenvalues_warm, eigenvectors_warm, modes_previous ) );
+    MatrixX modes_warm = tangent_basis * eigenvectors_warm;
+
+    for( int i=0; i<n_modes; ++i )
+    {
+        INFO( "Eigenmode " << i );
+        REQUIRE( Approx(eigenvalues_cold[i]).epsilon(1e-8) == eigenvalues_warm[i] );
+        // The modes are only determined up to their sign
+        REQUIRE( Approx(1).epsilon(1e-8) == std::abs( modes_cold.col(i).dot( modes_warm.col(i) ) ) );
+    }
+}
+
+#ifdef SPIRIT_ENABLE_PINNING
+TEST_CASE("Hessian Representations with pinned spins", "[EMA]")
+{
+    auto state = std::shared_ptr<State>( State_Setup( inputfile ), State_Delete );
+
+    int n_cells[3] = { 4, 4, 1 };
+    Geometry_Set_N_Cells( state.get(), n_cells );
+    Configuration_Random( state.get() );
+
+    // Pin the spins around the center of the lattice
+    float position[3] = { 0, 0, 0 };
+    float r_cut_rectangular[3] = { -1, -1, -1 };
+    Configuration_Set_Pinned( state.get(), true, position, r_cut_rectangular, -1, 1 );
+
+    auto system = state->active_image;
+    auto hamiltonian = system->hamiltonian;
+    auto & mask_unpinned = system->geometry->mask_unpinned;
+    int nos = system->nos;
+    int n_modes = 6;
+    REQUIRE( std::count( mask_unpinned.begin(), mask_unpinned.end(), 0 ) > 0 );
+
+    vectorfield spins = *system->spins;
+    vectorfield gradient( nos );
+    MatrixX hessian_dense( 3*nos, 3*nos ), tangent_basis_dense, hessian_constrained_dense;
+    SpMatrixX hessian, tangent_basis, hessian_constrained;
+
+    // The modes of the initial configuration, used as initial guess below
+    hamiltonian->Gradient( spins, gradient );
+    Engine::Vectormath::set_c_a( 1, gradient, gradient, mask_unpinned );
+    hamiltonian->Sparse_Hessian( spins, hessian );
+    VectorX eigenvalues_previous;
+    MatrixX eigenvectors_previous;
+    REQUIRE( Engine::Eigenmodes::Hessian_Partial_Spectrum( system->ema_parameters, spins, gradient, mask_unpinned, hessian,
+        n_modes, tangent_basis, hessian_constrained, eigenvalues_previous, eigenvectors_previous ) );
+    MatrixX modes_previous = tangent_basis * eigenvectors_previous;
+
+    // Slightly rotate the spins, as between two iterations of a minimum mode following
+    for( int i=0; i<nos; ++i )
+        spins[i] = ( spins[i] + 0.02 * Vector3{ std::sin(i), std::cos(i), 0 } ).normalized();
+    hamiltonian->Gradient( spins, gradient );
+    Engine::Vectormath::set_c_a( 1, gradient, gradient, mask_unpinned );
+
+    // Dense Hessian
+    VectorX eigenvalues_dense;
+    MatrixX eigenvectors_dense;
+    hamiltonian->Hessian( spins, hessian_dense );
+    REQUIRE( Engine::Eigenmodes::Hessian_Partial_Spectrum( system->ema_parameters, spins, gradient, mask_unpinned, hessian_dense,
+        n_modes, tangent_basis_dense, hessian_constrained_dense, eigenvalues_dense, eigenvectors_dense ) );
+    MatrixX modes_dense = tangent_basis_dense * eigenvectors_dense;
+
+    // Sparse Hessian, warm-started
+    VectorX eigenvalues_sparse;
+    MatrixX eigenvectors_sparse;
+    hamiltonian->Sparse_Hessian( spins, hessian );
+    REQUIRE( Engine::Eigenmodes::Hessian_Partial_Spectrum( system->ema_parameters, spins, gradient, mask_unpinned, hessian,
+        n_modes, tangent_basis, hessian_constrained, eigenvalues_sparse, eigenvectors_sparse, modes_previous ) );
+    MatrixX modes_sparse = tangent_basis * eigenvectors_sparse;
+
+    // Matrix-free Hessian-vector products, warm-started
+    VectorX eigenvalues_matrix_free;
+    MatrixX eigenvectors_matrix_free;
+    REQUIRE( Engine::Eigenmodes::Hessian_Partial_Spectrum_Matrix_Free( system->ema_parameters, spins, gradient, mask_unpinned,
+        hamiltonian, n_modes, tangent_basis, eigenvalues_matrix_free, eigenvectors_matrix_free, modes_previous ) );
+    MatrixX modes_matrix_free = tangent_basis * eigenvectors_matrix_free;
+
+    for( int i=0; i<n_modes; ++i )
+    {
+        INFO( "Eigenmode " << i );
+        REQUIRE( Approx(eigenvalues_dense[i]).epsilon(1e-6) == eigenvalues_sparse[i] );
+        REQUIRE( Approx(eigenvalues_dense[i]).epsilon(1e-6) == eigenvalues_matrix_free[i] );
+
+        // The pinned spins do not move
+        for( int j=0; j<nos; ++j )
+        {
+            if( !mask_unpinned[j] )
+            {
+                REQUIRE( modes_dense.col(i).segment<3>(3*j).norm() < 1e-8 );
+                REQUIRE( modes_sparse.col(i).segment<3>(3*j).norm() < 1e-8 );
+                REQUIRE( modes_matrix_free.col(i).segment<3>(3*j).norm() < 1e-8 );
+            }
+        }
+    }
+}
+#endif // SPIRIT_ENABLE_PINNING
@@ -0,0 +1,289 @@
+#include <catch.hpp>
+#include <Spirit/State.h>
+#include <Spirit/System.h>
+#include <Spirit/Simulation.h>
+#include <Spirit/Configurations.h>
+#include <Spirit/Hamiltonian.h>
+#include <Spirit/Quantities.h>
+#include <Spirit/Constants.h>
+#include <Spirit/Parameters_MC.h>
+#include <Spirit/Chain.h>
+#include <data/State.hpp>
+#include <engine/Method_PT.hpp>
+#include <utility/Logging.hpp>
+
+#include <cmath>
+
+auto inputfile = "core/test/input/mc.cfg";
+
+// Mean z-component of the magnetization of a configuration, averaged over n_samples runs of n_iterations MC iterations
+float sample_magnetization( State * state, int n_samples, int n_iterations )
+{
+    float m_z = 0;
+    for( int i = 0; i < n_samples; ++i )
+    {
+        Simulation_MC_Start( state, n_iterations, n_iterations );
+        float m[3];
+        Quantity_Get_Magnetization( state, m );
+        m_z += m[2];
+    }
+    return m_z / n_samples;
+}
+
+// Turns the lattice of the input into non-interacting spins in a field, where <m_z> is given by the Langevin function
+scalar setup_paramagnet( State * state )
+{
+    Hamiltonian_Set_Exchange( state, 0, nullptr );
+
+    // Temperature such that mu_s * mu_B * B = k_B * T
+    float temperature = Constants_mu_B() / Constants_k_B();
+    Parameters_MC_Set_Temperature( state, temperature );
+
+    scalar x = 1;
+    return 1/std::tanh(x) - 1/x;
+}
+
+TEST_CASE( "MC Metropolis sampling", "[mc]" )
+{
+    // The spins are updated in-place, so each trial sees the current orientation of all other spins
+    // and detailed balance gives the Boltzmann distribution of a spin in a field
+    auto state = std::shared_ptr<State>( State_Setup( inputfile ), State_Delete );
+    scalar m_z_expected = setup_paramagnet( state.get() );
+
+    SECTION( "Cone" )
+    {
+        Parameters_MC_Set_Metropolis_Cone( state.get(), true, 30, true, 0.5 );
+    }
+
+    SECTION( "Full sphere" )
+    {
+        // Trial orientations are drawn uniformly from the entire unit sphere
+        Parameters_MC_Set_Metropolis_Cone( state.get(), false, 30, false, 0.5 );
+    }
+
+    Configuration_Random( state.get() );
+    Simulation_MC_Start( state.get(), 200, 200 );
+    float m_z = sample_magnetization( state.get(), 100, 5 );
+
+    INFO( "<m_z> = " << m_z << ", expected " << m_z_expected );
+    REQUIRE( std::abs( m_z - m_z_expected ) < 0.02 );
+}
+
+// Energy per spin of the current configuration
+float energy_per_spin( State * state )
+{
+    return System_Get_Energy( state ) / System_Get_NOS( state );
+}
+
+// Mean energy per spin, averaged over n_samples runs of n_iterations MC iterations
+float sample_energy( State * state, int n_samples, int n_iterations )
+{
+    float energy = 0;
+    for( int i = 0; i < n_samples; ++i )
+    {
+        Simulation_MC_Start( state, n_iterations, n_iterations );
+        energy += energy_per_spin( state );
+    }
+    return energy / n_samples;
+}
+
+TEST_CASE( "MC parallel sweep", "[mc]" )
+{
+    auto state_serial   = std::shared_ptr<State>( State_Setup( inputfile ), State_Delete );
+    auto state_parallel = std::shared_ptr<State>( State_Setup( inputfile ), State_Delete );
+    Parameters_MC_Set_Parallel_Sweep( state_parallel.get(), true );
+
+    SECTION( "Zero temperature" )
+    {
+        // Both sweeps only ever accept moves which lower the energy
+        for( auto state : { state_serial.get(), state_parallel.get() } )
+        {
+            Configuration_Random( state );
+            float energy_initial  = energy_per_spin( state );
+            float energy_previous = energy_initial;
+            for( int i = 0; i < 50; ++i )
+            {
+                Simulation_MC_Start( state, 1, 1 );
+                float energy = energy_per_spin( state );
+                REQUIRE( energy <= energy_previous + 1e-6 );
+                energy_previous = energy;
+            }
+            REQUIRE( energy_previous < energy_initial - 1 );
+        }
+    }
+
+    SECTION( "Finite temperature" )
+    {
+        // Both sweeps sample the same equilibrium
+        float energy[2];
+        int i = 0;
+        for( auto state : { state_serial.get(), state_parallel.get() } )
+        {
+            Parameters_MC_Set_Temperature( state, 5 );
+            Configuration_PlusZ( state );
+            Simulation_MC_Start( state, 500, 500 );
+            energy[i++] = sample_energy( state, 200, 5 );
+        }
+        INFO( "<E> serial = " << energy[0] << ", parallel = " << energy[1] );
+        REQUIRE( energy[1] == Approx( energy[0] ).epsilon( 0.01 ) );
+    }
+
+    SECTION( "Reproducibility" )
+    {
+        // With the same seed and number of threads, the parallel sweep gives the same result
+        auto state_repeated = std::shared_ptr<State>( State_Setup( inputfile ), State_Delete );
+        Parameters_MC_Set_Parallel_Sweep( state_repeated.get(), true );
+        for( auto state : { state_parallel.get(), state_repeated.get() } )
+        {
+            Parameters_MC_Set_Temperature( state, 5 );
+            Configuration_PlusZ( state );
+            Simulation_MC_Start( state, 50, 50 );
+        }
+
+        auto & spins          = *state_parallel->active_image->spins;
+        auto & spins_repeated = *state_repeated->active_image->spins;
+        for( int ispin = 0; ispin < state_parallel->nos; ++ispin )
+            REQUIRE( spins[ispin] == spins_repeated[ispin] );
+    }
+}
+
+TEST_CASE( "MC heat bath and over-relaxation", "[mc]" )
+{
+    SECTION( "Heat bath sampling" )
+    {
+        // Each spin is drawn from the Boltzmann distribution in its local field
+        auto state = std::shared_ptr<State>( State_Setup( inputfile ), State_Delete );
+        scalar m_z_expected = setup_paramagnet( state.get() );
+        Parameters_MC_Set_Update_Moves( state.get(), true, 0 );
+
+        Configuration_Random( state.get() );
+        Simulation_MC_Start( state.get(), 20, 20 );
+        float m_z = sample_magnetization( state.get(), 100, 2 );
+
+        INFO( "<m_z> = " << m_z << ", expected " << m_z_expected );
+        REQUIRE( std::abs( m_z - m_z_expected ) < 0.02 );
+    }
+
+    SECTION( "Over-relaxation conserves the energy" )
+    {
+        // The over-relaxation sweeps after a Metropolis sweep change the spins, but not the energy
+        auto state_metropolis     = std::shared_ptr<State>( State_Setup( inputfile ), State_Delete );
+        auto state_overrelaxation = std::shared_ptr<State>( State_Setup( inputfile ), State_Delete );
+        Parameters_MC_Set_Update_Moves( state_overrelaxation.get(), false, 5 );
+
+        for( auto state : { state_metropolis.get(), state_overrelaxation.get() } )
+        {
+            Parameters_MC_Set_Temperature( state, 5 );
+            Configuration_Random( state );
+        }
+        REQUIRE( System_Get_Energy( state_metropolis.get() ) == System_Get_Energy( state_overrelaxation.get() ) );
+
+        for( auto state : { state_metropolis.get(), state_overrelaxation.get() } )
+            Simulation_MC_Start( state, 1, 1 );
+        REQUIRE( System_Get_Energy( state_overrelaxation.get() ) == Approx( System_Get_Energy( state_metropolis.get() ) ) );
+
+        auto & spins                = *state_metropolis->active_image->spins;
+        auto & spins_overrelaxation = *state_overrelaxation->active_image->spins;
+        int n_changed = 0;
+        for( int ispin = 0; ispin < state_metropolis->nos; ++ispin )
+        {
+            if( !spins[ispin].isApprox( spins_overrelaxation[ispin] ) )
+                ++n_changed;
+        }
+        REQUIRE( n_changed > state_metropolis->nos / 2 );
+    }
+
+    SECTION( "Long-ranged interactions" )
+    {
+        // With FFT dipolar interactions, the heat bath falls back to Metropolis sampling
+        auto state = std::shared_ptr<State>( State_Setup( inputfile ), State_Delete );
+        int n_periodic_images[3] = { 0, 0, 0 };
+        Hamiltonian_Set_DDI( state.get(), SPIRIT_DDI_METHOD_FFT, n_periodic_images );
+        Parameters_MC_Set_Update_Moves( state.get(), true, 2 );
+        Parameters_MC_Set_Temperature( state.get(), 5 );
+
+        int n_entries = Log.GetEntries().size();
+        Configuration_PlusZ( state.get() );
+        Simulation_MC_Start( state.get(), 5, 5 );
+        REQUIRE( System_Get_Energy( state.get() ) < 0 );
+
+        bool fallback = false;
+        auto entries = Log.GetEntries();
+        for( int i = n_entries; i < (int)entries.size(); ++i )
+        {
+            if( entries[i].sender == Utility::Log_Sender::MC && entries[i].level == Utility::Log_Level::Warning &&
+                entries[i].message.find( "falling back to Metropolis" ) != std::string::npos )
+                fallback = true;
+        }
+        REQUIRE( fallback );
+    }
+}
+
+TEST_CASE( "MC parallel tempering", "[mc]" )
+{
+    SECTION( "Exchange criterion" )
+    {
+        scalar k_B = Constants_k_B();
+        scalar T_i = 10, T_j = 20;
+
+        // The colder replica having the higher energy is always exchanged
+        REQUIRE( Engine::Method_PT::Exchange_Probability( T_i, T_j, -1, -2 ) == 1 );
+        // Equal temperatures or energies are always exchanged
+        REQUIRE( Engine::Method_PT::Exchange_Probability( T_i, T_i, -2, -1 ) == 1 );
+        REQUIRE( Engine::Method_PT::Exchange_Probability( T_i, T_j, -1, -1 ) == 1 );
+        // Otherwise with the Boltzmann factor of the change in the total weight
+        scalar expected = std::exp( -( 1/(k_B*T_i) - 1/(k_B*T_j) ) * 0.5 );
+        REQUIRE( Engine::Method_PT::Exchange_Probability( T_i, T_j, -2, -1.5 ) == Approx( expected ) );
+        REQUIRE( Engine::Method_PT::Exchange_Probability( T_j, T_i, -1.5, -2 ) == Approx( expected ) );
+        // Replicas at zero temperature are never exchanged
+        REQUIRE( Engine::Method_PT::Exchange_Probability( 0, T_j, -1, -2 ) == 0 );
+    }
+
+    SECTION( "Equal temperatures" )
+    {
+        // Replicas at the same temperature are exchanged at every attempt
+        auto state = std::shared_ptr<State>( State_Setup( inputfile ), State_Delete );
+        Parameters_MC_Set_Temperature( state.get(), 5 );
+        Configuration_Random( state.get() );
+        Chain_Image_to_Clipboard( state.get() );
+        Chain_Set_Length( state.get(), 2 );
+
+        int n_entries = Log.GetEntries().size();
+        Simulation_PT_Start( state.get(), 20, 20 );
+
+        int n_ratios = 0;
+        auto entries = Log.GetEntries();
+        for( int i = n_entries; i < (int)entries.size(); ++i )
+        {
+            if( entries[i].message.find( "exchange ratio with next" ) != std::string::npos )
+            {
+                REQUIRE( entries[i].message.find( "exchange ratio with next:  1.000" ) != std::string::npos );
+                ++n_ratios;
+            }
+        }
+        REQUIRE( n_ratios > 0 );
+    }
+
+    SECTION( "Temperature ordering" )
+    {
+        // The configurations are exchanged, while each image keeps its temperature,
+        //      so that the energies remain ordered like the temperatures
+        auto state = std::shared_ptr<State>( State_Setup( inputfile ), State_Delete );
+        Configuration_Random( state.get() );
+        Chain_Image_to_Clipboard( state.get() );
+        Chain_Set_Length( state.get(), 4 );
+        float temperatures[4] = { 1, 10, 20, 40 };
+        for( int img = 0; img < 4; ++img )
+            Parameters_MC_Set_Temperature( state.get(), temperatures[img], img );
+
+        Simulation_PT_Start( state.get(), 500, 500 );
+
+        for( int img = 0; img < 4; ++img )
+        {
+            INFO( "image " << img );
+            REQUIRE( Parameters_MC_Get_Temperature( state.get(), img ) == temperatures[img] );
+            if( img > 0 )
+                REQUIRE( System_Get_Energy( state.get(), img ) > System_Get_Energy( state.get(), img-1 ) );
+        }
+    }
+}
@@ -8,6 +8,8 @@
 #include <Spirit/Constants.h>
 #include <Spirit/Parameters_LLG.h>
 #include <data/State.hpp>
+#include <engine/Hamiltonian_Heisenberg.hpp>
+#include <engine/FFT.hpp>
 #include <Eigen/Dense>
 #include <Eigen/Core>
 #include <iostream>
@@ -81,6 +83,54 @@ TEST_CASE( "Larmor Precession","[physics]" )
     }
 }
 
+TEST_CASE( "Larmor Precession with adaptive time step","[physics]" )
+{
+    // Input file
+    auto inputfile = "core/test/input/physics_larmor.cfg";
+
+    // Create State
+    auto state = std::shared_ptr<State>( State_Setup( inputfile ), State_Delete );
+
+    // Set up one the initial direction of the spin
+    float init_direction[3] = { 1., 0., 0. };                // vec parallel to x-axis
+    Configuration_Domain( state.get(), init_direction );     // set spin parallel to x-axis
+    auto direction = System_Get_Spin_Directions( state.get() );
+
+    // Get the magnitude of the magnetic field ( it has only z-axis component )
+    float B_mag;
+    float normal[3];
+    Hamiltonian_Get_Field( state.get(), &B_mag, normal );
+
+    scalar damping = 0.3;
+    float tstep = Parameters_LLG_Get_Time_Step( state.get() );
+    Parameters_LLG_Set_Damping( state.get(), damping );
+
+    Simulation_LLG_Start( state.get(), Solver_RungeKutta23, -1, -1, true);
+
+    for( int i=0; i<100; i++ )
+    {
+        INFO( "RK23 solver failed spin trajectory test at iteration " << i );
+
+        // A single iteration
+        Simulation_SingleShot( state.get() );
+
+        // Expected spin orientation after the simulated time, which depends on the adaptive time step
+        scalar time = Simulation_Get_Time( state.get() );
+        scalar phi_expected = time * Constants_gamma() / ( 1.0 + damping*damping ) * B_mag;
+        scalar sz_expected  = std::tanh( damping * phi_expected );
+        scalar rxy_expected = std::sqrt( 1-sz_expected*sz_expected );
+        scalar sx_expected  = std::cos(phi_expected) * rxy_expected;
+
+        REQUIRE( Approx(direction[0]).epsilon(1e-4) == sx_expected );
+        REQUIRE( Approx(direction[2]).epsilon(1e-4) == sz_expected );
+    }
+
+    // The time step should have grown beyond the initial one
+    REQUIRE( Simulation_Get_Time( state.get() ) > 100 * tstep );
+
+    Simulation_Stop( state.get() );
+}
+
 TEST_CASE( "Finite Differences", "[physics]" )
 {
     // Hamiltonians to be tested
@@ -123,6 +173,118 @@ TEST_CASE( "Finite Differences", "[physics]" )
     }
 }
 
+TEST_CASE( "Hessian Representations", "[physics]" )
+{
+    auto state = std::shared_ptr<State>( State_Setup( "core/test/input/fd_pairs.cfg" ), State_Delete );
+
+    // Add anisotropy and cutoff dipolar interactions to exchange and DMI
+    float normal[3] = { 0.2f, 0.3f, 1.0f };
+    Hamiltonian_Set_Anisotropy( state.get(), 2.0, normal );
+    auto n_periodic_images = std::vector<int> {0,0,0};
+    Hamiltonian_Set_DDI( state.get(), SPIRIT_DDI_METHOD_CUTOFF, n_periodic_images.data(), 2.0 );
+
+    Configuration_Random( state.get() );
+
+    auto& vf = *state->active_image->spins;
+
+    // The gradient of the cutoff dipolar interaction has its own kernel
+    auto grad    = vectorfield( state->nos );
+    auto grad_fd = vectorfield( state->nos );
+    state->active_image->hamiltonian->Gradient_FD( vf, grad_fd );
+    state->active_image->hamiltonian->Gradient( vf, grad );
+    for( int i=0; i<state->nos; i++ )
+    {
+        INFO("i = " << i << "\n" );
+        INFO("Gradient (FD) = " << grad_fd[i].transpose() << "\n" );
+        INFO("Gradient      = " << grad[i].transpose() << "\n" );
+        REQUIRE( grad_fd[i].isApprox( grad[i] ) );
+    }
+
+    auto hessian    = MatrixX( 3*state->nos, 3*state->nos );
+    auto hessian_fd = MatrixX( 3*state->nos, 3*state->nos );
+    SpMatrixX hessian_sparse;
+
+    state->active_image->hamiltonian->Hessian_FD( vf, hessian_fd );
+    state->active_image->hamiltonian->Hessian( vf, hessian );
+    state->active_image->hamiltonian->Sparse_Hessian( vf, hessian_sparse );
+
+    INFO("Hessian (FD)     = " << hessian_fd << "\n" );
+    INFO("Hessian          = " << hessian << "\n" );
+    INFO("Hessian (sparse) = " << MatrixX(hessian_sparse) << "\n" );
+    REQUIRE( hessian_fd.isApprox( hessian ) );
+    REQUIRE( hessian.isApprox( MatrixX(hessian_sparse) ) );
+
+    // Matrix-free product with a random vector
+    auto vec = vectorfield( state->nos );
+    auto product = vectorfield( state->nos );
+    for( int i=0; i<state->nos; ++i )
+        vec[i] = Vector3::Random();
+    state->active_image->hamiltonian->Hessian_Vector_Product( vf, vec, product );
+
+    VectorX product_dense = hessian * Eigen::Map<VectorX>( vec[0].data(), 3*state->nos );
+    for( int i=0; i<state->nos; ++i )
+    {
+        INFO("i = " << i << "\n" );
+        INFO("H*v (matrix-free) = " << product[i].transpose() << "\n" );
+        INFO("H*v               = " << product_dense.segment<3>(3*i).transpose() << "\n" );
+        REQUIRE( product[i].isApprox( product_dense.segment<3>(3*i) ) );
+    }
+}
+
+TEST_CASE( "Gaussian Hamiltonian", "[physics]" )
+{
+    auto state = std::shared_ptr<State>( State_Setup( "core/test/input/fd_gaussian.cfg" ), State_Delete );
+    int n_cells[3] = { 3, 2, 1 };
+    Geometry_Set_N_Cells( state.get(), n_cells );
+    Configuration_Random( state.get() );
+
+    auto& hamiltonian = *state->active_image->hamiltonian;
+    auto& vf = *state->active_image->spins;
+
+    // The energy is not quadratic, so the finite differences are only approximate
+    auto grad    = vectorfield( state->nos );
+    auto grad_fd = vectorfield( state->nos );
+    hamiltonian.Gradient_FD( vf, grad_fd );
+    hamiltonian.Gradient( vf, grad );
+    for( int i=0; i<state->nos; i++ )
+    {
+        INFO("i = " << i << "\n" );
+        INFO("Gradient (FD) = " << grad_fd[i].transpose() << "\n" );
+        INFO("Gradient      = " << grad[i].transpose() << "\n" );
+        REQUIRE( grad_fd[i].isApprox( grad[i], 1e-4 ) );
+    }
+
+    auto hessian    = MatrixX( 3*state->nos, 3*state->nos );
+    auto hessian_fd = MatrixX( 3*state->nos, 3*state->nos );
+    SpMatrixX hessian_sparse;
+    hamiltonian.Hessian_FD( vf, hessian_fd );
+    hamiltonian.Hessian( vf, hessian );
+    hamiltonian.Sparse_Hessian( vf, hessian_sparse );
+
+    INFO("Hessian (FD)     = " << hessian_fd << "\n" );
+    INFO("Hessian          = " << hessian << "\n" );
+    REQUIRE( hessian_fd.isApprox( hessian, 1e-4 ) );
+    // The spins do not interact, so the Hessian is block-diagonal
+    REQUIRE( hessian_sparse.nonZeros() <= 9*state->nos );
+    REQUIRE( hessian.isApprox( MatrixX(hessian_sparse) ) );
+
+    auto vec = vectorfield( state->nos );
+    auto product = vectorfield( state->nos );
+    for( int i=0; i<state->nos; ++i )
+        vec[i] = Vector3::Random();
+    hamiltonian.Hessian_Vector_Product( vf, vec, product );
+    VectorX product_dense = hessian * Eigen::Map<VectorX>( vec[0].data(), 3*state->nos );
+    for( int i=0; i<state->nos; ++i )
+        REQUIRE( product[i].isApprox( product_dense.segment<3>(3*i) ) );
+
+    // The energy per spin is the single spin energy
+    std::vector<std::pair<std::string, scalarfield>> contributions;
+    hamiltonian.Energy_Contributions_per_Spin( vf, contributions );
+    REQUIRE( contributions.size() == 1 );
+    for( int i=0; i<state->nos; ++i )
+        REQUIRE( contributions[0].second[i] == Approx( hamiltonian.Energy_Single_Spin( i, vf ) ) );
+}
+
 TEST_CASE( "Dipole-Dipole Interaction", "[physics]" )
 {
     //cfg where only ddi is enabled
@@ -158,3 +320,238 @@ TEST_CASE( "Dipole-Dipole Interaction", "[physics]" )
     INFO("Energy (FFT)    = " << energy_fft << "\n");
     REQUIRE(Approx(energy_fft) == energy_direct);
 }
+
+TEST_CASE( "Dipole-Dipole Interaction (rectangular lattices)", "[physics]" )
+{
+    //cfg where only ddi is enabled
+    auto state = std::shared_ptr<State> (State_Setup("core/test/input/physics_ddi.cfg"), State_Delete );
+
+    // The real FFT only stores half of the last dimension, so the lattice should not be cubic
+    std::vector<std::vector<int>> lattices{ {2, 3, 5}, {5, 3, 2}, {3, 6, 1}, {6, 3, 1}, {1, 1, 7} };
+    auto n_periodic_images = std::vector<int> {2,2,2};
+
+    for( auto& n_cells : lattices )
+    {
+        INFO( "n_cells = " << n_cells[0] << " " << n_cells[1] << " " << n_cells[2] );
+        Geometry_Set_N_Cells( state.get(), n_cells.data() );
+        Configuration_Random( state.get() );
+        auto& spins = *state->active_image->spins;
+
+        auto grad_fft = vectorfield( state->nos );
+        auto grad_direct = vectorfield( state->nos );
+
+        Hamiltonian_Set_DDI(state.get(), SPIRIT_DDI_METHOD_FFT, n_periodic_images.data());
+        state->active_image->hamiltonian->Gradient( spins, grad_fft );
+
+        Hamiltonian_Set_DDI(state.get(), SPIRIT_DDI_METHOD_CUTOFF, n_periodic_images.data(), -1);
+        state->active_image->hamiltonian->Gradient( spins, grad_direct );
+
+        for(int i=0; i<state->nos; i++)
+        {
+            INFO("Failed DDI-Gradient comparison at i = " << i);
+            INFO("Gradient (FFT):    " << grad_fft[i].transpose());
+            INFO("Gradient (Direct): " << grad_direct[i].transpose());
+            REQUIRE(grad_fft[i].isApprox(grad_direct[i]));
+        }
+    }
+}
+
+TEST_CASE( "Dipole-Dipole Interaction (shared FFT plans)", "[physics]" )
+{
+    //cfg where only ddi is enabled
+    auto state_1 = std::shared_ptr<State> (State_Setup("core/test/input/physics_ddi.cfg"), State_Delete );
+    Configuration_Random( state_1.get() );
+    auto spins = *state_1->active_image->spins;
+
+    auto grad_fresh = vectorfield( state_1->nos );
+    state_1->active_image->hamiltonian->Gradient( spins, grad_fresh );
+
+    // A second State with the same geometry re-uses the FFT plans of the first one
+    auto state_2 = std::shared_ptr<State> (State_Setup("core/test/input/physics_ddi.cfg"), State_Delete );
+    auto& hamiltonian_2 = *state_2->active_image->hamiltonian;
+
+    auto grad_reused = vectorfield( state_2->nos );
+    hamiltonian_2.Gradient( spins, grad_reused );
+    for( int i=0; i<state_2->nos; i++ )
+    {
+        INFO("Failed DDI-Gradient comparison at i = " << i);
+        REQUIRE( grad_reused[i].isApprox( grad_fresh[i] ) );
+    }
+
+    // The plans stay valid while they are used by the second State
+    state_1.reset();
+    hamiltonian_2.Gradient( spins, grad_reused );
+    for( int i=0; i<state_2->nos; i++ )
+    {
+        INFO("Failed DDI-Gradient comparison after deleting the first State at i = " << i);
+        REQUIRE( grad_reused[i].isApprox( grad_fresh[i] ) );
+    }
+}
+
+TEST_CASE( "Shared FFT plans", "[physics]" )
+{
+    std::vector<int> dims{ 6, 4, 8 };
+    int n_transforms = 3, size = 6 * 4 * 8;
+
+    auto plan_1 = std::unique_ptr<Engine::FFT::FFT_Plan>( new Engine::FFT::FFT_Plan( dims, false, n_transforms, size ) );
+    for( int i = 0; i < n_transforms * size; ++i )
+        plan_1->real_ptr[i] = std::sin( 0.1 * i ) + std::cos( 0.37 * i * i );
+    Engine::FFT::batch_Four_3D( *plan_1 );
+
+    // A plan for the same problem re-uses the plan of the first one
+    Engine::FFT::FFT_Plan plan_2( dims, false, n_transforms, size );
+    #ifdef SPIRIT_USE_FFTW
+    REQUIRE( plan_1->cfg == plan_2.cfg );
+    #endif
+    auto output_1 = plan_1->cpx_ptr;
+
+    // The shared plan stays valid when the first user is deleted
+    plan_1.reset();
+    for( int i = 0; i < n_transforms * size; ++i )
+        plan_2.real_ptr[i] = std::sin( 0.1 * i ) + std::cos( 0.37 * i * i );
+    Engine::FFT::batch_Four_3D( plan_2 );
+
+    int n_frequencies = size / dims.back() * ( dims.back() / 2 + 1 );
+    for( int t = 0; t < n_transforms; ++t )
+    {
+        for( int k = 0; k < n_frequencies; ++k )
+        {
+            INFO( "transform " << t << ", frequency " << k );
+            auto * c_1 = reinterpret_cast<scalar*>( &output_1[t * size + k] );
+            auto * c_2 = reinterpret_cast<scalar*>( &plan_2.cpx_ptr[t * size + k] );
+            REQUIRE( c_1[0] == c_2[0] );
+            REQUIRE( c_1[1] == c_2[1] );
+        }
+    }
+}
+
+TEST_CASE( "Dipole-Dipole Interaction (tree)", "[physics]" )
+{
+    //cfg where only ddi is enabled
+    auto state = std::shared_ptr<State> (State_Setup("core/test/input/physics_ddi.cfg"), State_Delete );
+
+    Configuration_Random( state.get() );
+
+    auto& spins = *state->active_image->spins;
+    auto& hamiltonian = static_cast<Engine::Hamiltonian_Heisenberg&>( *state->active_image->hamiltonian );
+
+    auto grad_direct = vectorfield( state->nos );
+    auto grad_tree   = vectorfield( state->nos );
+
+    auto n_periodic_images = std::vector<int> {4,4,4};
+    Hamiltonian_Set_DDI(state.get(), SPIRIT_DDI_METHOD_CUTOFF, n_periodic_images.data(), -1);
+    hamiltonian.Gradient( spins, grad_direct );
+    auto energy_direct = hamiltonian.Energy( spins );
+
+    Hamiltonian_Set_DDI(state.get(), SPIRIT_DDI_METHOD_FMM, n_periodic_images.data(), -1);
+
+    // Without approximations the tree gives the direct sum
+    hamiltonian.ddi_theta = 0;
+    hamiltonian.Gradient( spins, grad_tree );
+    for( int i=0; i<state->nos; i++ )
+    {
+        INFO( "i = " << i );
+        INFO( "Gradient (Direct) = " << grad_direct[i].transpose() );
+        INFO( "Gradient (tree)   = " << grad_tree[i].transpose() );
+        REQUIRE( grad_tree[i].isApprox( grad_direct[i] ) );
+    }
+    REQUIRE( Approx( hamiltonian.Energy( spins ) ) == energy_direct );
+
+    // With the default opening angle the error is a few percent at most, even for a random configuration
+    hamiltonian.ddi_theta = 0.5;
+    hamiltonian.Gradient( spins, grad_tree );
+    scalar error = 0, norm = 0;
+    for( int i=0; i<state->nos; i++ )
+    {
+        error += ( grad_tree[i] - grad_direct[i] ).squaredNorm();
+        norm  += grad_direct[i].squaredNorm();
+    }
+    INFO( "Relative error of the gradient: " << std::sqrt( error / norm ) );
+    REQUIRE( std::sqrt( error / norm ) < 5e-2 );
+}
+
+TEST_CASE( "Batched Gradient", "[physics]" )
+{
+    // Exchange, DMI and external field from the input, anisotropy and DDI are added below
+    auto state = std::shared_ptr<State>( State_Setup( "core/test/input/fd_pairs.cfg" ), State_Delete );
+    float normal[3] = { 0, 1, 1 };
+    Hamiltonian_Set_Anisotropy( state.get(), 3.0, normal );
+
+    std::vector<int> ddi_methods{ SPIRIT_DDI_METHOD_NONE, SPIRIT_DDI_METHOD_CUTOFF, SPIRIT_DDI_METHOD_FFT };
+    int n_periodic_images[3] = { 0, 0, 0 };
+    int n_img = 3;
+
+    for( auto ddi_method : ddi_methods )
+    {
+        INFO( "DDI method " << ddi_method );
+        Hamiltonian_Set_DDI( state.get(), ddi_method, n_periodic_images, 2.5 );
+
+        auto& hamiltonian = *state->active_image->hamiltonian;
+        REQUIRE( hamiltonian.Equivalent( hamiltonian ) );
+
+        std::vector<vectorfield> configurations( n_img, vectorfield( state->nos ) );
+        std::vector<vectorfield> gradients( n_img, vectorfield( state->nos ) );
+        std::vector<const vectorfield*> p_configurations( n_img );
+        std::vector<vectorfield*> p_gradients( n_img );
+        for( int img = 0; img < n_img; ++img )
+        {
+            for( auto& spin : configurations[img] )
+                spin = Vector3::Random().normalized();
+            p_configurations[img] = &configurations[img];
+            p_gradients[img] = &gradients[img];
+        }
+
+        // Twice, so that the batched FFT plans are re-used
+        for( int repeat = 0; repeat < 2; ++repeat )
+            hamiltonian.Gradient_Batch( p_configurations, p_gradients );
+
+        auto gradient = vectorfield( state->nos );
+        for( int img = 0; img < n_img; ++img )
+        {
+            hamiltonian.Gradient( configurations[img], gradient );
+            for( int ispin = 0; ispin < state->nos; ++ispin )
+            {
+                INFO( "image " << img << ", i = " << ispin );
+                INFO( "Gradient         = " << gradient[ispin].transpose() );
+                INFO( "Gradient (batch) = " << gradients[img][ispin].transpose() );
+                REQUIRE( gradients[img][ispin].isApprox( gradient[ispin] ) );
+            }
+        }
+    }
+}
+
+TEST_CASE( "Single Spin Energy Difference", "[physics]" )
+{
+    // Exchange, DMI and external field from the input, anisotropy and DDI are added below
+    auto state = std::shared_ptr<State>( State_Setup( "core/test/input/fd_pairs.cfg" ), State_Delete );
+    float normal[3] = { 0, 1, 1 };
+    Hamiltonian_Set_Anisotropy( state.get(), 3.0, normal );
+
+    std::vector<int> ddi_methods{ SPIRIT_DDI_METHOD_NONE, SPIRIT_DDI_METHOD_CUTOFF, SPIRIT_DDI_METHOD_FFT };
+    int n_periodic_images[3] = { 0, 0, 0 };
+
+    for( auto ddi_method : ddi_methods )
+    {
+        INFO( "DDI method " << ddi_method );
+        Hamiltonian_Set_DDI( state.get(), ddi_method, n_periodic_images, 2.5 );
+        Configuration_Random( state.get() );
+
+        auto& hamiltonian = *state->active_image->hamiltonian;
+        auto  spins       = *state->active_image->spins;
+        auto  spins_new   = spins;
+
+        for( int ispin = 0; ispin < state->nos; ++ispin )
+        {
+            Vector3 spin_new = Vector3{ 1.0*ispin, -1.0, 0.5 }.normalized();
+            spins_new[ispin] = spin_new;
+
+            scalar Ediff_expected = hamiltonian.Energy( spins_new ) - hamiltonian.Energy( spins );
+            scalar Ediff          = hamiltonian.Energy_Single_Spin_Difference( ispin, spins[ispin], spin_new, spins );
+
+            INFO( "i = " << ispin );
+            REQUIRE( Approx( Ediff ) == Ediff_expected );
+
+            spins_new[ispin] = spins[ispin];
+        }
+    }
+}
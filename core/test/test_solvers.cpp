@@ -20,7 +20,7 @@ TEST_CASE( "Solvers testing", "[solvers]" )
     auto state = std::shared_ptr<State>( State_Setup( inputfile ), State_Delete );
     
     // Solvers to be tested
-    std::vector<int>  solvers { Solver_VP, Solver_Heun, Solver_SIB, Solver_Depondt, Solver_RungeKutta4 };
+    std::vector<int>  solvers { Solver_VP, Solver_Heun, Solver_SIB, Solver_Depondt, Solver_RungeKutta4, Solver_RungeKutta23 };
     
     // Expected values
     float energy_expected = -5849.69140625f;
@@ -54,7 +54,9 @@ TEST_CASE( "Solvers testing", "[solvers]" )
     }
 
     // Calculate energy and magnetization for every solvers with direct minimization
+    // (the adaptive time step of the RK23 solver is meant for dynamics)
     Parameters_LLG_Set_Direct_Minimization( state.get(), true );
+    solvers = { Solver_VP, Solver_Heun, Solver_SIB, Solver_Depondt, Solver_RungeKutta4, Solver_NCG, Solver_LBFGS };
     for ( auto solver : solvers )
     {
         // Put a skyrmion in the center of the space
@@ -84,7 +86,7 @@ TEST_CASE( "Solvers testing", "[solvers]" )
       Chain_Insert_Image_After(state.get());
 
     // Solvers to be tested
-    solvers = { Solver_VP, Solver_Heun, Solver_Depondt };
+    solvers = { Solver_VP, Solver_Heun, Solver_Depondt, Solver_LBFGS };
 
     // Expected values
     float energy_sp_expected = -5811.5244140625f;
@@ -1,6 +1,7 @@
 #include <catch.hpp>
 #include <engine/Vectormath_Defines.hpp>
 #include <engine/Vectormath.hpp>
+#include <engine/Philox.hpp>
 
 
 TEST_CASE( "Vectormath operations", "[vectormath]" )
@@ -252,4 +253,210 @@ TEST_CASE( "Vectormath operations", "[vectormath]" )
         for (int i = 0; i < N_check; ++i)
             REQUIRE(vftest[i] == vtest3);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE( "Fused solver kernels", "[vectormath]" )
+{
+    using namespace Engine;
+
+    int N = 1000;
+    std::mt19937 prng(2006);
+    vectorfield spins(N), spins_stage(N), force(N), force_2(N), k1(N), k2(N), k3(N);
+    Vectormath::get_random_vectorfield_unitsphere(prng, spins);
+    Vectormath::get_random_vectorfield_unitsphere(prng, spins_stage);
+    Vectormath::get_random_vectorfield(prng, force);
+    Vectormath::get_random_vectorfield(prng, force_2);
+    Vectormath::get_random_vectorfield(prng, k1);
+    Vectormath::get_random_vectorfield(prng, k2);
+    Vectormath::get_random_vectorfield(prng, k3);
+
+    vectorfield expected(N), temp(N), result(N), k(N);
+
+    SECTION("SIB predictor")
+    {
+        Vectormath::transform(spins, force, expected);
+        Vectormath::add_c_a(1, spins, expected);
+        Vectormath::scale(expected, 0.5);
+
+        Vectormath::sib_predictor(spins, force, result);
+        for( int i = 0; i < N; ++i )
+            REQUIRE( result[i].isApprox(expected[i]) );
+    }
+
+    SECTION("Explicit stage")
+    {
+        vectorfield k_expected(N);
+        Vectormath::set_c_cross(-1, spins_stage, force, k_expected);
+        Vectormath::set_c_a(1, spins, expected);
+        Vectormath::add_c_a(0.5, k_expected, expected);
+        Vectormath::normalize_vectors(expected);
+
+        Vectormath::explicit_stage(spins, spins_stage, force, 0.5, k, result);
+        for( int i = 0; i < N; ++i )
+        {
+            REQUIRE( k[i].isApprox(k_expected[i]) );
+            REQUIRE( result[i].isApprox(expected[i]) );
+        }
+    }
+
+    SECTION("Heun and RK4 correctors")
+    {
+        Vectormath::set_c_cross(-1, spins_stage, force, temp);
+        Vectormath::set_c_a(1, spins, expected);
+        Vectormath::add_c_a(0.5, k1, expected);
+        Vectormath::add_c_a(0.5, temp, expected);
+        Vectormath::normalize_vectors(expected);
+
+        Vectormath::heun_corrector(spins, k1, spins_stage, force, result);
+        for( int i = 0; i < N; ++i )
+            REQUIRE( result[i].isApprox(expected[i]) );
+
+        Vectormath::set_c_a(1, spins, expected);
+        Vectormath::add_c_a(1.0/6.0, k1, expected);
+        Vectormath::add_c_a(1.0/3.0, k2, expected);
+        Vectormath::add_c_a(1.0/3.0, k3, expected);
+        Vectormath::add_c_a(1.0/6.0, temp, expected);
+        Vectormath::normalize_vectors(expected);
+
+        Vectormath::rk4_corrector(spins, k1, k2, k3, spins_stage, force, result);
+        for( int i = 0; i < N; ++i )
+            REQUIRE( result[i].isApprox(expected[i]) );
+    }
+
+    SECTION("Depondt rotation")
+    {
+        scalarfield angle(N);
+        Vectormath::set_c_a(0.5, force, temp);
+        Vectormath::add_c_a(0.5, force_2, temp);
+        Vectormath::norm(temp, angle);
+        Vectormath::normalize_vectors(temp);
+        Vectormath::rotate(spins, temp, angle, expected);
+
+        Vectormath::depondt_rotate(spins, 0.5, force, 0.5, force_2, result);
+        for( int i = 0; i < N; ++i )
+            REQUIRE( result[i].isApprox(expected[i]) );
+
+        // A vanishing force does not rotate the spin
+        Vectormath::fill(force, { 0, 0, 0 });
+        Vectormath::depondt_rotate(spins, 1, force, 0, force, result);
+        for( int i = 0; i < N; ++i )
+            REQUIRE( result[i].isApprox(spins[i]) );
+    }
+
+    SECTION("RK23 stages")
+    {
+        // Without a previous stage, the spins are rotated by the force projected onto the tangent space of spins_stage
+        vectorfield omega(N);
+        for( int i = 0; i < N; ++i )
+            omega[i] = force[i] - force[i].dot(spins_stage[i]) * spins_stage[i];
+        Vectormath::depondt_rotate(spins, 0.25, omega, 0, omega, expected);
+
+        Vectormath::rk23_stage(spins, spins_stage, 0, k1, force, 0.5, 0.5, k, result);
+        for( int i = 0; i < N; ++i )
+        {
+            REQUIRE( k[i].isApprox(0.5 * omega[i]) );
+            REQUIRE( result[i].isApprox(expected[i]) );
+        }
+
+        // For a constant angular velocity, the 3rd and 2nd order solutions are the same
+        Vectormath::set_c_a(1, omega, k1);
+        Vectormath::set_c_a(1, omega, k2);
+        Vectormath::rk23_solution(spins, k1, k2, spins_stage, force, 1, k3, k, result);
+        for( int i = 0; i < N; ++i )
+        {
+            REQUIRE( k3[i].isApprox(omega[i]) );
+            REQUIRE( k[i].isApprox(omega[i]) );
+        }
+        Vectormath::depondt_rotate(spins, 1, omega, 0, omega, expected);
+        for( int i = 0; i < N; ++i )
+            REQUIRE( result[i].isApprox(expected[i]) );
+
+        Vectormath::rk23_error(k1, k2, k3, k, spins_stage, force, 1, temp);
+        REQUIRE( Vectormath::max_abs_component(temp) < 1e-6 );
+    }
+
+    SECTION("LLG virtual force")
+    {
+        // Compare to the separate passes over the spins for damping, STT and temperature
+        scalar dtg = 0.1, damping = 0.3, stt_c_a = 0.05, stt_c_cross = 0.07;
+        Vector3 s_c_vec{ 0.6, 0, 0.8 };
+        vectorfield s_c_grad(k1), xi(k2);
+        scalarfield mu_s(N);
+        intfield mask_unpinned(N, 1);
+        for( int i = 0; i < N; ++i )
+            mu_s[i] = 1 + i % 3;
+
+        for( bool stt_gradient : { false, true } )
+        {
+            bool stt_monolayer = !stt_gradient;
+            INFO( "STT " << ( stt_gradient ? "gradient" : "monolayer" ) );
+
+            Vectormath::set_c_a(dtg, force, expected);
+            Vectormath::add_c_cross(dtg * damping, spins, force, expected);
+            Vectormath::scale(expected, mu_s, true);
+            if( stt_gradient )
+            {
+                Vectormath::add_c_a    (stt_c_a, s_c_grad, expected);
+                Vectormath::add_c_cross(stt_c_cross, s_c_grad, spins, expected);
+            }
+            else
+            {
+                Vectormath::add_c_a    (stt_c_a, s_c_vec, expected);
+                Vectormath::add_c_cross(stt_c_cross, s_c_vec, spins, expected);
+            }
+            Vectormath::add_c_a    (1, xi, expected);
+            Vectormath::add_c_cross(damping, spins, xi, expected);
+
+            Vectormath::llg_force_virtual(spins, force, mu_s, mask_unpinned, dtg, damping,
+                stt_gradient, s_c_grad, stt_monolayer, s_c_vec, stt_c_a, stt_c_cross, true, xi, result);
+            for( int i = 0; i < N; ++i )
+                REQUIRE( result[i].isApprox(expected[i]) );
+        }
+
+        // Without STT and temperature, only precession and damping remain
+        Vectormath::set_c_a(dtg, force, expected);
+        Vectormath::add_c_cross(dtg * damping, spins, force, expected);
+        Vectormath::scale(expected, mu_s, true);
+        Vectormath::llg_force_virtual(spins, force, mu_s, mask_unpinned, dtg, damping,
+            false, s_c_grad, false, s_c_vec, stt_c_a, stt_c_cross, false, xi, result);
+        for( int i = 0; i < N; ++i )
+            REQUIRE( result[i].isApprox(expected[i]) );
+    }
+}
+
+TEST_CASE( "Counter-based PRNG", "[vectormath]" )
+{
+    using namespace Engine::Philox;
+
+    SECTION("Known answers")
+    {
+        // Test vectors of the reference implementation (Random123)
+        auto result = philox4x32( Counter{ { 0, 0, 0, 0 } }, Key{ { 0, 0 } } );
+        REQUIRE( result == ( Counter{ { 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 } } ) );
+
+        result = philox4x32( Counter{ { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff } }, Key{ { 0xffffffff, 0xffffffff } } );
+        REQUIRE( result == ( Counter{ { 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd } } ) );
+
+        result = philox4x32( Counter{ { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 } }, Key{ { 0xa4093822, 0x299f31d0 } } );
+        REQUIRE( result == ( Counter{ { 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 } } ) );
+    }
+
+    SECTION("Normal distribution")
+    {
+        int N = 100000;
+        scalar mean = 0, variance = 0;
+        for( int i = 0; i < N; ++i )
+        {
+            auto n = normal4( Counter{ { std::uint32_t(i), 0, 0, 0 } }, Key{ { 2006, 0 } } );
+            for( auto x : n )
+            {
+                mean     += x;
+                variance += x*x;
+            }
+        }
+        mean     /= 4*N;
+        variance /= 4*N;
+        REQUIRE( std::abs( mean ) < 0.01 );
+        REQUIRE( variance == Approx( 1 ).epsilon( 0.01 ) );
+    }
+}